@@ -1,6 +1,7 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 // Source: LyraCharacterMovementComponent_Slide.cpp
 #include "BwayCharacterMovementComponent.h"
+#include "BreakawayGameMode.h"
 #include "GameFramework/Character.h"
 #include "Components/CapsuleComponent.h"
 #include "AbilitySystemComponent.h"
@@ -11,6 +12,145 @@
 #include "InputActionValue.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Character/LyraCharacter.h" // For CharacterOwner->Jump()
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+CSV_DEFINE_CATEGORY(BwayMovement, true);
+
+// --- Correction Stats ---
+// Counted on the server whenever a client's move disagrees with the server's result and gets corrected.
+// Use Bway.Movement.CorrectionStats to print the corrections per minute since the last call.
+namespace BwayMovementStats
+{
+	static int32 NumCorrections = 0;
+	static int32 NumSlideCorrections = 0;
+	static double StartTime = 0.0;
+
+	static FAutoConsoleCommand CmdCorrectionStats(
+		TEXT("Bway.Movement.CorrectionStats"),
+		TEXT("Prints the number of movement corrections sent by the server per minute since the last call, and resets the counters"),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			const double Now = FPlatformTime::Seconds();
+			const double Minutes = (StartTime > 0.0) ? FMath::Max((Now - StartTime) / 60.0, UE_KINDA_SMALL_NUMBER) : 0.0;
+			if (Minutes > 0.0)
+			{
+				UE_LOG(LogBreakawayGame, Display, TEXT("Movement corrections over %.1f minutes: %d (%.1f/min), while sliding: %d (%.1f/min)"),
+					Minutes, NumCorrections, NumCorrections / Minutes, NumSlideCorrections, NumSlideCorrections / Minutes);
+			}
+			else
+			{
+				UE_LOG(LogBreakawayGame, Display, TEXT("Movement correction stats started, run the command again to print them"));
+			}
+
+			NumCorrections = 0;
+			NumSlideCorrections = 0;
+			StartTime = Now;
+		}));
+}
+
+// --- Saved Move ---
+// Carries the slide intent of a client move, so it can be sent to the server and restored when the move is replayed.
+class FSavedMove_BwayCharacter : public FSavedMove_Character
+{
+public:
+	typedef FSavedMove_Character Super;
+
+	FSavedMove_BwayCharacter()
+		: bSavedWantsToSlide(false)
+		, bSavedWantsToSlideJump(false)
+		, bSavedSlideRequested(false)
+	{
+	}
+
+	virtual void Clear() override
+	{
+		Super::Clear();
+
+		bSavedWantsToSlide = false;
+		bSavedWantsToSlideJump = false;
+		bSavedSlideRequested = false;
+	}
+
+	virtual uint8 GetCompressedFlags() const override
+	{
+		uint8 Result = Super::GetCompressedFlags();
+
+		if (bSavedWantsToSlide)
+		{
+			Result |= FLAG_Custom_0;
+		}
+		if (bSavedWantsToSlideJump)
+		{
+			Result |= FLAG_Custom_1;
+		}
+		if (bSavedSlideRequested)
+		{
+			Result |= FLAG_Custom_2;
+		}
+
+		return Result;
+	}
+
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override
+	{
+		// Only combine moves that the server would simulate with the same slide intent
+		const FSavedMove_BwayCharacter* NewBwayMove = static_cast<const FSavedMove_BwayCharacter*>(NewMove.Get());
+		if (bSavedWantsToSlide != NewBwayMove->bSavedWantsToSlide ||
+			bSavedWantsToSlideJump != NewBwayMove->bSavedWantsToSlideJump ||
+			bSavedSlideRequested != NewBwayMove->bSavedSlideRequested)
+		{
+			return false;
+		}
+
+		return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+	}
+
+	virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData) override
+	{
+		Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+		if (const UBwayCharacterMovementComponent* MoveComp = Cast<UBwayCharacterMovementComponent>(C->GetCharacterMovement()))
+		{
+			bSavedWantsToSlide = MoveComp->bWantsToSlide;
+			bSavedWantsToSlideJump = MoveComp->bWantsToSlideJump;
+			bSavedSlideRequested = MoveComp->bSlideRequested;
+		}
+	}
+
+	virtual void PrepMoveFor(ACharacter* C) override
+	{
+		Super::PrepMoveFor(C);
+
+		// Restore the intent this move was made with before it is replayed
+		if (UBwayCharacterMovementComponent* MoveComp = Cast<UBwayCharacterMovementComponent>(C->GetCharacterMovement()))
+		{
+			MoveComp->bWantsToSlide = bSavedWantsToSlide;
+			MoveComp->bWantsToSlideJump = bSavedWantsToSlideJump;
+			MoveComp->bSlideRequested = bSavedSlideRequested;
+		}
+	}
+
+	uint8 bSavedWantsToSlide : 1;
+	uint8 bSavedWantsToSlideJump : 1;
+	uint8 bSavedSlideRequested : 1;
+};
+
+class FNetworkPredictionData_Client_BwayCharacter : public FNetworkPredictionData_Client_Character
+{
+public:
+	typedef FNetworkPredictionData_Client_Character Super;
+
+	explicit FNetworkPredictionData_Client_BwayCharacter(const UCharacterMovementComponent& ClientMovement)
+		: Super(ClientMovement)
+	{
+	}
+
+	virtual FSavedMovePtr AllocateNewMove() override
+	{
+		return FSavedMovePtr(new FSavedMove_BwayCharacter());
+	}
+};
 
 // --- Constructor ---
 UBwayCharacterMovementComponent::UBwayCharacterMovementComponent(const FObjectInitializer& ObjectInitializer)
@@ -18,6 +158,10 @@ UBwayCharacterMovementComponent::UBwayCharacterMovementComponent(const FObjectIn
 {
 	// Sensible defaults can be set here, but primarily configured in BP Details panel
 	NavAgentProps.bCanCrouch = true; // Ensure crouching is enabled if slide uses crouch height
+
+	bWantsToSlide = false;
+	bWantsToSlideJump = false;
+	bSlideRequested = false;
 }
 
 // --- Initialization ---
@@ -26,11 +170,116 @@ void UBwayCharacterMovementComponent::InitializeComponent()
 	Super::InitializeComponent();
 
 	// Cache ASC for efficient tag checking
-	if (GetCharacterOwner())
+	BindSlideModifierTagEvent();
+	DefaultGravityScale = GravityScale; // Cache default gravity
+}
+
+void UBwayCharacterMovementComponent::UninitializeComponent()
+{
+	if (AbilitySystemComponent && CarryingLootTagEventHandle.IsValid())
+	{
+		AbilitySystemComponent->RegisterGameplayTagEvent(CarryingLootTag, EGameplayTagEventType::NewOrRemoved).Remove(CarryingLootTagEventHandle);
+	}
+	CarryingLootTagEventHandle.Reset();
+
+	Super::UninitializeComponent();
+}
+
+void UBwayCharacterMovementComponent::BindSlideModifierTagEvent()
+{
+	if (!AbilitySystemComponent && GetCharacterOwner())
 	{
 		AbilitySystemComponent = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(GetCharacterOwner());
 	}
-	DefaultGravityScale = GravityScale; // Cache default gravity
+
+	if (AbilitySystemComponent && CarryingLootTag.IsValid() && !CarryingLootTagEventHandle.IsValid())
+	{
+		CarryingLootTagEventHandle = AbilitySystemComponent->RegisterGameplayTagEvent(CarryingLootTag, EGameplayTagEventType::NewOrRemoved)
+			.AddUObject(this, &ThisClass::OnCarryingLootTagChanged);
+
+		// The tag may already have been added before we started listening
+		InvalidateSlideModifiers();
+	}
+}
+
+void UBwayCharacterMovementComponent::OnCarryingLootTagChanged(const FGameplayTag Tag, int32 NewCount)
+{
+	InvalidateSlideModifiers();
+}
+
+// --- Network Prediction ---
+FNetworkPredictionData_Client* UBwayCharacterMovementComponent::GetPredictionData_Client() const
+{
+	if (ClientPredictionData == nullptr)
+	{
+		UBwayCharacterMovementComponent* MutableThis = const_cast<UBwayCharacterMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_BwayCharacter(*this);
+	}
+
+	return ClientPredictionData;
+}
+
+void UBwayCharacterMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
+
+	bWantsToSlide = (Flags & FSavedMove_Character::FLAG_Custom_0) != 0;
+	bWantsToSlideJump = (Flags & FSavedMove_Character::FLAG_Custom_1) != 0;
+	bSlideRequested = (Flags & FSavedMove_Character::FLAG_Custom_2) != 0;
+}
+
+bool UBwayCharacterMovementComponent::ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientWorldLocation, const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+{
+	const bool bClientError = Super::ServerCheckClientError(ClientTimeStamp, DeltaTime, Accel, ClientWorldLocation, RelativeClientLocation, ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
+	if (bClientError)
+	{
+		++BwayMovementStats::NumCorrections;
+		CSV_CUSTOM_STAT(BwayMovement, Corrections, 1, ECsvCustomStatOp::Accumulate);
+
+		if (IsSliding())
+		{
+			++BwayMovementStats::NumSlideCorrections;
+			CSV_CUSTOM_STAT(BwayMovement, SlideCorrections, 1, ECsvCustomStatOp::Accumulate);
+		}
+	}
+
+	return bClientError;
+}
+
+// --- Input ---
+void UBwayCharacterMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	// Sample input before Super, so the move built this tick carries it
+	if (CharacterOwner && CharacterOwner->IsLocallyControlled())
+	{
+		UpdateSlideInput();
+	}
+
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+}
+
+void UBwayCharacterMovementComponent::UpdateSlideInput()
+{
+	APlayerController* PC = CharacterOwner ? Cast<APlayerController>(CharacterOwner->GetController()) : nullptr;
+	UEnhancedInputComponent* EIC = PC ? Cast<UEnhancedInputComponent>(PC->InputComponent) : nullptr;
+	if (!EIC)
+	{
+		return;
+	}
+
+	// Check bool values, assumes the IAs use Pressed/Released [11]
+	bWantsToSlide = SlideInputAction && EIC->GetBoundActionValue(SlideInputAction).Get<bool>();
+	bWantsToSlideJump = JumpInputAction && EIC->GetBoundActionValue(JumpInputAction).Get<bool>();
+}
+
+void UBwayCharacterMovementComponent::RequestSlide()
+{
+	// Remote characters get the request from the client's moves
+	if (CharacterOwner && CharacterOwner->IsLocallyControlled())
+	{
+		bSlideRequested = true;
+		bWantsToSlide = true;
+	}
 }
 
 // --- Movement Mode Change Handling ---
@@ -75,20 +324,15 @@ void UBwayCharacterMovementComponent::OnMovementModeChanged(EMovementMode Previo
 // --- Pre-Physics Update ---
 void UBwayCharacterMovementComponent::UpdateCharacterStateBeforeMovement(float DeltaSeconds)
 {
+	RefreshSlideModifiers();
+
 	// Check for slide end conditions BEFORE physics simulation for this frame
 	if (IsSliding())
 	{
 		if (CheckShouldEndSlide())
 		{
 			// Determine if jump input caused the end
-			bool bJumpPressed = false;
-			APlayerController* PC = CharacterOwner? Cast<APlayerController>(CharacterOwner->GetController()) : nullptr;
-			UEnhancedInputComponent* EIC = PC? Cast<UEnhancedInputComponent>(PC->InputComponent) : nullptr;
-			if (EIC && JumpInputAction && CharacterOwner && CharacterOwner->CanJump()) // Check CanJump here
-			{
-				// Check bool value, assumes Jump IA uses Pressed/Released [11]
-				bJumpPressed = EIC->GetBoundActionValue(JumpInputAction).Get<bool>();
-			}
+			const bool bJumpPressed = bWantsToSlideJump && CharacterOwner && CharacterOwner->CanJump(); // Check CanJump here
 
 			// Transition out of slide mode
 			// Determine new mode based on current state (e.g., Falling if airborne)
@@ -112,6 +356,18 @@ void UBwayCharacterMovementComponent::UpdateCharacterStateBeforeMovement(float D
 		}
 	}
 
+	// Enter slide on the move that carries the request, so the client and the server start it on the same move
+	if (bSlideRequested)
+	{
+		bSlideRequested = false;
+
+		if (!IsSliding() && IsMovingOnGround())
+		{
+			SetMovementMode(MOVE_Custom, (uint8)ECustomMovementMode::CMOVE_Slide);
+			return;
+		}
+	}
+
 	// Call Super for standard state updates (like crouch checks) if not exiting slide
 	Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
 }
@@ -124,16 +380,10 @@ bool UBwayCharacterMovementComponent::CheckShouldEndSlide()
         ACharacter* Owner = GetCharacterOwner();
         if (!Owner) return true;
 
-        APlayerController* PC = Cast<APlayerController>(Owner->GetController());
-        UEnhancedInputComponent* EIC = PC ? Cast<UEnhancedInputComponent>(PC->InputComponent) : nullptr;
-
-        // Only end the slide if we can verify the input has been released
-        if (EIC && SlideInputAction)
+        // Uses the intent from the move rather than the input component, so the server reaches the same result as the client
+        if (!bWantsToSlide || bWantsToSlideJump)
         {
-                if (!EIC->GetBoundActionValue(SlideInputAction).Get<bool>())
-                {
-                        return true;
-                }
+                return true;
         }
 
         return false; // Remain sliding in all other cases
@@ -144,9 +394,7 @@ float UBwayCharacterMovementComponent::GetMaxSpeed() const
 {
 	if (IsSliding())
 	{
-		float CurrentMaxSpeedFactor, SlopeAccelFactor, FrictionMultiplier;
-		GetCurrentSlideModifiers(CurrentMaxSpeedFactor, SlopeAccelFactor, FrictionMultiplier);
-		return BaseSlideSpeed * CurrentMaxSpeedFactor;
+		return BaseSlideSpeed * CachedSlideModifiers.MaxSpeedFactor;
 	}
 	return Super::GetMaxSpeed();
 }
@@ -185,7 +433,11 @@ void UBwayCharacterMovementComponent::PhysSliding(float deltaTime, int32 Iterati
 	if (!HasValidData() || deltaTime < MIN_TICK_TIME || Iterations >= MaxSimulationIterations) return;
 
         // --- Ground Check ---
-        FindFloor(UpdatedComponent->GetComponentLocation(), CurrentFloor, false);
+        // Reuse the floor found at the end of the previous update unless something moved us since
+        if (!CanReuseSlideFloor())
+        {
+                FindFloor(UpdatedComponent->GetComponentLocation(), CurrentFloor, false);
+        }
         const bool bHasFloor = CurrentFloor.IsWalkableFloor();
 
         // --- Calculate Physics Inputs ---
@@ -230,12 +482,10 @@ void UBwayCharacterMovementComponent::PhysSliding(float deltaTime, int32 Iterati
 	if (Hit.Time < 1.f) // Hit something
 	{
 		// Apply wall friction if hitting a wall significantly opposing movement
-		float CurrentMaxSpeedFactor, SlopeAccelFactor, CurrentFrictionMultiplier;
-		GetCurrentSlideModifiers(CurrentMaxSpeedFactor, SlopeAccelFactor, CurrentFrictionMultiplier);
 		if (FVector::DotProduct(Velocity.GetSafeNormal(), Hit.Normal) < -0.5f) // Check angle of impact
 		{
 			// Apply high wall friction using VInterpTo for immediate effect
-			Velocity = FMath::VInterpTo(Velocity, FVector::ZeroVector, deltaTime * (1.f - Hit.Time), SlideWallHitFriction * CurrentFrictionMultiplier);
+			Velocity = FMath::VInterpTo(Velocity, FVector::ZeroVector, deltaTime * (1.f - Hit.Time), SlideWallHitFriction * CachedSlideModifiers.FrictionMultiplier);
 		}
 
 		// Standard impact handling and surface sliding
@@ -243,8 +493,9 @@ void UBwayCharacterMovementComponent::PhysSliding(float deltaTime, int32 Iterati
 		SlideAlongSurface(Adjusted, (1.f - Hit.Time), Hit.Normal, Hit, true);
 	}
 
-        // Re-check ground state after movement
+        // Re-check ground state after movement, the result is reused by the next update
         FindFloor(UpdatedComponent->GetComponentLocation(), CurrentFloor, false);
+        CacheSlideFloor();
         if (Velocity.SizeSquared() < KINDA_SMALL_NUMBER && Acceleration.IsNearlyZero())
         {
                 // Came to a stop naturally
@@ -262,9 +513,6 @@ void UBwayCharacterMovementComponent::PhysSliding(float deltaTime, int32 Iterati
 // --- Slope Acceleration Logic ---
 void UBwayCharacterMovementComponent::ApplySlideSlopeAcceleration(float DeltaTime, float SlopeAngleDegrees)
 {
-	float CurrentMaxSpeedFactor, CurrentSlopeAccelFactor, FrictionMultiplier;
-	GetCurrentSlideModifiers(CurrentMaxSpeedFactor, CurrentSlopeAccelFactor, FrictionMultiplier);
-
 	if (SlopeAngleDegrees >= MinSlopeAngleForAccel)
 	{
 		// Calculate direction down the slope (perpendicular to floor normal and horizontal plane)
@@ -275,7 +523,7 @@ void UBwayCharacterMovementComponent::ApplySlideSlopeAcceleration(float DeltaTim
 		if (!DownSlopeDirection.IsNearlyZero())
 		{
 			// Calculate acceleration magnitude based on parameters
-			const float SlopeAccelMagnitude = BaseSlideSpeed * CurrentSlopeAccelFactor;
+			const float SlopeAccelMagnitude = BaseSlideSpeed * CachedSlideModifiers.SlopeAccelFactor;
 			// Add to the Acceleration vector for standard integration in PhysSliding
 			// This approach integrates better with CMC's prediction than directly adding to Velocity
 			Acceleration += DownSlopeDirection * SlopeAccelMagnitude;
@@ -301,7 +549,7 @@ void UBwayCharacterMovementComponent::ApplySlideSteering(float DeltaTime, const
 	// Check if input direction is significantly different from velocity direction
 	// Lua used cos(5 deg), meaning steer if angle > 5 degrees.
 	const float Dot = FVector::DotProduct(CurrentVelDir2D, InputDir2D);
-	const float SteerThresholdCosine = FMath::Cos(FMath::DegreesToRadians(5.0f));
+	static const float SteerThresholdCosine = FMath::Cos(FMath::DegreesToRadians(5.0f));
 
 	if (Dot < SteerThresholdCosine)
 	{
@@ -325,18 +573,19 @@ void UBwayCharacterMovementComponent::ApplySlideSteering(float DeltaTime, const
 // --- Friction Logic ---
 void UBwayCharacterMovementComponent::ApplySlideFriction(float DeltaTime, float SlopeAngleDegrees)
 {
-	float CurrentMaxSpeedFactor, SlopeAccelFactor, CurrentFrictionMultiplier;
-	GetCurrentSlideModifiers(CurrentMaxSpeedFactor, SlopeAccelFactor, CurrentFrictionMultiplier);
-
 	// Use the base friction factor defined in properties, scaled by the Lua power curve
 	float FrictionToApply = 0.f;
-	const float ClampedSlopeFactor = FMath::Clamp(SlopeAngleDegrees / 90.0f, 0.0f, 1.0f);
-	// Lua: math.pow(1.0 - clamp(slopeAngle / 90.0, 0.0, 1.0), 15.0)
-	// This factor approaches 1 on flat ground and 0 on 90-degree slopes.
-	const float SlopePowerFactor = FMath::Pow(1.0f - ClampedSlopeFactor, SlideFrictionPower);
+	if (SlopeAngleDegrees != LastFrictionSlopeAngle) // Only re-evaluate the curve when the floor changed
+	{
+		const float ClampedSlopeFactor = FMath::Clamp(SlopeAngleDegrees / 90.0f, 0.0f, 1.0f);
+		// Lua: math.pow(1.0 - clamp(slopeAngle / 90.0, 0.0, 1.0), 15.0)
+		// This factor approaches 1 on flat ground and 0 on 90-degree slopes.
+		LastFrictionSlopePowerFactor = FMath::Pow(1.0f - ClampedSlopeFactor, SlideFrictionPower);
+		LastFrictionSlopeAngle = SlopeAngleDegrees;
+	}
 
 	// Combine base friction, slope factor, and loot modifier
-	FrictionToApply = SlideBaseFrictionFactor * SlopePowerFactor * CurrentFrictionMultiplier;
+	FrictionToApply = SlideBaseFrictionFactor * LastFrictionSlopePowerFactor * CachedSlideModifiers.FrictionMultiplier;
 
 	// Apply friction using VInterpTo (approximates exponential decay like Lua's VariableInterpolate)
 	if (FrictionToApply > KINDA_SMALL_NUMBER && Velocity.SizeSquared() > KINDA_SMALL_NUMBER)
@@ -351,14 +600,9 @@ void UBwayCharacterMovementComponent::PhysFalling(float deltaTime, int32 Iterati
 {
 	// Check if slide input is still held AND if the fall started during a slide attempt
 	bool bApplySlideGravity = false;
-	if (bDidSlideFall) // Check flag set when transitioning from Slide->Fall
+	if (bDidSlideFall && bWantsToSlide) // Check flag set when transitioning from Slide->Fall, and that slide input is held
 	{
-		APlayerController* PC = CharacterOwner? Cast<APlayerController>(CharacterOwner->GetController()) : nullptr;
-		UEnhancedInputComponent* EIC = PC? Cast<UEnhancedInputComponent>(PC->InputComponent) : nullptr;
-		if (EIC && SlideInputAction && EIC->GetBoundActionValue(SlideInputAction).Get<bool>())
-		{
-			bApplySlideGravity = true;
-		}
+		bApplySlideGravity = true;
 	}
 
 	// Apply custom gravity scale if conditions met
@@ -418,9 +662,68 @@ void UBwayCharacterMovementComponent::GetCurrentSlideModifiers(float& OutMaxSpee
 	}
 }
 
+void UBwayCharacterMovementComponent::RefreshSlideModifiers()
+{
+	if (!AbilitySystemComponent)
+	{
+		// The ASC may not have existed yet when the component was initialized
+		BindSlideModifierTagEvent();
+	}
+
+	// The tag event covers the loot tag, the properties are Blueprint writable so they are compared instead
+	if (bSlideModifiersDirty ||
+		(CachedSlideModifiers.SlideMaxSpeedFactor != SlideMaxSpeedFactor) ||
+		(CachedSlideModifiers.SlideSlopeAccelerationFactor != SlideSlopeAccelerationFactor) ||
+		(CachedSlideModifiers.LootMaxSpeedFactorMultiplier != LootMaxSpeedFactorMultiplier) ||
+		(CachedSlideModifiers.LootSlopeAccelFactorMultiplier != LootSlopeAccelFactorMultiplier) ||
+		(CachedSlideModifiers.LootFrictionMultiplier != LootFrictionMultiplier))
+	{
+		GetCurrentSlideModifiers(CachedSlideModifiers.MaxSpeedFactor, CachedSlideModifiers.SlopeAccelFactor, CachedSlideModifiers.FrictionMultiplier);
+		CachedSlideModifiers.SlideMaxSpeedFactor = SlideMaxSpeedFactor;
+		CachedSlideModifiers.SlideSlopeAccelerationFactor = SlideSlopeAccelerationFactor;
+		CachedSlideModifiers.LootMaxSpeedFactorMultiplier = LootMaxSpeedFactorMultiplier;
+		CachedSlideModifiers.LootSlopeAccelFactorMultiplier = LootSlopeAccelFactorMultiplier;
+		CachedSlideModifiers.LootFrictionMultiplier = LootFrictionMultiplier;
+		bSlideModifiersDirty = false;
+	}
+}
+
+bool UBwayCharacterMovementComponent::CanReuseSlideFloor() const
+{
+	if (!bHasSlideFloor || bJustTeleported || !UpdatedComponent->GetComponentLocation().Equals(SlideFloorLocation))
+	{
+		return false;
+	}
+
+	// Something else may have updated CurrentFloor since (e.g., a different floor was found by other movement code)
+	UPrimitiveComponent* FloorComponent = CurrentFloor.HitResult.GetComponent();
+	if ((FloorComponent != SlideFloorComponent.Get()) || !CurrentFloor.HitResult.ImpactNormal.Equals(SlideFloorNormal))
+	{
+		return false;
+	}
+
+	// A moving or rotating floor (e.g., a platform) changes under a character that hasn't moved itself
+	return !FloorComponent || FloorComponent->GetComponentTransform().Equals(SlideFloorComponentTransform);
+}
+
+void UBwayCharacterMovementComponent::CacheSlideFloor()
+{
+	UPrimitiveComponent* FloorComponent = CurrentFloor.HitResult.GetComponent();
+
+	SlideFloorLocation = UpdatedComponent->GetComponentLocation();
+	SlideFloorNormal = CurrentFloor.HitResult.ImpactNormal;
+	SlideFloorComponent = FloorComponent;
+	SlideFloorComponentTransform = FloorComponent ? FloorComponent->GetComponentTransform() : FTransform::Identity;
+	bHasSlideFloor = true;
+}
+
 // --- Slide Start/End Helpers ---
 void UBwayCharacterMovementComponent::StartSlide()
 {
+	// The floor from before the slide was found with the default walkable angle
+	bHasSlideFloor = false;
+	RefreshSlideModifiers();
+
 	// Example: Shrink capsule height for slide pose
 	if (CharacterOwner)
 	{
@@ -120,8 +120,9 @@ void UBwayGameplayAbility_Slide::ActivateAbility(const FGameplayAbilitySpecHandl
 	}
 
 	// --- Trigger Custom Movement Mode ---
-	// This is the primary action of this ability.
-	CachedBwayMoveComp->SetMovementMode(MOVE_Custom, (uint8)ECustomMovementMode::CMOVE_Slide);
+	// This is the primary action of this ability. The CMC enters CMOVE_Slide on its next move, which carries the
+	// request to the server in its compressed flags, rather than switching mode outside of the move.
+	CachedBwayMoveComp->RequestSlide();
 
 	// --- Apply State Tag ---
 	// The SlidingStateTag (e.g., State.Movement.Sliding) is automatically applied
@@ -49,6 +49,10 @@ void ABwayPlayerState::ServerSetIsRequestingRelic_Implementation(bool bNewReques
 	if (bIsRequestingRelic!= bNewRequestingState)
 	{
 		bIsRequestingRelic = bNewRequestingState;
+		if (bIsRequestingRelic)
+		{
+			RelicRequestTime = GetWorld()->GetTimeSeconds();
+		}
 		// Manually call RepNotify on server if needed, and broadcast delegate
 		OnRep_IsRequestingRelic();
 	}
@@ -1,16 +1,34 @@
 #include "Relic/RelicActor.h"
 #include "BwayCharacterWithAbilities.h"
 #include "Relic/RelicSettings.h"
+#include "Relic/RelicTrajectoryLibrary.h"
+#include "GameFramework/PlayerState.h"
+#include "BwayPlayerState.h"
+#include "Character/LyraHealthComponent.h"
+#include "TimerManager.h"
 #include "Components/SphereComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "AbilitySystemComponent.h"
 #include "Net/UnrealNetwork.h"
+#include "Engine/NetSerialization.h"
+#include "Engine/World.h"
 #include "Kismet/GameplayStatics.h" // For FinishSpawningActor if needed later
 
+bool FRelicMovementSnapshot::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    // Location and velocity to a tenth of a unit, rotation to 16 bits per axis
+    bOutSuccess = SerializePackedVector<10, 24>(Location, Ar);
+    bOutSuccess &= SerializePackedVector<10, 20>(LinearVelocity, Ar);
+    Rotation.SerializeCompressedShort(Ar);
+    Ar << SnapshotId;
+    return true;
+}
+
 ARelicActor::ARelicActor()
 {
     // Enable ticking and replication
     PrimaryActorTick.bCanEverTick = true;
+    PrimaryActorTick.bStartWithTickEnabled = false; // Only ticks while moving, see UpdateMovementReplication
     bReplicates = true;
 
 
@@ -19,6 +37,8 @@ ARelicActor::ARelicActor()
     RelicMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("RelicMesh"));
     SetRootComponent(RelicMesh);
     RelicMesh->SetIsReplicated(true); // Replicate the component itself if needed
+    RelicMesh->BodyInstance.bGenerateWakeEvents = true; // A relic at rest doesn't tick, waking up or getting hit starts it again
+    RelicMesh->SetNotifyRigidBodyCollision(true);
 
     InteractionSphere = CreateDefaultSubobject<USphereComponent>(TEXT("InteractionSphere"));
     InteractionSphere->SetupAttachment(RootComponent);
@@ -29,9 +49,10 @@ ARelicActor::ARelicActor()
     AbilitySystemComponent->SetIsReplicated(true);
     AbilitySystemComponent->SetReplicationMode(EGameplayEffectReplicationMode::Mixed);
 
-    //SetReplicatingMovement(true); // Important for physics objects
-    SetNetUpdateFrequency(66.0f);
-    SetMinNetUpdateFrequency(33.0f);
+    // Movement is replicated through MovementSnapshot instead of ReplicatedMovement, and only while the relic moves on its own
+    SetReplicatingMovement(false);
+    SetNetUpdateFrequency(30.0f);
+    SetMinNetUpdateFrequency(2.0f);
 }
 
 void ARelicActor::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -41,6 +62,7 @@ void ARelicActor::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifet
     // Replicate state machine and its components
     DOREPLIFETIME(ARelicActor, CurrentCarrier);
     DOREPLIFETIME(ARelicActor, CurrentState);
+    DOREPLIFETIME(ARelicActor, MovementSnapshot);
 }
 
 void ARelicActor::BeginPlay()
@@ -79,9 +101,34 @@ void ARelicActor::BeginPlay()
     {
         // Example: Maybe start simulating if state is Neutral/Dropped
         RelicMesh->SetSimulatePhysics(CurrentState == ERelicState::Neutral || CurrentState == ERelicState::Dropped);
+        UpdateMovementReplication();
     }
     // Bind overlap event (can also be done in Blueprint)
     InteractionSphere->OnComponentBeginOverlap.AddDynamic(this, &ARelicActor::OnInteractionSphereOverlap);
+
+    if (HasAuthority())
+    {
+        RelicMesh->OnComponentWake.AddDynamic(this, &ARelicActor::OnRelicMeshWake);
+        RelicMesh->OnComponentHit.AddDynamic(this, &ARelicActor::OnRelicMeshHit);
+    }
+}
+
+void ARelicActor::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
+
+    if (HasAuthority())
+    {
+        UpdateMovementReplication();
+    }
+    else if (bPredictingLaunch)
+    {
+        TickPredictedLaunch(DeltaSeconds);
+    }
+    else
+    {
+        SmoothReplicatedMovement(DeltaSeconds);
+    }
 }
 
 void ARelicActor::OnInteractionSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
@@ -92,31 +139,40 @@ void ARelicActor::OnInteractionSphereOverlap(UPrimitiveComponent* OverlappedComp
         return;
     }
 
-    ABwayCharacterWithAbilities* OverlappingCharacter = Cast<ABwayCharacterWithAbilities>(OtherActor);
-    if (OverlappingCharacter && CanBePickedUpBy(OverlappingCharacter))
+    // The arbiter decides who (if anyone) gets the relic, including characters that start requesting it after entering the sphere
+    if (IsPickupableState(CurrentState) && Cast<ABwayCharacterWithAbilities>(OtherActor))
     {
-        // Option 2: Try to activate a pickup ability on the character (Recommended GAS approach)
-        UAbilitySystemComponent* CharASC = OverlappingCharacter->GetAbilitySystemComponent();
-        if (CharASC && RelicSettings && RelicSettings->PickupEventTag.IsValid()) // Assume PickupEventTag is defined in URelicSettings
-        {
-            FGameplayEventData Payload;
-            Payload.EventTag = RelicSettings->PickupEventTag; // e.g., "Event.Interaction.PickupRelic"
-            Payload.Instigator = OverlappingCharacter; // Who triggered the pickup
-            Payload.Target = this; // The Relic itself is the target of the event
-
-            // Send the event to the character's ASC.
-            // The GA_PickupRelic_BP should have an "Event Received" trigger matching this tag.
-            CharASC->HandleGameplayEvent(Payload.EventTag, &Payload);
-            UE_LOG(LogTemp, Log, TEXT("Server: Sent PickupRelic event to %s"), *GetNameSafe(OverlappingCharacter));
-        }
+        StartPickupArbiter();
     }
 }
 
 bool ARelicActor::CanBePickedUpBy(ABwayCharacterWithAbilities* Character) const
 {
     // Server-side check: Is the relic in a pickup-able state AND is the character requesting it?
-    return (CurrentState == ERelicState::Neutral || CurrentState == ERelicState::Dropped) &&
-           Character && Character->GetBwayPlayerState() && Character->GetBwayPlayerState()->IsRequestingRelic();
+    if (!(CurrentState == ERelicState::Neutral || CurrentState == ERelicState::Dropped) ||
+        !Character || !Character->GetBwayPlayerState() || !Character->GetBwayPlayerState()->IsRequestingRelic())
+    {
+        return false;
+    }
+
+    // Dead (or dying) characters drop the relic, and can't pick it up again
+    const ULyraHealthComponent* HealthComponent = ULyraHealthComponent::FindHealthComponent(Character);
+    if (HealthComponent && HealthComponent->IsDeadOrDying())
+    {
+        return false;
+    }
+
+    // Whoever just let go of the relic is still standing on it, give everyone else a chance first
+    if (PreviousCarrier.Get() == Character)
+    {
+        const float PickupDelay = RelicSettings ? RelicSettings->PreviousCarrierPickupDelay : 1.0f;
+        if ((GetWorld()->GetTimeSeconds() - PreviousCarrierReleaseTime) < PickupDelay)
+        {
+            return false;
+        }
+    }
+
+    return true;
 }
 
 UAbilitySystemComponent* ARelicActor::GetAbilitySystemComponent() const
@@ -142,24 +198,70 @@ void ARelicActor::OnRep_CurrentState()
         RelicMesh->SetSimulatePhysics(false); // Ensure physics is off on clients when carried
         break;
     }
+
+    if (!HasAuthority())
+    {
+        // A predicted launch lasts while the server still has the relic carried or has launched it; anything else ends it
+        if (bPredictingLaunch && (CurrentState != ERelicState::Carried) && (CurrentState != ERelicState::Thrown) && (CurrentState != ERelicState::BeingPassed))
+        {
+            StopPredictedLaunch();
+        }
+
+        UpdateClientTick();
+    }
+
     UE_LOG(LogTemp, Log, TEXT("Relic %s changed state to %d on client"), *GetNameSafe(this), CurrentState);
 }
 
+void ARelicActor::OnRep_MovementSnapshot()
+{
+    const bool bFirstSnapshot = (LastSnapshotReceiveTime == 0.0);
+    LastSnapshotReceiveTime = GetWorld()->GetTimeSeconds();
+
+    if (bPredictingLaunch && ((CurrentState == ERelicState::Thrown) || (CurrentState == ERelicState::BeingPassed)))
+    {
+        ReconcilePredictedLaunch();
+        return;
+    }
+
+    // When the relic has come to rest (or we just joined) there is nothing to smooth towards, so snap
+    if ((MovementSnapshot.LinearVelocity.IsNearlyZero() || bFirstSnapshot) && (CurrentCarrier == nullptr))
+    {
+        SetActorLocationAndRotation(MovementSnapshot.Location, MovementSnapshot.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+    }
+
+    UpdateClientTick();
+}
+
 void ARelicActor::OnRep_CurrentCarrier()
 {
     // Client-side reaction to carrier changes
+    if (CurrentCarrier && bPredictingLaunch && (CurrentCarrier != PredictingCarrier.Get()))
+    {
+        // Someone else caught the relic
+        StopPredictedLaunch();
+    }
+
     if (CurrentCarrier)
     {
-        // If the carrier is now valid, attach visually on the client
+        // If the carrier is now valid, attach visually on the client (unless we are still predicting our own throw)
         // Note: Actual attachment logic might be complex depending on prediction needs,
         // but a simple visual attach here based on replicated state is common.
-        AttachToCarrier(CurrentCarrier);
+        if (!bPredictingLaunch)
+        {
+            AttachToCarrier(CurrentCarrier);
+        }
     }
     else
     {
-        // If carrier is null, detach visually
+        // If carrier is null, detach visually. This keeps the world transform, so a predicted launch keeps following its path
         DetachFromCarrier();
     }
+
+    if (!HasAuthority())
+    {
+        UpdateClientTick();
+    }
 }
 
 
@@ -169,9 +271,18 @@ void ARelicActor::SetRelicState(ERelicState NewState)
     {
         if (CurrentState!= NewState)
         {
+            // The relic may be dormant, make sure this change (and any carrier change made with it) goes out
+            FlushNetDormancy();
+
             ERelicState OldState = CurrentState;
             CurrentState = NewState;
 
+            // The carrier owns the relic to send the launch RPCs, nobody does once it is no longer carried or in flight
+            if ((NewState != ERelicState::Carried) && (NewState != ERelicState::Thrown) && (NewState != ERelicState::BeingPassed))
+            {
+                SetOwner(nullptr);
+            }
+
             // Call RepNotify manually on the server to ensure server logic runs too
             OnRep_CurrentState();
 
@@ -198,6 +309,17 @@ void ARelicActor::SetRelicState(ERelicState NewState)
             default:
                 break;
             }
+
+            if (IsPickupableState(NewState))
+            {
+                StartPickupArbiter();
+            }
+            else
+            {
+                StopPickupArbiter();
+            }
+
+            UpdateMovementReplication();
             UE_LOG(LogTemp, Log, TEXT("Relic %s changed state from %d to %d on server"), *GetNameSafe(this), OldState, NewState);
         }
     }
@@ -214,6 +336,7 @@ void ARelicActor::OnPickedUp(ABwayCharacterWithAbilities* NewCarrier)
     if (HasAuthority() && NewCarrier)
     {
         LastPossessingTeam = NewCarrier->GetGenericTeamId(); // Store the team ID of the new carrier
+        SetOwner(NewCarrier); // The carrier's connection has to own the relic to send the throw/pass RPCs and receive Client_RejectPredictedLaunch
         CurrentCarrier = NewCarrier; // Set replicated property
         OnRep_CurrentCarrier(); // Call RepNotify manually on server
 
@@ -228,8 +351,7 @@ void ARelicActor::OnDropped()
     if (HasAuthority())
     {
         DetachFromCarrier(); // Detaches and sets physics state
-        CurrentCarrier = nullptr; // Clear replicated property
-        OnRep_CurrentCarrier(); // Call RepNotify manually on server
+        ReleaseCarrier();
 
         // Transition to Dropped state (or Neutral depending on rules)
         SetRelicState(ERelicState::Dropped);
@@ -240,31 +362,81 @@ void ARelicActor::OnDropped()
 
 // --- Throw/Pass RPCs ---
 
-bool ARelicActor::Server_ThrowRelic_Validate(const FVector& ThrowVelocity) { return true; } // Basic validation
+bool ARelicActor::Server_ThrowRelic_Validate(const FVector& ThrowVelocity) { return !ThrowVelocity.ContainsNaN(); }
 void ARelicActor::Server_ThrowRelic_Implementation(const FVector& ThrowVelocity)
+{
+    LaunchRelic(ThrowVelocity, ERelicState::Thrown);
+}
+
+bool ARelicActor::Server_PassRelic_Validate(const FVector& PassVelocity) { return !PassVelocity.ContainsNaN(); }
+void ARelicActor::Server_PassRelic_Implementation(const FVector& PassVelocity)
+{
+    LaunchRelic(PassVelocity, ERelicState::BeingPassed);
+}
+
+void ARelicActor::LaunchRelic(const FVector& LaunchVelocity, ERelicState LaunchState)
 {
     if (HasAuthority() && CurrentState == ERelicState::Carried && CurrentCarrier!= nullptr)
     {
-        DetachFromCarrier(&ThrowVelocity); // Detaches and applies impulse
-        CurrentCarrier = nullptr;
-        OnRep_CurrentCarrier(); // Call RepNotify manually on server
+        // Never trust the client with the speed, the owning client reconciles with the snapshots if this differs from its prediction
+        const FVector ClampedVelocity = URelicTrajectoryLibrary::ClampLaunchVelocity(RelicSettings, LaunchVelocity);
 
-        SetRelicState(ERelicState::Thrown);
+        DetachFromCarrier(&ClampedVelocity); // Detaches and applies impulse
+        ReleaseCarrier();
+
+        SetRelicState(LaunchState);
         Multicast_PlayThrowPassFX(); // Trigger cosmetic effects on all clients
     }
+    else
+    {
+        // Still owned by whoever carries it (if anyone), in which case that client isn't predicting and ignores this
+        Client_RejectPredictedLaunch();
+    }
 }
 
-bool ARelicActor::Server_PassRelic_Validate(const FVector& PassVelocity) { return true; } // Basic validation
-void ARelicActor::Server_PassRelic_Implementation(const FVector& PassVelocity)
+void ARelicActor::ThrowRelic(const FVector& ThrowVelocity)
 {
-    if (HasAuthority() && CurrentState == ERelicState::Carried && CurrentCarrier!= nullptr)
+    RequestLaunch(ThrowVelocity, ERelicState::Thrown);
+}
+
+void ARelicActor::PassRelic(const FVector& PassVelocity)
+{
+    RequestLaunch(PassVelocity, ERelicState::BeingPassed);
+}
+
+void ARelicActor::RequestLaunch(const FVector& LaunchVelocity, ERelicState LaunchState)
+{
+    // Only the machine controlling the carrier launches, see ThrowRelic
+    if ((CurrentState != ERelicState::Carried) || !CurrentCarrier || !CurrentCarrier->IsLocallyControlled())
     {
-        DetachFromCarrier(&PassVelocity); // Detaches and applies impulse
-        CurrentCarrier = nullptr;
-        OnRep_CurrentCarrier(); // Call RepNotify manually on server
+        return;
+    }
 
-        SetRelicState(ERelicState::BeingPassed);
-        Multicast_PlayThrowPassFX(); // Trigger cosmetic effects on all clients
+    if (HasAuthority())
+    {
+        LaunchRelic(LaunchVelocity, LaunchState);
+    }
+    else
+    {
+        StartPredictedLaunch(LaunchVelocity);
+
+        if (LaunchState == ERelicState::Thrown)
+        {
+            Server_ThrowRelic(LaunchVelocity);
+        }
+        else
+        {
+            Server_PassRelic(LaunchVelocity);
+        }
+    }
+}
+
+void ARelicActor::Client_RejectPredictedLaunch_Implementation()
+{
+    if (bPredictingLaunch)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Relic %s: server rejected predicted launch"), *GetNameSafe(this));
+        StopPredictedLaunch();
     }
 }
 
@@ -320,4 +492,389 @@ void ARelicActor::DetachFromCarrier(const FVector* InitialVelocity)
         // Clients DO NOT simulate physics for thrown/passed objects [4]
         RelicMesh->SetSimulatePhysics(false);
     }
-}
\ No newline at end of file
+}
+
+void ARelicActor::ReleaseCarrier()
+{
+    PreviousCarrier = CurrentCarrier;
+    PreviousCarrierReleaseTime = GetWorld()->GetTimeSeconds();
+
+    CurrentCarrier = nullptr; // Clear replicated property
+    OnRep_CurrentCarrier(); // Call RepNotify manually on server
+}
+
+// --- Pickup Arbiter ---
+
+bool ARelicActor::IsPickupableState(ERelicState State)
+{
+    return (State == ERelicState::Neutral) || (State == ERelicState::Dropped);
+}
+
+void ARelicActor::StartPickupArbiter()
+{
+    check(HasAuthority());
+
+    FTimerManager& TimerManager = GetWorldTimerManager();
+    if (!TimerManager.IsTimerActive(PickupArbiterTimerHandle))
+    {
+        const float Interval = RelicSettings ? RelicSettings->PickupArbiterInterval : 0.1f;
+        TimerManager.SetTimer(PickupArbiterTimerHandle, this, &ThisClass::RunPickupArbiter, Interval, /*bLoop=*/ true);
+
+        // Don't make the first character to arrive wait for the first interval. This is deferred to the next tick as the pickup
+        // event can activate the pickup ability right away, which would change the state while we are in the middle of SetRelicState
+        PickupArbiterNextTickHandle = TimerManager.SetTimerForNextTick(this, &ThisClass::RunPickupArbiter);
+    }
+}
+
+void ARelicActor::StopPickupArbiter()
+{
+    GetWorldTimerManager().ClearTimer(PickupArbiterTimerHandle);
+    GetWorldTimerManager().ClearTimer(PickupArbiterNextTickHandle);
+    LastPickupEventCharacter.Reset();
+}
+
+void ARelicActor::RunPickupArbiter()
+{
+    if (!IsPickupableState(CurrentState))
+    {
+        StopPickupArbiter();
+        return;
+    }
+
+    TArray<AActor*> OverlappingActors;
+    InteractionSphere->GetOverlappingActors(OverlappingActors, ABwayCharacterWithAbilities::StaticClass());
+    if (OverlappingActors.Num() == 0)
+    {
+        // Nobody nearby, the next begin overlap starts the arbiter again
+        StopPickupArbiter();
+        return;
+    }
+
+    // Pick a single winner among everyone requesting the relic
+    const FVector RelicLocation = GetActorLocation();
+    ABwayCharacterWithAbilities* BestCharacter = nullptr;
+    double BestDistSq = 0.0;
+    for (AActor* Actor : OverlappingActors)
+    {
+        ABwayCharacterWithAbilities* Character = CastChecked<ABwayCharacterWithAbilities>(Actor);
+        if (!CanBePickedUpBy(Character))
+        {
+            continue;
+        }
+
+        const double DistSq = FVector::DistSquared(RelicLocation, Character->GetActorLocation());
+        if (!BestCharacter || IsBetterPickupCandidate(Character, DistSq, BestCharacter, BestDistSq))
+        {
+            BestCharacter = Character;
+            BestDistSq = DistSq;
+        }
+    }
+
+    if (!BestCharacter)
+    {
+        return;
+    }
+
+    // Give the winner's pickup ability a moment to act before sending the event again
+    const double Now = GetWorld()->GetTimeSeconds();
+    const float RetryDelay = RelicSettings ? RelicSettings->PickupEventRetryDelay : 0.5f;
+    if ((LastPickupEventCharacter.Get() == BestCharacter) && ((Now - LastPickupEventTime) < RetryDelay))
+    {
+        return;
+    }
+
+    LastPickupEventCharacter = BestCharacter;
+    LastPickupEventTime = Now;
+    SendPickupEvent(BestCharacter);
+}
+
+bool ARelicActor::IsBetterPickupCandidate(const ABwayCharacterWithAbilities* Challenger, double ChallengerDistSq, const ABwayCharacterWithAbilities* Best, double BestDistSq) const
+{
+    // Distances closer than this are considered a tie
+    constexpr double DistanceToleranceSq = 1.0;
+
+    const double ChallengerRequestTime = Challenger->GetBwayPlayerState()->GetRelicRequestTime();
+    const double BestRequestTime = Best->GetBwayPlayerState()->GetRelicRequestTime();
+
+    const bool bCloser = (ChallengerDistSq + DistanceToleranceSq) < BestDistSq;
+    const bool bFarther = (BestDistSq + DistanceToleranceSq) < ChallengerDistSq;
+
+    if (RelicSettings && (RelicSettings->PickupPriority == ERelicPickupPriority::EarliestRequest))
+    {
+        if (ChallengerRequestTime != BestRequestTime)
+        {
+            return ChallengerRequestTime < BestRequestTime;
+        }
+        if (bCloser || bFarther)
+        {
+            return bCloser;
+        }
+    }
+    else
+    {
+        if (bCloser || bFarther)
+        {
+            return bCloser;
+        }
+        if (ChallengerRequestTime != BestRequestTime)
+        {
+            return ChallengerRequestTime < BestRequestTime;
+        }
+    }
+
+    // Complete tie, fall back to something stable
+    return Challenger->GetBwayPlayerState()->GetPlayerId() < Best->GetBwayPlayerState()->GetPlayerId();
+}
+
+void ARelicActor::SendPickupEvent(ABwayCharacterWithAbilities* Character)
+{
+    // Try to activate a pickup ability on the character (Recommended GAS approach)
+    UAbilitySystemComponent* CharASC = Character->GetAbilitySystemComponent();
+    if (CharASC && RelicSettings && RelicSettings->PickupEventTag.IsValid())
+    {
+        FGameplayEventData Payload;
+        Payload.EventTag = RelicSettings->PickupEventTag; // e.g., "Event.Interaction.PickupRelic"
+        Payload.Instigator = Character; // Who triggered the pickup
+        Payload.Target = this; // The Relic itself is the target of the event
+
+        // The GA_PickupRelic_BP should have an "Event Received" trigger matching this tag.
+        CharASC->HandleGameplayEvent(Payload.EventTag, &Payload);
+        UE_LOG(LogTemp, Log, TEXT("Server: Sent PickupRelic event to %s"), *GetNameSafe(Character));
+    }
+}
+
+// --- Movement Replication ---
+
+bool ARelicActor::IsMovingState(ERelicState State)
+{
+    // Neutral and Dropped relics only move when something wakes their body up, which UpdateMovementReplication picks up from the wake/hit events
+    return (State == ERelicState::Thrown) || (State == ERelicState::BeingPassed);
+}
+
+void ARelicActor::OnRelicMeshWake(UPrimitiveComponent* WakingComponent, FName BoneName)
+{
+    if (!IsActorTickEnabled())
+    {
+        UpdateMovementReplication();
+    }
+}
+
+void ARelicActor::OnRelicMeshHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
+{
+    if (!IsActorTickEnabled())
+    {
+        UpdateMovementReplication();
+    }
+}
+
+void ARelicActor::UpdateMovementReplication()
+{
+    check(HasAuthority());
+
+    // Whatever the state, an awake simulating body can move and has to be replicated
+    const bool bMoving = RelicMesh->IsSimulatingPhysics() && RelicMesh->IsAnyRigidBodyAwake();
+
+    if (bMoving)
+    {
+        if (NetDormancy != DORM_Awake)
+        {
+            SetNetDormancy(DORM_Awake);
+        }
+
+        SetNetUpdateFrequency(RelicSettings ? RelicSettings->MovingNetUpdateFrequency : 30.0f);
+        CaptureMovementSnapshot();
+    }
+    else if (CurrentCarrier)
+    {
+        // The carrier's client sends the throw/pass RPCs through the relic's channel, which a dormant relic doesn't have open.
+        // Nothing moves on its own while carried, so stay awake at the minimum rate.
+        if (NetDormancy != DORM_Awake)
+        {
+            SetNetDormancy(DORM_Awake);
+        }
+
+        SetNetUpdateFrequency(GetMinNetUpdateFrequency());
+    }
+    else if (NetDormancy != DORM_DormantAll)
+    {
+        // A throw or pass that came to rest has ended, the thrower no longer needs to own the relic
+        SetOwner(nullptr);
+
+        // Send where the relic came to rest before going dormant, so late joiners see it there too
+        if (CaptureMovementSnapshot())
+        {
+            ForceNetUpdate();
+        }
+        SetNetDormancy(DORM_DormantAll);
+    }
+
+    // Tick while the body is awake, and for the whole flight of a launch until it comes to rest (and the relic goes dormant).
+    // A relic at rest doesn't tick, OnRelicMeshWake/OnRelicMeshHit call this again when it gets moving.
+    SetActorTickEnabled(bMoving || (IsMovingState(CurrentState) && (NetDormancy == DORM_Awake)));
+}
+
+bool ARelicActor::CaptureMovementSnapshot()
+{
+    const FVector Location = GetActorLocation();
+    const FRotator Rotation = GetActorRotation();
+    const FVector LinearVelocity = RelicMesh->IsSimulatingPhysics() && RelicMesh->IsAnyRigidBodyAwake() ? RelicMesh->GetPhysicsLinearVelocity() : FVector::ZeroVector;
+
+    // Don't dirty the property (and send it) if nothing changed at the precision we replicate with
+    if ((MovementSnapshot.SnapshotId != 0) &&
+        MovementSnapshot.Location.Equals(Location, 0.1) &&
+        MovementSnapshot.LinearVelocity.Equals(LinearVelocity, 0.1) &&
+        MovementSnapshot.Rotation.Equals(Rotation, 0.01))
+    {
+        return false;
+    }
+
+    MovementSnapshot.Location = Location;
+    MovementSnapshot.Rotation = Rotation;
+    MovementSnapshot.LinearVelocity = LinearVelocity;
+    MovementSnapshot.SnapshotId = FMath::Max<uint8>(MovementSnapshot.SnapshotId + 1, 1);
+    return true;
+}
+
+void ARelicActor::UpdateClientTick()
+{
+    // Clients only tick to smooth replicated movement while the relic moves on its own, or to run a predicted launch
+    SetActorTickEnabled(bPredictingLaunch || ((CurrentCarrier == nullptr) && !MovementSnapshot.LinearVelocity.IsNearlyZero()));
+}
+
+void ARelicActor::SmoothReplicatedMovement(float DeltaSeconds)
+{
+    if ((MovementSnapshot.SnapshotId == 0) || (CurrentCarrier != nullptr))
+    {
+        return;
+    }
+
+    const float Smoothing = RelicSettings ? RelicSettings->NetworkSmoothing : 0.1f;
+    const float MaxExtrapolationTime = RelicSettings ? RelicSettings->MaxExtrapolationTime : 0.25f;
+
+    // Extrapolate the ballistic path from the last snapshot, for a limited time so a missed bounce doesn't send the relic through the floor
+    const float TimeSinceSnapshot = FMath::Min((float)(GetWorld()->GetTimeSeconds() - LastSnapshotReceiveTime), MaxExtrapolationTime);
+    FVector TargetLocation = MovementSnapshot.Location + (MovementSnapshot.LinearVelocity * TimeSinceSnapshot);
+    if (!MovementSnapshot.LinearVelocity.IsNearlyZero() && RelicMesh->IsGravityEnabled())
+    {
+        TargetLocation.Z += 0.5f * GetWorld()->GetGravityZ() * FMath::Square(TimeSinceSnapshot);
+    }
+
+    // Exponentially close the gap, NetworkSmoothing is roughly the time it takes to close most of it
+    const float Alpha = (Smoothing > 0.0f) ? (1.0f - FMath::Exp(-DeltaSeconds / Smoothing)) : 1.0f;
+    const FVector NewLocation = FMath::Lerp(GetActorLocation(), TargetLocation, Alpha);
+    const FQuat NewRotation = FQuat::Slerp(GetActorQuat(), MovementSnapshot.Rotation.Quaternion(), Alpha);
+
+    SetActorLocationAndRotation(NewLocation, NewRotation, false, nullptr, ETeleportType::TeleportPhysics);
+}
+
+// --- Launch Prediction ---
+
+void ARelicActor::StartPredictedLaunch(const FVector& LaunchVelocity)
+{
+    // Only the owning client predicts, the server (and a listen server host) launch the real thing directly
+    if (HasAuthority() || bPredictingLaunch || (CurrentState != ERelicState::Carried) || !CurrentCarrier || !CurrentCarrier->IsLocallyControlled())
+    {
+        return;
+    }
+
+    PredictingCarrier = CurrentCarrier;
+
+    DetachFromCarrier();
+
+    bPredictingLaunch = true;
+    bPredictedLaunchBlocked = false;
+    PredictedLaunchLocation = GetActorLocation();
+    PredictedLaunchVelocity = LaunchVelocity;
+    PredictedLaunchTime = GetWorld()->GetTimeSeconds();
+    PredictionError = FVector::ZeroVector;
+
+    SetActorTickEnabled(true);
+}
+
+void ARelicActor::StopPredictedLaunch()
+{
+    bPredictingLaunch = false;
+    PredictingCarrier.Reset();
+
+    if (CurrentCarrier)
+    {
+        AttachToCarrier(CurrentCarrier);
+    }
+    else if (MovementSnapshot.SnapshotId != 0)
+    {
+        // Continue from wherever the server says the relic is, smoothing from here
+        LastSnapshotReceiveTime = GetWorld()->GetTimeSeconds();
+    }
+
+    UpdateClientTick();
+}
+
+void ARelicActor::ReconcilePredictedLaunch()
+{
+    const double Now = GetWorld()->GetTimeSeconds();
+
+    // The snapshot is about half a round trip old by the time it gets here, and our prediction runs that far ahead of the server
+    float OneWayLatency = 0.0f;
+    if (const ABwayCharacterWithAbilities* Carrier = PredictingCarrier.Get())
+    {
+        if (const APlayerState* PlayerState = Carrier->GetPlayerState())
+        {
+            OneWayLatency = PlayerState->GetPingInMilliseconds() * 0.0005f;
+        }
+    }
+
+    // Keep the displayed position where it is, and let the error between it and the corrected path decay
+    const FVector DisplayedLocation = GetActorLocation();
+
+    bPredictedLaunchBlocked = false;
+    PredictedLaunchLocation = MovementSnapshot.Location;
+    PredictedLaunchVelocity = MovementSnapshot.LinearVelocity;
+    PredictedLaunchTime = Now - OneWayLatency;
+
+    FVector CorrectedLocation;
+    FVector CorrectedVelocity;
+    URelicTrajectoryLibrary::PredictStateAtTime(PredictedLaunchLocation, PredictedLaunchVelocity, GetWorld()->GetGravityZ(), RelicSettings ? RelicSettings->LinearDamping : 0.0f, OneWayLatency, CorrectedLocation, CorrectedVelocity);
+    PredictionError = DisplayedLocation - CorrectedLocation;
+
+    // A resting snapshot means the server's relic has stopped, there is nothing left to predict
+    if (MovementSnapshot.LinearVelocity.IsNearlyZero())
+    {
+        StopPredictedLaunch();
+    }
+}
+
+void ARelicActor::TickPredictedLaunch(float DeltaSeconds)
+{
+    const FVector CurrentLocation = GetActorLocation();
+    FVector PredictedLocation = PredictedLaunchLocation;
+
+    if (!bPredictedLaunchBlocked)
+    {
+        FVector PredictedVelocity;
+        const float TimeSinceLaunch = (float)(GetWorld()->GetTimeSeconds() - PredictedLaunchTime);
+        URelicTrajectoryLibrary::PredictStateAtTime(PredictedLaunchLocation, PredictedLaunchVelocity, GetWorld()->GetGravityZ(), RelicSettings ? RelicSettings->LinearDamping : 0.0f, TimeSinceLaunch, PredictedLocation, PredictedVelocity);
+    }
+
+    const float Smoothing = RelicSettings ? RelicSettings->NetworkSmoothing : 0.1f;
+    PredictionError *= (Smoothing > 0.0f) ? FMath::Exp(-DeltaSeconds / Smoothing) : 0.0f;
+
+    FVector NewLocation = PredictedLocation + PredictionError;
+
+    // Stop at the first thing we would hit, the server's snapshots tell us where the relic actually ends up
+    if (!bPredictedLaunchBlocked)
+    {
+        FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(RelicPredictedLaunch), false, this);
+        QueryParams.AddIgnoredActor(PredictingCarrier.Get());
+
+        FHitResult Hit;
+        if (GetWorld()->LineTraceSingleByChannel(Hit, CurrentLocation, NewLocation, ECC_Visibility, QueryParams))
+        {
+            NewLocation = Hit.Location;
+            bPredictedLaunchBlocked = true;
+            PredictedLaunchLocation = Hit.Location;
+            PredictionError = FVector::ZeroVector;
+        }
+    }
+
+    SetActorLocation(NewLocation, false, nullptr, ETeleportType::TeleportPhysics);
+}
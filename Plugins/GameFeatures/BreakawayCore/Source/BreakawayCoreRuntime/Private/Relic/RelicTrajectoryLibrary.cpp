@@ -0,0 +1,85 @@
+#include "Relic/RelicTrajectoryLibrary.h"
+#include "Relic/RelicSettings.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+FVector URelicTrajectoryLibrary::ComputeLaunchVelocity(const URelicSettings* Settings, const FRotator& AimRotation)
+{
+    const float Speed = Settings ? Settings->ThrowVelocity : 1000.0f;
+    const float Angle = Settings ? Settings->ThrowAngle : 30.0f;
+
+    // Pitch the aim up by ThrowAngle, without going past straight up
+    FRotator LaunchRotation = AimRotation;
+    LaunchRotation.Pitch = FMath::Min(FRotator::NormalizeAxis(AimRotation.Pitch) + Angle, 90.0f);
+
+    return LaunchRotation.Vector() * Speed;
+}
+
+FVector URelicTrajectoryLibrary::ClampLaunchVelocity(const URelicSettings* Settings, const FVector& LaunchVelocity)
+{
+    // Leaves room for the quantization of the RPC parameter
+    constexpr float SpeedTolerance = 1.01f;
+
+    const float MaxSpeed = (Settings ? Settings->ThrowVelocity : 1000.0f) * SpeedTolerance;
+    return LaunchVelocity.GetClampedToMaxSize(MaxSpeed);
+}
+
+void URelicTrajectoryLibrary::PredictStateAtTime(const FVector& StartLocation, const FVector& LaunchVelocity, float GravityZ, float LinearDamping, float Time, FVector& OutLocation, FVector& OutVelocity)
+{
+    const FVector Gravity(0.0, 0.0, GravityZ);
+
+    if (LinearDamping <= UE_KINDA_SMALL_NUMBER)
+    {
+        OutLocation = StartLocation + (LaunchVelocity * Time) + (0.5 * Gravity * FMath::Square(Time));
+        OutVelocity = LaunchVelocity + (Gravity * Time);
+        return;
+    }
+
+    // With damping the velocity decays exponentially towards the terminal velocity Gravity / LinearDamping
+    const FVector TerminalVelocity = Gravity / LinearDamping;
+    const float Decay = FMath::Exp(-LinearDamping * Time);
+
+    OutVelocity = TerminalVelocity + ((LaunchVelocity - TerminalVelocity) * Decay);
+    OutLocation = StartLocation + (TerminalVelocity * Time) + ((LaunchVelocity - TerminalVelocity) * ((1.0f - Decay) / LinearDamping));
+}
+
+bool URelicTrajectoryLibrary::PredictRelicPath(const UObject* WorldContextObject, const URelicSettings* Settings, const FVector& StartLocation, const FVector& LaunchVelocity, const TArray<AActor*>& ActorsToIgnore,
+    TArray<FVector>& OutPathPoints, FHitResult& OutHit, float MaxTime, float TimeStep)
+{
+    OutPathPoints.Reset();
+    OutHit = FHitResult();
+
+    UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+    if (!World || TimeStep <= 0.0f)
+    {
+        return false;
+    }
+
+    const float LinearDamping = Settings ? Settings->LinearDamping : 0.0f;
+    const float GravityZ = World->GetGravityZ();
+
+    FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(RelicPredictPath), false);
+    QueryParams.AddIgnoredActors(ActorsToIgnore);
+
+    OutPathPoints.Reserve(FMath::CeilToInt32(MaxTime / TimeStep) + 1);
+    OutPathPoints.Add(StartLocation);
+
+    FVector PreviousLocation = StartLocation;
+    for (float Time = TimeStep; Time <= MaxTime + UE_KINDA_SMALL_NUMBER; Time += TimeStep)
+    {
+        FVector Location;
+        FVector Velocity;
+        PredictStateAtTime(StartLocation, LaunchVelocity, GravityZ, LinearDamping, Time, Location, Velocity);
+
+        if (World->LineTraceSingleByChannel(OutHit, PreviousLocation, Location, ECC_Visibility, QueryParams))
+        {
+            OutPathPoints.Add(OutHit.Location);
+            return true;
+        }
+
+        OutPathPoints.Add(Location);
+        PreviousLocation = Location;
+    }
+
+    return false;
+}
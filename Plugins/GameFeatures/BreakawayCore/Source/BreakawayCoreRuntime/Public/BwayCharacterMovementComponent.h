@@ -27,6 +27,8 @@ class BREAKAWAYCORERUNTIME_API UBwayCharacterMovementComponent : public ULyraCha
 {
 	GENERATED_BODY()
 
+	friend class FSavedMove_BwayCharacter;
+
 public:
 	UBwayCharacterMovementComponent(const FObjectInitializer& ObjectInitializer);
 
@@ -40,6 +42,10 @@ public:
 	virtual void PhysFalling(float DeltaTime, int32 Iterations) override;
 	virtual void ProcessLanded(const FHitResult& Hit, float RemainingTime, int32 Iterations) override;
 	virtual bool IsCustomMovementMode(uint8 TestCustomMovementMode) const { return MovementMode == MOVE_Custom && CustomMovementMode == TestCustomMovementMode; }
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+	virtual bool ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientWorldLocation, const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode) override;
 	//~ End UCharacterMovementComponent Interface
 
 	// --- Slide Parameters (Derived from Lua, exposed for tuning) ---
@@ -131,6 +137,13 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Character Movement: Sliding")
 	virtual bool CheckShouldEndSlide();
 
+	/**
+	 * Asks the movement component to enter slide on its next move. Only has an effect on the locally controlled character,
+	 * the request reaches the server in the saved move's compressed flags so both sides start the slide on the same move.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Character Movement: Sliding")
+	void RequestSlide();
+
 	/** Returns true if currently in the custom sliding movement mode. */
 	UFUNCTION(BlueprintPure, Category = "Character Movement: Sliding")
 	bool IsSliding() const { return IsCustomMovementMode((uint8)ECustomMovementMode::CMOVE_Slide); }
@@ -142,6 +155,7 @@ public:
 protected:
 	//~ Begin UObject Interface
 	virtual void InitializeComponent() override;
+	virtual void UninitializeComponent() override;
 	//~ End UObject Interface
 
 	/** Contains the core physics logic for the CMOVE_Sliding custom movement mode. */
@@ -159,6 +173,16 @@ protected:
 	/** Calculates the current effective speed/accel/friction modifiers based on game state (e.g., carrying loot). */
 	virtual void GetCurrentSlideModifiers(float& OutMaxSpeedFactor, float& OutSlopeAccelFactor, float& OutFrictionMultiplier) const;
 
+	/** Recalculates the cached slide modifiers if they were invalidated, or the properties they are derived from changed, since the last move. */
+	void RefreshSlideModifiers();
+
+	/** Marks the cached slide modifiers as stale, e.g. when the carrying loot tag is added or removed. */
+	void InvalidateSlideModifiers() { bSlideModifiersDirty = true; }
+
+	/** Binds InvalidateSlideModifiers to changes of CarryingLootTag on the ASC. */
+	void BindSlideModifierTagEvent();
+	void OnCarryingLootTagChanged(const FGameplayTag Tag, int32 NewCount);
+
 	/** Performs setup when entering the slide state (e.g., capsule resize). */
 	virtual void StartSlide();
 
@@ -170,12 +194,58 @@ protected:
 	FRotator DefaultRotationRate;
 	float DefaultGravityScale;
 
+	/** Reads the slide and jump input on the locally controlled character into the intent flags below. */
+	void UpdateSlideInput();
+
 	// State tracking
 	bool bDidSlideFall = false; // Flag set when transitioning from Slide to Fall
 
+	// Slide intent. Set from input on the owning client and replicated to the server through the saved move's compressed flags,
+	// so every machine runs the slide from the same input instead of reading the input component (which only exists locally).
+	uint8 bWantsToSlide : 1; // Slide input is held (FLAG_Custom_0)
+	uint8 bWantsToSlideJump : 1; // Jump input is held, exits the slide with a jump (FLAG_Custom_1)
+	uint8 bSlideRequested : 1; // Enter slide on the next move, consumed by that move (FLAG_Custom_2)
+
 	// State for slide-jump landing penalty
 	float LastSlideJumpTime = -1.0f;
 
+	// Slide modifiers from GetCurrentSlideModifiers, refreshed at most once per move instead of querying tags in every
+	// GetMaxSpeed/friction/acceleration call
+	struct FSlideModifiers
+	{
+		float MaxSpeedFactor = 1.0f;
+		float SlopeAccelFactor = 1.0f;
+		float FrictionMultiplier = 1.0f;
+
+		// The (Blueprint writable) properties the modifiers were calculated from, so changing any of them at runtime recalculates them
+		float SlideMaxSpeedFactor = 0.0f;
+		float SlideSlopeAccelerationFactor = 0.0f;
+		float LootMaxSpeedFactorMultiplier = 0.0f;
+		float LootSlopeAccelFactorMultiplier = 0.0f;
+		float LootFrictionMultiplier = 0.0f;
+	};
+	FSlideModifiers CachedSlideModifiers;
+	bool bSlideModifiersDirty = true;
+	FDelegateHandle CarryingLootTagEventHandle;
+
+	// Floor found at the end of the last slide update, reused by the next update if neither the character nor the floor has moved
+	// since, and nothing else changed CurrentFloor
+	FVector SlideFloorLocation = FVector::ZeroVector;
+	FVector SlideFloorNormal = FVector::ZeroVector;
+	TWeakObjectPtr<UPrimitiveComponent> SlideFloorComponent;
+	FTransform SlideFloorComponentTransform = FTransform::Identity;
+	bool bHasSlideFloor = false;
+
+	/** Returns true if the floor found at the end of the last slide update is still valid for the current location. */
+	bool CanReuseSlideFloor() const;
+
+	/** Remembers CurrentFloor as the floor to reuse by the next slide update. */
+	void CacheSlideFloor();
+
+	// Slope friction factor for the last slope angle, the power curve only has to be evaluated when the floor changes
+	float LastFrictionSlopeAngle = -1.0f;
+	float LastFrictionSlopePowerFactor = 1.0f;
+
 	/** Cached Ability System Component for tag checking. */
 	UPROPERTY(Transient)
 	TObjectPtr<UAbilitySystemComponent> AbilitySystemComponent;
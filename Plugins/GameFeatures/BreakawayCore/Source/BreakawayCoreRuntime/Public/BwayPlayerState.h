@@ -26,6 +26,9 @@ public:
 
 	UFUNCTION(BlueprintPure) FORCEINLINE bool IsRequestingRelic() const { return bIsRequestingRelic; }
 
+	// Server only: world time this player last started requesting the relic, used to resolve contested pickups
+	double GetRelicRequestTime() const { return RelicRequestTime; }
+
 	UFUNCTION()
 	void OnRep_IsRequestingRelic();
 
@@ -37,4 +40,7 @@ public:
 	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnRequestingRelicChanged, bool, bIsRequesting);
 	UPROPERTY(BlueprintAssignable, Category = "Relic|UI")
 	FOnRequestingRelicChanged OnRequestingRelicChanged;
+
+private:
+	double RelicRequestTime = 0.0;
 };
\ No newline at end of file
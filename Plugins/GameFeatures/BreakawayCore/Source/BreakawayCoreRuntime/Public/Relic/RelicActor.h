@@ -27,6 +27,39 @@ enum class ERelicState : uint8
     Resetting		UMETA(DisplayName = "Resetting") // After scoring, before respawn
 };
 
+/**
+ * Compact snapshot of the relic's physics state, sent by the server while the relic is moving on its own
+ */
+USTRUCT()
+struct BREAKAWAYCORERUNTIME_API FRelicMovementSnapshot
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    FVector Location = FVector::ZeroVector;
+
+    UPROPERTY()
+    FVector LinearVelocity = FVector::ZeroVector;
+
+    UPROPERTY()
+    FRotator Rotation = FRotator::ZeroRotator;
+
+    // Incremented for every snapshot the server takes, 0 means no snapshot has been taken yet
+    UPROPERTY()
+    uint8 SnapshotId = 0;
+
+    bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FRelicMovementSnapshot> : public TStructOpsTypeTraitsBase2<FRelicMovementSnapshot>
+{
+    enum
+    {
+        WithNetSerializer = true
+    };
+};
+
 /**
  * The main actor class for the Relic object
  */
@@ -41,6 +74,7 @@ public:
     //~ AActor Interface
     virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
     virtual void BeginPlay() override;
+    virtual void Tick(float DeltaSeconds) override;
 
     UFUNCTION()
     virtual void OnInteractionSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
@@ -65,27 +99,53 @@ public:
     UFUNCTION()
     virtual void OnRep_CurrentCarrier();
     
+    // Physics state of the relic while it moves on its own (thrown, passed, or bumped while lying around), see UpdateMovementReplication
+    UPROPERTY(ReplicatedUsing = OnRep_MovementSnapshot)
+    FRelicMovementSnapshot MovementSnapshot;
+    UFUNCTION()
+    virtual void OnRep_MovementSnapshot();
+
     UPROPERTY(BlueprintReadOnly)
     int32 LastPossessingTeam;
 
+    // Returns true for the launch states (thrown or passed), in which the relic moves on its own until it comes to rest
+    static bool IsMovingState(ERelicState State);
+
     // --- Core Logic ---
 
     // Called by GA_PickupRelic on the server to attach the relic
     UFUNCTION(BlueprintCallable, Category = "Relic|Interaction")
     virtual void OnPickedUp(ABwayCharacterWithAbilities* NewCarrier);
 
-    // Called by GA_DropRelic, GA_ThrowRelic, GA_PassRelic on the server to detach
+    // Called by GA_DropRelic on the server to detach
     UFUNCTION(BlueprintCallable, Category = "Relic|Interaction")
     virtual void OnDropped();
 
-    // Server RPC called by GA_ThrowRelic
+    // Launches the relic on the server. The velocity is clamped to what URelicTrajectoryLibrary::ComputeLaunchVelocity allows.
+    // Sent by ThrowRelic from the owning client, server only abilities can call it directly
     UFUNCTION(BlueprintCallable, Server, Reliable, WithValidation)
     void Server_ThrowRelic(const FVector& ThrowVelocity);
 
-    // Server RPC called by GA_PassRelic
     UFUNCTION(BlueprintCallable, Server, Reliable, WithValidation)
     void Server_PassRelic(const FVector& PassVelocity);
 
+    // Called by GA_ThrowRelic/GA_PassRelic wherever they run (locally predicted abilities run on both the client and the server).
+    // Only the carrier's controlling machine launches: the owning client predicts the path right away and asks the server to
+    // launch it (Server_ThrowRelic/Server_PassRelic), a listen server host or bot launches directly. The server's copy of a
+    // remote carrier's ability does nothing and waits for the client's request, so there is only ever one launch.
+    UFUNCTION(BlueprintCallable, Category = "Relic|Interaction")
+    void ThrowRelic(const FVector& ThrowVelocity);
+
+    UFUNCTION(BlueprintCallable, Category = "Relic|Interaction")
+    void PassRelic(const FVector& PassVelocity);
+
+    // Sent to the owning client when the server didn't launch the relic, so a predicted throw/pass is undone
+    UFUNCTION(Client, Reliable)
+    void Client_RejectPredictedLaunch();
+
+    UFUNCTION(BlueprintPure, Category = "Relic|State")
+    bool IsPredictingLaunch() const { return bPredictingLaunch; }
+
     // Multicast RPC for cosmetic effects (e.g., throw/pass VFX/SFX)
     UFUNCTION(NetMulticast, Unreliable)
     void Multicast_PlayThrowPassFX();
@@ -114,7 +174,82 @@ protected:
 
     // Internal helper to handle detachment and physics setup
     void DetachFromCarrier(const FVector* InitialVelocity = nullptr);
+
+    // Server: clears CurrentCarrier, remembering who it was so they can't pick the relic straight back up
+    void ReleaseCarrier();
+
+    // Server: wakes the relic up (and sends snapshots) while it is moving, keeps it awake while carried and puts it to sleep once it is at rest
+    void UpdateMovementReplication();
+
+    // Server: a resting relic doesn't tick, these restart movement replication when its body gets moving again
+    UFUNCTION()
+    void OnRelicMeshWake(UPrimitiveComponent* WakingComponent, FName BoneName);
+    UFUNCTION()
+    void OnRelicMeshHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
+
+    // Server: stores the current physics state in MovementSnapshot, returns false if nothing changed
+    bool CaptureMovementSnapshot();
+
+    // Server: the pickup arbiter runs on a timer while the relic can be picked up and characters are inside the interaction sphere
+    static bool IsPickupableState(ERelicState State);
+    void StartPickupArbiter();
+    void StopPickupArbiter();
+
+    // Server: picks the one requesting character (if any) that gets to pick the relic up and sends it the pickup event
+    void RunPickupArbiter();
+
+    // Server: returns true if Challenger should win a contested pickup against the current best
+    bool IsBetterPickupCandidate(const ABwayCharacterWithAbilities* Challenger, double ChallengerDistSq, const ABwayCharacterWithAbilities* Best, double BestDistSq) const;
+
+    void SendPickupEvent(ABwayCharacterWithAbilities* Character);
+
+    // Client: only ticks while predicting a launch or while the last snapshot says the relic is moving
+    void UpdateClientTick();
+
+    // Client: moves the relic towards where the last snapshot says it should be by now
+    void SmoothReplicatedMovement(float DeltaSeconds);
+
+    // Shared by ThrowRelic and PassRelic, see ThrowRelic
+    void RequestLaunch(const FVector& LaunchVelocity, ERelicState LaunchState);
+
+    // Server: detaches the relic from its carrier and launches it, or tells the owning client its prediction was rejected
+    void LaunchRelic(const FVector& LaunchVelocity, ERelicState LaunchState);
+
+    // Owning client: predicted throw/pass, see ThrowRelic
+    void StartPredictedLaunch(const FVector& LaunchVelocity);
+    void StopPredictedLaunch();
+    void TickPredictedLaunch(float DeltaSeconds);
+
+    // Owning client: continues the predicted path from an authoritative snapshot, smoothing out the difference
+    void ReconcilePredictedLaunch();
 private:
     // Helper to check if pickup is allowed based on state and character request
     bool CanBePickedUpBy(ABwayCharacterWithAbilities* Character) const;
+
+    FTimerHandle PickupArbiterTimerHandle;
+    FTimerHandle PickupArbiterNextTickHandle;
+
+    // Server: the character that last carried the relic, and when they let go of it, see PreviousCarrierPickupDelay
+    TWeakObjectPtr<ABwayCharacterWithAbilities> PreviousCarrier;
+    double PreviousCarrierReleaseTime = 0.0;
+
+    // Server: last character sent the pickup event, and when, to avoid resending it every arbiter run
+    TWeakObjectPtr<ABwayCharacterWithAbilities> LastPickupEventCharacter;
+    double LastPickupEventTime = 0.0;
+
+    // Client: world time the last movement snapshot arrived
+    double LastSnapshotReceiveTime = 0.0;
+
+    // Owning client: the path currently being predicted, restarted from every authoritative snapshot
+    bool bPredictingLaunch = false;
+    bool bPredictedLaunchBlocked = false;
+    FVector PredictedLaunchLocation = FVector::ZeroVector;
+    FVector PredictedLaunchVelocity = FVector::ZeroVector;
+    double PredictedLaunchTime = 0.0;
+
+    // Owning client: offset between what is displayed and the predicted path, decays using NetworkSmoothing
+    FVector PredictionError = FVector::ZeroVector;
+
+    // Owning client: the carrier that threw the relic, ignored by the predicted path
+    TWeakObjectPtr<ABwayCharacterWithAbilities> PredictingCarrier;
 };
\ No newline at end of file
@@ -10,6 +10,14 @@
 #include "AbilitySystem/LyraAbilitySet.h"
 #include "RelicSettings.generated.h"
 
+// How the pickup arbiter picks between several characters requesting the relic at the same time
+UENUM(BlueprintType)
+enum class ERelicPickupPriority : uint8
+{
+    Closest				UMETA(DisplayName = "Closest"), // Closest character wins, earliest request breaks ties
+    EarliestRequest		UMETA(DisplayName = "Earliest Request") // Earliest request wins, closest character breaks ties
+};
+
 /**
  * Data asset containing configurable settings for the Relic System
  */
@@ -87,6 +95,22 @@ public:
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Gameplay", meta = (ClampMin = "0.0", UIMin = "0.0"))
     float PickupRadius = 150.0f;
     
+    // How contested pickups are resolved
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Gameplay")
+    ERelicPickupPriority PickupPriority = ERelicPickupPriority::Closest;
+
+    // How often (in seconds) the server looks for a character to pick the relic up while it can be picked up and someone is near
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Gameplay", meta = (ClampMin = "0.01"))
+    float PickupArbiterInterval = 0.1f;
+
+    // How long (in seconds) to wait before sending the pickup event to the same character again, if the first one didn't pick it up
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Gameplay", meta = (ClampMin = "0.0"))
+    float PickupEventRetryDelay = 0.5f;
+
+    // How long (in seconds) the character that dropped, threw or passed the relic has to wait before they can pick it up again
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Gameplay", meta = (ClampMin = "0.0"))
+    float PreviousCarrierPickupDelay = 1.0f;
+
     // If true, certain abilities will be restricted while carrying
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Gameplay")
     bool bRestrictAbilitiesWhileCarrying = true;
@@ -147,9 +171,17 @@ public:
     // Network Settings
     //-----------------------------------------------------------
     
-    // Amount of smoothing to apply for network replication
+    // Amount of smoothing to apply for network replication (time in seconds for clients to close most of the gap to the replicated position, 0 snaps)
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Network", meta = (ClampMin = "0.0"))
     float NetworkSmoothing = 0.1f;
+
+    // How far past the last movement snapshot (in seconds) clients will extrapolate the relic
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Network", meta = (ClampMin = "0.0"))
+    float MaxExtrapolationTime = 0.25f;
+
+    // Net update frequency while the relic is thrown, passed or dropped. The relic is dormant the rest of the time
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Network", meta = (ClampMin = "1.0"))
+    float MovingNetUpdateFrequency = 30.0f;
     
     //-----------------------------------------------------------
     // Spawn Settings
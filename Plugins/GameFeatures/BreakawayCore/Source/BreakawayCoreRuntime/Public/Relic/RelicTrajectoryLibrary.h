@@ -0,0 +1,37 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "RelicTrajectoryLibrary.generated.h"
+
+class URelicSettings;
+
+/**
+ * Trajectory prediction for thrown and passed relics.
+ * Shared by the owning client's predicted throw, the server's reconciliation and the pass-target UI, so they all agree on the path.
+ */
+UCLASS()
+class BREAKAWAYCORERUNTIME_API URelicTrajectoryLibrary : public UBlueprintFunctionLibrary
+{
+    GENERATED_BODY()
+
+public:
+    // Launch velocity for a throw or pass aimed along AimRotation, using the settings' ThrowVelocity and ThrowAngle
+    UFUNCTION(BlueprintPure, Category = "Relic|Trajectory")
+    static FVector ComputeLaunchVelocity(const URelicSettings* Settings, const FRotator& AimRotation);
+
+    // Limits a launch velocity requested by a client to what ComputeLaunchVelocity can produce (the settings' ThrowVelocity, plus a small tolerance)
+    UFUNCTION(BlueprintPure, Category = "Relic|Trajectory")
+    static FVector ClampLaunchVelocity(const URelicSettings* Settings, const FVector& LaunchVelocity);
+
+    // Location and velocity of a relic launched from StartLocation with LaunchVelocity, Time seconds later (ignoring collision).
+    // Accounts for gravity and the relic's linear damping the same way the physics simulation does.
+    UFUNCTION(BlueprintPure, Category = "Relic|Trajectory")
+    static void PredictStateAtTime(const FVector& StartLocation, const FVector& LaunchVelocity, float GravityZ, float LinearDamping, float Time, FVector& OutLocation, FVector& OutVelocity);
+
+    // Steps along the predicted path and traces between the points, stopping at the first blocking hit.
+    // Returns true if something was hit within MaxTime.
+    UFUNCTION(BlueprintCallable, Category = "Relic|Trajectory", meta = (WorldContext = "WorldContextObject", AutoCreateRefTerm = "ActorsToIgnore"))
+    static bool PredictRelicPath(const UObject* WorldContextObject, const URelicSettings* Settings, const FVector& StartLocation, const FVector& LaunchVelocity, const TArray<AActor*>& ActorsToIgnore,
+        TArray<FVector>& OutPathPoints, FHitResult& OutHit, float MaxTime = 3.0f, float TimeStep = 0.05f);
+};
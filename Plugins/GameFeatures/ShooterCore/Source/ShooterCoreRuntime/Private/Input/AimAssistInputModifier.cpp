@@ -135,6 +135,7 @@ FAimAssistSettings::FAimAssistSettings()
 	SlowMinRotationRate.SetValue(0.0f);
 
 	bEnableAsyncVisibilityTrace = true;
+	bBatchVisibilityTraces = false;
 	bRequireInput = true;
 	bApplyPull = true;
 	bApplySlowing = true;
@@ -200,6 +201,7 @@ void FAimAssistOwnerViewData::UpdateViewData(const APlayerController* PC)
 	ViewRect = ProjectionData.GetConstrainedViewRect();
 	ViewTransform = FTransform(ViewRotation, ViewLocation);
 	ViewForward = ViewTransform.GetUnitAxis(EAxis::X);
+	FOVScale = UAimAssistTargetManagerComponent::GetFOVScale(PC, ECommonInputType::Gamepad);
 
 	const FVector OldLocation = PlayerTransform.GetTranslation();
 	const FVector NewLocation = Pawn->GetActorLocation();
@@ -234,6 +236,7 @@ void FAimAssistOwnerViewData::ResetViewData()
 	PlayerTransform = FTransform::Identity;
 	PlayerInverseTransform = FTransform::Identity;
 	ViewForward = FVector::ZeroVector;
+	FOVScale = 1.0f;
 
 	DeltaMovement = FVector::ZeroVector;
 	TeamID = INDEX_NONE;
@@ -562,12 +565,12 @@ void UAimAssistInputModifier::UpdateTargetData(float DeltaTime)
 	// Update target weights.
 	//
 	float TotalAssistWeight = 0.0f;
+	const float MaxAssistTime = (NewTargetCache.Num() > 0) ? Settings.GetTargetWeightMaxTime() : 0.0f;
 
 	for (FLyraAimAssistTarget& Target : NewTargetCache)
 	{
 		if (Target.bUnderAssistOuterReticle && Target.bIsVisible)
 		{
-			const float MaxAssistTime = Settings.GetTargetWeightMaxTime();
 			Target.AssistTime = FMath::Min((Target.AssistTime + DeltaTime), MaxAssistTime);
 		}
 		else
@@ -687,8 +690,7 @@ FRotator UAimAssistInputModifier::UpdateRotationalVelocity(APlayerController* PC
 
 		// Clamp the maximum amount of pull rotation to prevent it from yanking the player's view too much.
 		// The clamped rate is scaled so it feels the same regardless of field of view.
-		const float FOVScale = UAimAssistTargetManagerComponent::GetFOVScale(PC, ECommonInputType::Gamepad);
-		const float PullMaxRotationRate = (Settings.PullMaxRotationRate.GetValue() * FOVScale);
+		const float PullMaxRotationRate = (Settings.PullMaxRotationRate.GetValue() * OwnerViewData.FOVScale);
 		if (PullMaxRotationRate > 0.0f)
 		{
 			const float PullMaxRotation = (PullMaxRotationRate * DeltaTime);
@@ -730,8 +732,7 @@ FRotator UAimAssistInputModifier::UpdateRotationalVelocity(APlayerController* PC
 
 		// Clamp the minimum amount of slow to prevent it from feeling sluggish on low sensitivity settings.
 		// The clamped rate is scaled so it feels the same regardless of field of view.
-		const float FOVScale = UAimAssistTargetManagerComponent::GetFOVScale(PC, ECommonInputType::Gamepad);
-		const float SlowMinRotationRate = (Settings.SlowMinRotationRate.GetValue() * FOVScale);
+		const float SlowMinRotationRate = (Settings.SlowMinRotationRate.GetValue() * OwnerViewData.FOVScale);
 		if (SlowMinRotationRate > 0.0f)
 		{
 			SlowRates.Yaw = FMath::Max(SlowRates.Yaw, SlowMinRotationRate);
@@ -83,6 +83,250 @@ static bool GatherTargetInfo(const AActor* Actor, const UShapeComponent* ShapeCo
 	return true;
 }
 
+// Writes the points of the shape that bound it on screen (the same ones FAimAssistOwnerViewData::ProjectShapeToScreen uses), returns how many there are
+static int32 GatherShapeVertices(const FAimAssistOwnerViewData& OwnerData, const FCollisionShape& Shape, const FVector& ShapeOrigin, const FTransform& WorldTransform, FVector (&OutVertices)[FAimAssistCandidateBatch::VerticesPerCandidate])
+{
+	const FVector ViewAxisY = OwnerData.ViewTransform.GetUnitAxis(EAxis::Y);
+	const FVector ViewAxisZ = OwnerData.ViewTransform.GetUnitAxis(EAxis::Z);
+
+	if (Shape.IsBox())
+	{
+		const FVector BoxExtents = Shape.GetBox();
+
+		int32 NumVertices = 0;
+		for (int32 VertexIndex = 0; VertexIndex < 8; ++VertexIndex)
+		{
+			const FVector Corner(
+				(VertexIndex & 4) ? BoxExtents.X : -BoxExtents.X,
+				(VertexIndex & 2) ? BoxExtents.Y : -BoxExtents.Y,
+				(VertexIndex & 1) ? BoxExtents.Z : -BoxExtents.Z);
+			OutVertices[NumVertices++] = WorldTransform.TransformPositionNoScale(Corner + ShapeOrigin);
+		}
+		return NumVertices;
+	}
+	else if (Shape.IsSphere())
+	{
+		const float SphereRadius = Shape.GetSphereRadius();
+		const FVector SphereLocation = WorldTransform.TransformPositionNoScale(ShapeOrigin);
+		const FVector SphereExtent = (ViewAxisY * SphereRadius) + (ViewAxisZ * SphereRadius);
+
+		OutVertices[0] = SphereLocation + SphereExtent;
+		OutVertices[1] = SphereLocation - SphereExtent;
+		return 2;
+	}
+	else if (Shape.IsCapsule())
+	{
+		const float CapsuleAxisHalfLength = Shape.GetCapsuleAxisHalfLength();
+		const float CapsuleRadius = Shape.GetCapsuleRadius();
+
+		const FVector TopSphereLocation = WorldTransform.TransformPositionNoScale(FVector(0.0f, 0.0f, CapsuleAxisHalfLength) + ShapeOrigin);
+		const FVector BottomSphereLocation = WorldTransform.TransformPositionNoScale(FVector(0.0f, 0.0f, -CapsuleAxisHalfLength) + ShapeOrigin);
+		const FVector SphereExtent = (ViewAxisY * CapsuleRadius) + (ViewAxisZ * CapsuleRadius);
+
+		OutVertices[0] = TopSphereLocation + SphereExtent;
+		OutVertices[1] = TopSphereLocation - SphereExtent;
+		OutVertices[2] = BottomSphereLocation + SphereExtent;
+		OutVertices[3] = BottomSphereLocation - SphereExtent;
+		return 4;
+	}
+
+	UE_LOG(LogAimAssist, Warning, TEXT("GatherShapeVertices() - Invalid shape type!"));
+	return 0;
+}
+
+static float VectorHorizontalMin(const VectorRegister4Float& Vec)
+{
+	const VectorRegister4Float Min2 = VectorMin(Vec, VectorSwizzle(Vec, 2, 3, 0, 1));
+	const VectorRegister4Float Min1 = VectorMin(Min2, VectorSwizzle(Min2, 1, 0, 3, 2));
+
+	float Result;
+	VectorStoreFloat1(Min1, &Result);
+	return Result;
+}
+
+static float VectorHorizontalMax(const VectorRegister4Float& Vec)
+{
+	const VectorRegister4Float Max2 = VectorMax(Vec, VectorSwizzle(Vec, 2, 3, 0, 1));
+	const VectorRegister4Float Max1 = VectorMax(Max2, VectorSwizzle(Max2, 1, 0, 3, 2));
+
+	float Result;
+	VectorStoreFloat1(Max1, &Result);
+	return Result;
+}
+
+// Projects the vertices of every candidate to the screen, four at a time, and stores the screen bounds of each candidate.
+// Matches FSceneView::ProjectWorldToScreen, including ignoring the vertices behind the view.
+static void ProjectCandidatesToScreen(FAimAssistCandidateBatch& Batch, const FAimAssistOwnerViewData& OwnerData)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(AimAssist_ProjectCandidatesToScreen);
+
+	const int32 NumCandidates = Batch.Num();
+	const int32 NumPaddedCandidates = Align(NumCandidates, 4);
+
+	Batch.ScreenMinX.SetNumUninitialized(NumPaddedCandidates, EAllowShrinking::No);
+	Batch.ScreenMinY.SetNumUninitialized(NumPaddedCandidates, EAllowShrinking::No);
+	Batch.ScreenMaxX.SetNumUninitialized(NumPaddedCandidates, EAllowShrinking::No);
+	Batch.ScreenMaxY.SetNumUninitialized(NumPaddedCandidates, EAllowShrinking::No);
+
+	// The vertices are relative to VertexOrigin, so move the matrix there too
+	const FMatrix44f Matrix(FTranslationMatrix(Batch.VertexOrigin) * OwnerData.ViewProjectionMatrix);
+
+	const VectorRegister4Float MatrixXX = VectorSetFloat1(Matrix.M[0][0]);
+	const VectorRegister4Float MatrixYX = VectorSetFloat1(Matrix.M[1][0]);
+	const VectorRegister4Float MatrixZX = VectorSetFloat1(Matrix.M[2][0]);
+	const VectorRegister4Float MatrixWX = VectorSetFloat1(Matrix.M[3][0]);
+	const VectorRegister4Float MatrixXY = VectorSetFloat1(Matrix.M[0][1]);
+	const VectorRegister4Float MatrixYY = VectorSetFloat1(Matrix.M[1][1]);
+	const VectorRegister4Float MatrixZY = VectorSetFloat1(Matrix.M[2][1]);
+	const VectorRegister4Float MatrixWY = VectorSetFloat1(Matrix.M[3][1]);
+	const VectorRegister4Float MatrixXW = VectorSetFloat1(Matrix.M[0][3]);
+	const VectorRegister4Float MatrixYW = VectorSetFloat1(Matrix.M[1][3]);
+	const VectorRegister4Float MatrixZW = VectorSetFloat1(Matrix.M[2][3]);
+	const VectorRegister4Float MatrixWW = VectorSetFloat1(Matrix.M[3][3]);
+
+	// Clip space to view rect: X = Min.X + (ClipX / 2 + 0.5) * Width, Y = Min.Y + (0.5 - ClipY / 2) * Height
+	const FIntRect& ViewRect = OwnerData.ViewRect;
+	const float HalfWidth = ViewRect.Width() * 0.5f;
+	const float HalfHeight = ViewRect.Height() * 0.5f;
+	const VectorRegister4Float ScreenScaleX = VectorSetFloat1(HalfWidth);
+	const VectorRegister4Float ScreenScaleY = VectorSetFloat1(-HalfHeight);
+	const VectorRegister4Float ScreenOffsetX = VectorSetFloat1(ViewRect.Min.X + HalfWidth);
+	const VectorRegister4Float ScreenOffsetY = VectorSetFloat1(ViewRect.Min.Y + HalfHeight);
+
+	const VectorRegister4Float NoMin = VectorSetFloat1(UE_BIG_NUMBER);
+	const VectorRegister4Float NoMax = VectorSetFloat1(-UE_BIG_NUMBER);
+
+	for (int32 CandidateIndex = 0; CandidateIndex < NumCandidates; ++CandidateIndex)
+	{
+		VectorRegister4Float MinX = NoMin;
+		VectorRegister4Float MinY = NoMin;
+		VectorRegister4Float MaxX = NoMax;
+		VectorRegister4Float MaxY = NoMax;
+
+		const int32 FirstVertex = CandidateIndex * FAimAssistCandidateBatch::VerticesPerCandidate;
+		for (int32 VertexIndex = FirstVertex; VertexIndex < FirstVertex + FAimAssistCandidateBatch::VerticesPerCandidate; VertexIndex += 4)
+		{
+			const VectorRegister4Float X = VectorLoadAligned(&Batch.VertexX[VertexIndex]);
+			const VectorRegister4Float Y = VectorLoadAligned(&Batch.VertexY[VertexIndex]);
+			const VectorRegister4Float Z = VectorLoadAligned(&Batch.VertexZ[VertexIndex]);
+
+			const VectorRegister4Float ClipX = VectorMultiplyAdd(X, MatrixXX, VectorMultiplyAdd(Y, MatrixYX, VectorMultiplyAdd(Z, MatrixZX, MatrixWX)));
+			const VectorRegister4Float ClipY = VectorMultiplyAdd(X, MatrixXY, VectorMultiplyAdd(Y, MatrixYY, VectorMultiplyAdd(Z, MatrixZY, MatrixWY)));
+			const VectorRegister4Float ClipW = VectorMultiplyAdd(X, MatrixXW, VectorMultiplyAdd(Y, MatrixYW, VectorMultiplyAdd(Z, MatrixZW, MatrixWW)));
+
+			const VectorRegister4Float InFront = VectorCompareGT(ClipW, VectorZeroFloat());
+			const VectorRegister4Float SafeW = VectorSelect(InFront, ClipW, GlobalVectorConstants::FloatOne);
+
+			const VectorRegister4Float ScreenX = VectorMultiplyAdd(VectorDivide(ClipX, SafeW), ScreenScaleX, ScreenOffsetX);
+			const VectorRegister4Float ScreenY = VectorMultiplyAdd(VectorDivide(ClipY, SafeW), ScreenScaleY, ScreenOffsetY);
+
+			MinX = VectorMin(MinX, VectorSelect(InFront, ScreenX, NoMin));
+			MinY = VectorMin(MinY, VectorSelect(InFront, ScreenY, NoMin));
+			MaxX = VectorMax(MaxX, VectorSelect(InFront, ScreenX, NoMax));
+			MaxY = VectorMax(MaxY, VectorSelect(InFront, ScreenY, NoMax));
+		}
+
+		Batch.ScreenMinX[CandidateIndex] = VectorHorizontalMin(MinX);
+		Batch.ScreenMinY[CandidateIndex] = VectorHorizontalMin(MinY);
+		Batch.ScreenMaxX[CandidateIndex] = VectorHorizontalMax(MaxX);
+		Batch.ScreenMaxY[CandidateIndex] = VectorHorizontalMax(MaxY);
+	}
+
+	// Padding is empty so it never passes a reticle test
+	for (int32 CandidateIndex = NumCandidates; CandidateIndex < NumPaddedCandidates; ++CandidateIndex)
+	{
+		Batch.ScreenMinX[CandidateIndex] = UE_BIG_NUMBER;
+		Batch.ScreenMinY[CandidateIndex] = UE_BIG_NUMBER;
+		Batch.ScreenMaxX[CandidateIndex] = -UE_BIG_NUMBER;
+		Batch.ScreenMaxY[CandidateIndex] = -UE_BIG_NUMBER;
+	}
+}
+
+// Same test as FBox2D::Intersect for four screen bounds at once, returns one bit per bounds
+static int32 IntersectReticleMask(const VectorRegister4Float& MinX, const VectorRegister4Float& MinY, const VectorRegister4Float& MaxX, const VectorRegister4Float& MaxY, const FBox2D& Reticle)
+{
+	const VectorRegister4Float SeparatedX = VectorBitwiseOr(
+		VectorCompareGT(MinX, VectorSetFloat1((float)Reticle.Max.X)),
+		VectorCompareGT(VectorSetFloat1((float)Reticle.Min.X), MaxX));
+
+	const VectorRegister4Float SeparatedY = VectorBitwiseOr(
+		VectorCompareGT(MinY, VectorSetFloat1((float)Reticle.Max.Y)),
+		VectorCompareGT(VectorSetFloat1((float)Reticle.Min.Y), MaxY));
+
+	return ~VectorMaskBits(VectorBitwiseOr(SeparatedX, SeparatedY)) & 0xF;
+}
+
+static void TestCandidatesAgainstReticles(FAimAssistCandidateBatch& Batch, const FBox2D& TargetingReticleBounds, const FBox2D& AssistInnerReticleBounds, const FBox2D& AssistOuterReticleBounds)
+{
+	const int32 NumCandidates = Batch.Num();
+	Batch.ReticleFlags.SetNumUninitialized(NumCandidates, EAllowShrinking::No);
+
+	for (int32 FirstCandidate = 0; FirstCandidate < NumCandidates; FirstCandidate += 4)
+	{
+		const VectorRegister4Float MinX = VectorLoadAligned(&Batch.ScreenMinX[FirstCandidate]);
+		const VectorRegister4Float MinY = VectorLoadAligned(&Batch.ScreenMinY[FirstCandidate]);
+		const VectorRegister4Float MaxX = VectorLoadAligned(&Batch.ScreenMaxX[FirstCandidate]);
+		const VectorRegister4Float MaxY = VectorLoadAligned(&Batch.ScreenMaxY[FirstCandidate]);
+
+		const int32 TargetingMask = IntersectReticleMask(MinX, MinY, MaxX, MaxY, TargetingReticleBounds);
+		const int32 InnerMask = IntersectReticleMask(MinX, MinY, MaxX, MaxY, AssistInnerReticleBounds);
+		const int32 OuterMask = IntersectReticleMask(MinX, MinY, MaxX, MaxY, AssistOuterReticleBounds);
+
+		const int32 NumLanes = FMath::Min(NumCandidates - FirstCandidate, 4);
+		for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+		{
+			uint8 Flags = 0;
+			Flags |= ((TargetingMask >> Lane) & 1) ? FAimAssistCandidateBatch::UnderTargetingReticle : 0;
+			Flags |= ((InnerMask >> Lane) & 1) ? FAimAssistCandidateBatch::UnderAssistInnerReticle : 0;
+			Flags |= ((OuterMask >> Lane) & 1) ? FAimAssistCandidateBatch::UnderAssistOuterReticle : 0;
+			Batch.ReticleFlags[FirstCandidate + Lane] = Flags;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// FAimAssistCandidateBatch
+
+void FAimAssistCandidateBatch::Reset(const FVector& InVertexOrigin)
+{
+	VertexOrigin = InVertexOrigin;
+
+	TargetDataIndices.Reset();
+	Locations.Reset();
+	ViewDots.Reset();
+	ViewDistances.Reset();
+	ReticleFlags.Reset();
+
+	ScreenMinX.Reset();
+	ScreenMinY.Reset();
+	ScreenMaxX.Reset();
+	ScreenMaxY.Reset();
+
+	VertexX.Reset();
+	VertexY.Reset();
+	VertexZ.Reset();
+}
+
+void FAimAssistCandidateBatch::AddCandidate(int32 TargetDataIndex, const FVector& Location, float ViewDot, float ViewDistance, const FVector* Vertices, int32 NumVertices)
+{
+	check(NumVertices > 0 && NumVertices <= VerticesPerCandidate);
+
+	TargetDataIndices.Add(TargetDataIndex);
+	Locations.Add(Location);
+	ViewDots.Add(ViewDot);
+	ViewDistances.Add(ViewDistance);
+
+	for (int32 VertexIndex = 0; VertexIndex < VerticesPerCandidate; ++VertexIndex)
+	{
+		const FVector Vertex = Vertices[FMath::Min(VertexIndex, NumVertices - 1)] - VertexOrigin;
+		VertexX.Add((float)Vertex.X);
+		VertexY.Add((float)Vertex.Y);
+		VertexZ.Add((float)Vertex.Z);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// UAimAssistTargetManagerComponent
 
 void UAimAssistTargetManagerComponent::GetVisibleTargets(const FAimAssistFilter& Filter, const FAimAssistSettings& Settings, const FAimAssistOwnerViewData& OwnerData, const TArray<FLyraAimAssistTarget>& OldTargets, OUT TArray<FLyraAimAssistTarget>& OutNewTargets)
 {
@@ -107,7 +351,7 @@ void UAimAssistTargetManagerComponent::GetVisibleTargets(const FAimAssistFilter&
 	const FVector ViewLocation = OwnerData.ViewTransform.GetTranslation();
 	const FVector ViewForward = OwnerData.ViewTransform.GetUnitAxis(EAxis::X);
 
-	const float FOVScale = GetFOVScale(PC, ECommonInputType::Gamepad);
+	const float FOVScale = OwnerData.FOVScale;
 	const float InvFieldOfViewScale = (FOVScale > 0.0f) ? (1.0f / FOVScale) : 1.0f;
 	const float TargetRange = (Settings.TargetRange.GetValue() * InvFieldOfViewScale);
 
@@ -119,7 +363,6 @@ void UAimAssistTargetManagerComponent::GetVisibleTargets(const FAimAssistFilter&
 	const FBox2D AssistOuterReticleBounds = OwnerData.ProjectReticleToScreen(Settings.AssistOuterReticleWidth.GetValue(), Settings.AssistOuterReticleHeight.GetValue(), ReticleDepth);
 	const FBox2D TargetingReticleBounds = OwnerData.ProjectReticleToScreen(Settings.TargetingReticleWidth.GetValue(), Settings.TargetingReticleHeight.GetValue(), ReticleDepth);
 
-	static TArray<FOverlapResult> OverlapResults;
 	// Do a world trace on the Aim Assist channel to get any visible targets
 	{
 		UWorld* World = GetWorld();
@@ -144,7 +387,7 @@ void UAimAssistTargetManagerComponent::GetVisibleTargets(const FAimAssistFilter&
 	}
 
 	// Gather target options from any visibile hit results that implement the IAimAssistTarget interface
-	TArray<FAimAssistTargetOptions> NewTargetData;
+	NewTargetData.Reset();
 	{
 		for (const FOverlapResult& Overlap : OverlapResults)
 		{
@@ -166,12 +409,12 @@ void UAimAssistTargetManagerComponent::GetVisibleTargets(const FAimAssistFilter&
 		}
 	}
 	
-	// Gather targets that are in front of the player
+	// Gather targets that are in front of the player, along with the vertices of their shapes
+	CandidateBatch.Reset(ViewLocation);
 	{
-		const FVector PawnLocation = OwnerPawn->GetActorLocation();		
-		
-		for (FAimAssistTargetOptions& AimAssistTarget : NewTargetData)
+		for (int32 TargetDataIndex = 0; TargetDataIndex < NewTargetData.Num(); ++TargetDataIndex)
 		{
+			const FAimAssistTargetOptions& AimAssistTarget = NewTargetData[TargetDataIndex];
 			if (!DoesTargetPassFilter(OwnerData, Filter, AimAssistTarget, TargetRange))
 			{
 				continue;
@@ -199,43 +442,48 @@ void UAimAssistTargetManagerComponent::GetVisibleTargets(const FAimAssistFilter&
 			{
 				continue;
 			}
-			
-			const FLyraAimAssistTarget* OldTarget = FindTarget(OldTargets, AimAssistTarget.TargetShapeComponent.Get());
-
-			// Calculate the screen bounds for this target
-			FBox2D TargetScreenBounds(ForceInitToZero);
-			const bool bUpdateTargetProjections = true;
-			if (bUpdateTargetProjections)
-			{
-				TargetScreenBounds = OwnerData.ProjectShapeToScreen(TargetShape, TargetShapeOrigin, TargetTransform);
-			}
-			else
-			{
-				// Target projections are not being updated so use the values from the previous frame if the target existed.
-				if (OldTarget)
-				{
-					TargetScreenBounds = OldTarget->ScreenBounds;
-				}
-			}
 
-			if (!TargetScreenBounds.bIsValid)
+			FVector Vertices[FAimAssistCandidateBatch::VerticesPerCandidate];
+			const int32 NumVertices = GatherShapeVertices(OwnerData, TargetShape, TargetShapeOrigin, TargetTransform, Vertices);
+			if (NumVertices == 0)
 			{
 				continue;
 			}
 
-			if (!TargetingReticleBounds.Intersect(TargetScreenBounds))
+			CandidateBatch.AddCandidate(TargetDataIndex, TargetTransform.GetTranslation(), TargetViewDot, TargetViewDistance, Vertices, NumVertices);
+		}
+	}
+
+	// Calculate the screen bounds of all candidates and which reticles they are under
+	ProjectCandidatesToScreen(CandidateBatch, OwnerData);
+	TestCandidatesAgainstReticles(CandidateBatch, TargetingReticleBounds, AssistInnerReticleBounds, AssistOuterReticleBounds);
+
+	// Create targets for the candidates under the targeting reticle
+	{
+		for (int32 CandidateIndex = 0; CandidateIndex < CandidateBatch.Num(); ++CandidateIndex)
+		{
+			const uint8 ReticleFlags = CandidateBatch.ReticleFlags[CandidateIndex];
+			if ((ReticleFlags & FAimAssistCandidateBatch::UnderTargetingReticle) == 0)
 			{
 				continue;
 			}
 
+			const FAimAssistTargetOptions& AimAssistTarget = NewTargetData[CandidateBatch.TargetDataIndices[CandidateIndex]];
+			const FLyraAimAssistTarget* OldTarget = FindTarget(OldTargets, AimAssistTarget.TargetShapeComponent.Get());
+
+			const float TargetViewDot = CandidateBatch.ViewDots[CandidateIndex];
+			const float TargetViewDistance = CandidateBatch.ViewDistances[CandidateIndex];
+
 			FLyraAimAssistTarget NewTarget;
 
 			NewTarget.TargetShapeComponent = AimAssistTarget.TargetShapeComponent;
-			NewTarget.Location = TargetTransform.GetTranslation();
-			NewTarget.ScreenBounds = TargetScreenBounds;
+			NewTarget.Location = CandidateBatch.Locations[CandidateIndex];
+			NewTarget.ScreenBounds = FBox2D(
+				FVector2D(CandidateBatch.ScreenMinX[CandidateIndex], CandidateBatch.ScreenMinY[CandidateIndex]),
+				FVector2D(CandidateBatch.ScreenMaxX[CandidateIndex], CandidateBatch.ScreenMaxY[CandidateIndex]));
 			NewTarget.ViewDistance = TargetViewDistance;
-			NewTarget.bUnderAssistInnerReticle = AssistInnerReticleBounds.Intersect(TargetScreenBounds);
-			NewTarget.bUnderAssistOuterReticle = AssistOuterReticleBounds.Intersect(TargetScreenBounds);
+			NewTarget.bUnderAssistInnerReticle = (ReticleFlags & FAimAssistCandidateBatch::UnderAssistInnerReticle) != 0;
+			NewTarget.bUnderAssistOuterReticle = (ReticleFlags & FAimAssistCandidateBatch::UnderAssistOuterReticle) != 0;
 			
 			// Transfer target data from last frame.
 			if (OldTarget)
@@ -244,6 +492,7 @@ void UAimAssistTargetManagerComponent::GetVisibleTargets(const FAimAssistFilter&
 				NewTarget.AssistTime = OldTarget->AssistTime;
 				NewTarget.AssistWeight = OldTarget->AssistWeight;
 				NewTarget.VisibilityTraceHandle = OldTarget->VisibilityTraceHandle;
+				NewTarget.bIsVisible = OldTarget->bIsVisible;
 			}
 
 			// Calculate a score used for sorting based on previous weight, distance from target, and distance from reticle.
@@ -269,6 +518,11 @@ void UAimAssistTargetManagerComponent::GetVisibleTargets(const FAimAssistFilter&
 	}
 
 	// Do visibliity traces on the targets
+	if (Settings.bBatchVisibilityTraces)
+	{
+		UpdateTargetVisibilityBatched(OutNewTargets, Filter, OwnerData);
+	}
+	else
 	{
 		for (FLyraAimAssistTarget& Target : OutNewTargets)
 		{
@@ -444,6 +698,63 @@ void UAimAssistTargetManagerComponent::DetermineTargetVisibility(FLyraAimAssistT
 	}
 }
 
+void UAimAssistTargetManagerComponent::UpdateTargetVisibilityBatched(TArray<FLyraAimAssistTarget>& Targets, const FAimAssistFilter& Filter, const FAimAssistOwnerViewData& OwnerData)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UAimAssistTargetManagerComponent::UpdateTargetVisibilityBatched);
+
+	UWorld* World = GetWorld();
+	check(World);
+
+	// Consume the results of the traces started last frame. The async trace buffer is double buffered, so every
+	// result lands exactly one frame after its trace was started no matter how many targets there are.
+	for (FLyraAimAssistTarget& Target : Targets)
+	{
+		if (Target.VisibilityTraceHandle.IsValid())
+		{
+			FTraceDatum TraceDatum;
+			if (World->QueryTraceData(Target.VisibilityTraceHandle, TraceDatum))
+			{
+				Target.bIsVisible = (FHitResult::GetFirstBlockingHit(TraceDatum.OutHits) == nullptr);
+			}
+
+			// Otherwise the trace is too old (aim assist didn't update last frame), keep the last known visibility until the next result
+			Target.VisibilityTraceHandle = FTraceHandle();
+		}
+	}
+
+	// Start the traces for every target together, they run on worker threads while the rest of the frame happens
+	const FVector ViewLocation = OwnerData.ViewTransform.GetTranslation();
+
+	const UShooterCoreRuntimeSettings* ShooterSettings = GetDefault<UShooterCoreRuntimeSettings>();
+	const ECollisionChannel AimAssistChannel = ShooterSettings->GetAimAssistCollisionChannel();
+
+	FCollisionResponseParams ResponseParams;
+	ResponseParams.CollisionResponse.SetResponse(ECC_Pawn, ECR_Ignore);
+	ResponseParams.CollisionResponse.SetResponse(AimAssistChannel, ECR_Ignore);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(AimAssist_DetermineTargetVisibility), true);
+
+	for (FLyraAimAssistTarget& Target : Targets)
+	{
+		const AActor* Actor = Target.TargetShapeComponent->GetOwner();
+		if (!Actor)
+		{
+			ensure(false);
+			continue;
+		}
+
+		FVector TargetEyeLocation;
+		FRotator TargetEyeRotation;
+		Actor->GetActorEyesViewPoint(TargetEyeLocation, TargetEyeRotation);
+
+		QueryParams.ClearIgnoredActors();
+		InitTargetSelectionCollisionParams(QueryParams, *Actor, Filter);
+		QueryParams.AddIgnoredActor(Actor);
+
+		Target.VisibilityTraceHandle = World->AsyncLineTraceByChannel(EAsyncTraceType::Test, ViewLocation, TargetEyeLocation, ECC_Visibility, QueryParams, ResponseParams);
+	}
+}
+
 void UAimAssistTargetManagerComponent::InitTargetSelectionCollisionParams(FCollisionQueryParams& OutParams, const AActor& RequestedBy, const FAimAssistFilter& Filter) const
 {
 	// Exclude Requester
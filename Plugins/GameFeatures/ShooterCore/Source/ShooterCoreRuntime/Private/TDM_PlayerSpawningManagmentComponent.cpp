@@ -3,6 +3,8 @@
 #include "TDM_PlayerSpawningManagmentComponent.h"
 
 #include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/Pawn.h"
 #include "GameFramework/PlayerState.h"
 #include "GameModes/LyraGameState.h"
 #include "Player/LyraPlayerStart.h"
@@ -33,46 +35,158 @@ AActor* UTDM_PlayerSpawningManagmentComponent::OnChoosePlayerStart(AController*
 		return nullptr;
 	}
 
-	ALyraGameState* GameState = GetGameStateChecked<ALyraGameState>();
+	UpdateSnapshot();
+
+	// Without anyone to get away from, let the default random selection happen
+	if (!HasEnemies(PlayerTeamId))
+	{
+		return nullptr;
+	}
 
 	ALyraPlayerStart* BestPlayerStart = nullptr;
-	double MaxDistance = 0;
+	double BestScore = 0;
 	ALyraPlayerStart* FallbackPlayerStart = nullptr;
-	double FallbackMaxDistance = 0;
+	double FallbackBestScore = 0;
+
+	for (ALyraPlayerStart* PlayerStart : PlayerStarts)
+	{
+		const double Score = GetPlayerStartScore(PlayerStart, PlayerTeamId);
+
+		if (PlayerStart->IsClaimed())
+		{
+			if (FallbackPlayerStart == nullptr || Score > FallbackBestScore)
+			{
+				FallbackPlayerStart = PlayerStart;
+				FallbackBestScore = Score;
+			}
+		}
+		else if (BestPlayerStart == nullptr || Score > BestScore)
+		{
+			// Only do the occupancy check for starts that would be better than what we have
+			if (GetPlayerStartOccupancy(PlayerStart, Player) < ELyraPlayerStartLocationOccupancy::Full)
+			{
+				BestPlayerStart = PlayerStart;
+				BestScore = Score;
+			}
+		}
+	}
+
+	if (BestPlayerStart)
+	{
+		return BestPlayerStart;
+	}
+
+	return FallbackPlayerStart;
+}
+
+void UTDM_PlayerSpawningManagmentComponent::UpdateSnapshot()
+{
+	if (Snapshot.Frame == GFrameCounter)
+	{
+		return;
+	}
+
+	Snapshot.Frame = GFrameCounter;
+	Snapshot.PawnLocations.Reset();
+	Snapshot.PawnTeamIds.Reset();
+	Snapshot.PawnGrid.Reset();
+	Snapshot.StartOccupancy.Reset();
+	Snapshot.StartScores.Reset();
+
+	ULyraTeamSubsystem* TeamSubsystem = GetWorld()->GetSubsystem<ULyraTeamSubsystem>();
+	ALyraGameState* GameState = GetGameStateChecked<ALyraGameState>();
 
 	for (APlayerState* PS : GameState->PlayerArray)
 	{
 		const int32 TeamId = TeamSubsystem->FindTeamFromObject(PS);
-		
+
 		// We should have a TeamId by now...
 		if (PS->IsOnlyASpectator() || !ensure(TeamId != INDEX_NONE))
 		{
 			continue;
 		}
 
-		// If the other player isn't on the same team, lets find the furthest spawn from them.
-		if (TeamId != PlayerTeamId)
+		if (APawn* Pawn = PS->GetPawn())
 		{
-			for (ALyraPlayerStart* PlayerStart : PlayerStarts)
+			const FVector Location = Pawn->GetActorLocation();
+			const FIntPoint Cell = GetGridCell(Location);
+
+			if (Snapshot.PawnLocations.Num() == 0)
 			{
-				if (APawn* Pawn = PS->GetPawn())
-				{
-					const double Distance = PlayerStart->GetDistanceTo(Pawn);
+				Snapshot.MinCell = Cell;
+				Snapshot.MaxCell = Cell;
+			}
+			else
+			{
+				Snapshot.MinCell = Snapshot.MinCell.ComponentMin(Cell);
+				Snapshot.MaxCell = Snapshot.MaxCell.ComponentMax(Cell);
+			}
 
-					if (PlayerStart->IsClaimed())
-					{
-						if (FallbackPlayerStart == nullptr || Distance > FallbackMaxDistance)
-						{
-							FallbackPlayerStart = PlayerStart;
-							FallbackMaxDistance = Distance;
-						}
-					}
-					else if (PlayerStart->GetLocationOccupancy(Player) < ELyraPlayerStartLocationOccupancy::Full)
+			Snapshot.PawnGrid.FindOrAdd(Cell).Add(Snapshot.PawnLocations.Num());
+			Snapshot.PawnLocations.Add(Location);
+			Snapshot.PawnTeamIds.Add(TeamId);
+		}
+	}
+}
+
+FIntPoint UTDM_PlayerSpawningManagmentComponent::GetGridCell(const FVector& Location) const
+{
+	const double CellSize = FMath::Max(EnemyGridCellSize, 100.0f);
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+bool UTDM_PlayerSpawningManagmentComponent::HasEnemies(int32 TeamId) const
+{
+	return Snapshot.PawnTeamIds.ContainsByPredicate([TeamId](int32 PawnTeamId) { return PawnTeamId != TeamId; });
+}
+
+double UTDM_PlayerSpawningManagmentComponent::GetPlayerStartScore(const ALyraPlayerStart* PlayerStart, int32 TeamId)
+{
+	const TPair<TObjectKey<ALyraPlayerStart>, int32> Key(PlayerStart, TeamId);
+	if (const double* pScore = Snapshot.StartScores.Find(Key))
+	{
+		return *pScore;
+	}
+
+	const FVector Location = PlayerStart->GetActorLocation();
+	const double Score = (ScoringMetric == ETDMSpawnScoringMetric::FurthestFromNearestEnemy) ? FindNearestEnemyDistance(Location, TeamId) : FindFurthestEnemyDistance(Location, TeamId);
+
+	Snapshot.StartScores.Add(Key, Score);
+	return Score;
+}
+
+double UTDM_PlayerSpawningManagmentComponent::FindNearestEnemyDistance(const FVector& Location, int32 TeamId) const
+{
+	const double CellSize = FMath::Max(EnemyGridCellSize, 100.0f);
+	const FIntPoint Cell = GetGridCell(Location);
+
+	const FIntPoint ToMin = Cell - Snapshot.MinCell;
+	const FIntPoint ToMax = Snapshot.MaxCell - Cell;
+	const int32 MaxRing = FMath::Max(FMath::Max(FMath::Abs(ToMin.X), FMath::Abs(ToMin.Y)), FMath::Max(FMath::Abs(ToMax.X), FMath::Abs(ToMax.Y)));
+
+	// Search rings of cells around the start, until the next ring can't have anyone closer than what we found
+	double NearestDistanceSquared = TNumericLimits<double>::Max();
+	for (int32 Ring = 0; Ring <= MaxRing; ++Ring)
+	{
+		const double RingMinDistance = FMath::Max(Ring - 1, 0) * CellSize;
+		if (NearestDistanceSquared <= FMath::Square(RingMinDistance))
+		{
+			break;
+		}
+
+		for (int32 Y = Cell.Y - Ring; Y <= Cell.Y + Ring; ++Y)
+		{
+			// Only the top and bottom rows of the ring are full, the other rows only have their first and last cell
+			const int32 XStep = (FMath::Abs(Y - Cell.Y) == Ring) ? 1 : (2 * Ring);
+			for (int32 X = Cell.X - Ring; X <= Cell.X + Ring; X += XStep)
+			{
+				if (const TArray<int32>* pPawnIndices = Snapshot.PawnGrid.Find(FIntPoint(X, Y)))
+				{
+					for (int32 PawnIndex : *pPawnIndices)
 					{
-						if (BestPlayerStart == nullptr || Distance > MaxDistance)
+						if (Snapshot.PawnTeamIds[PawnIndex] != TeamId)
 						{
-							BestPlayerStart = PlayerStart;
-							MaxDistance = Distance;
+							NearestDistanceSquared = FMath::Min(NearestDistanceSquared, FVector::DistSquared(Location, Snapshot.PawnLocations[PawnIndex]));
 						}
 					}
 				}
@@ -80,12 +194,41 @@ AActor* UTDM_PlayerSpawningManagmentComponent::OnChoosePlayerStart(AController*
 		}
 	}
 
-	if (BestPlayerStart)
+	return FMath::Sqrt(NearestDistanceSquared);
+}
+
+double UTDM_PlayerSpawningManagmentComponent::FindFurthestEnemyDistance(const FVector& Location, int32 TeamId) const
+{
+	double FurthestDistanceSquared = 0;
+	for (int32 PawnIndex = 0; PawnIndex < Snapshot.PawnLocations.Num(); ++PawnIndex)
 	{
-		return BestPlayerStart;
+		if (Snapshot.PawnTeamIds[PawnIndex] != TeamId)
+		{
+			FurthestDistanceSquared = FMath::Max(FurthestDistanceSquared, FVector::DistSquared(Location, Snapshot.PawnLocations[PawnIndex]));
+		}
 	}
 
-	return FallbackPlayerStart;
+	return FMath::Sqrt(FurthestDistanceSquared);
+}
+
+ELyraPlayerStartLocationOccupancy UTDM_PlayerSpawningManagmentComponent::GetPlayerStartOccupancy(ALyraPlayerStart* PlayerStart, AController* Player)
+{
+	// The occupancy depends on the size of the pawn that will spawn, which comes from its class
+	UClass* PawnClass = nullptr;
+	if (AGameModeBase* GameMode = GetWorld()->GetAuthGameMode())
+	{
+		PawnClass = GameMode->GetDefaultPawnClassForController(Player);
+	}
+
+	const TPair<TObjectKey<ALyraPlayerStart>, TObjectKey<UClass>> Key(PlayerStart, PawnClass);
+	if (const ELyraPlayerStartLocationOccupancy* pOccupancy = Snapshot.StartOccupancy.Find(Key))
+	{
+		return *pOccupancy;
+	}
+
+	const ELyraPlayerStartLocationOccupancy Occupancy = PlayerStart->GetLocationOccupancy(Player);
+	Snapshot.StartOccupancy.Add(Key, Occupancy);
+	return Occupancy;
 }
 
 void UTDM_PlayerSpawningManagmentComponent::OnFinishRestartPlayer(AController* Player, const FRotator& StartRotation)
@@ -3,6 +3,8 @@
 #pragma once
 
 #include "Player/LyraPlayerSpawningManagerComponent.h"
+#include "Player/LyraPlayerStart.h"
+#include "UObject/ObjectKey.h"
 
 #include "TDM_PlayerSpawningManagmentComponent.generated.h"
 
@@ -11,8 +13,22 @@ class AController;
 class ALyraPlayerStart;
 class UObject;
 
+/** How player starts are scored against the positions of the enemy pawns */
+UENUM()
+enum class ETDMSpawnScoringMetric : uint8
+{
+	// Pick the start whose nearest enemy is the furthest away
+	FurthestFromNearestEnemy,
+
+	// Pick the start that is the furthest away from any single enemy
+	FurthestFromAnyEnemy
+};
+
 /**
- * 
+ * Spawns players at the player start furthest away from their enemies.
+ *
+ * All the spawn requests of a frame (e.g. a whole team respawning at round start) share one snapshot of the enemy
+ * pawns, sorted into a grid, and one occupancy check per player start.
  */
 UCLASS()
 class UTDM_PlayerSpawningManagmentComponent : public ULyraPlayerSpawningManagerComponent
@@ -28,4 +44,48 @@ public:
 
 protected:
 
+	UPROPERTY(EditDefaultsOnly, Category = "Spawning")
+	ETDMSpawnScoringMetric ScoringMetric = ETDMSpawnScoringMetric::FurthestFromNearestEnemy;
+
+	/** Size (in cm) of the grid cells the enemy pawns are sorted into to find the nearest one to a player start */
+	UPROPERTY(EditDefaultsOnly, Category = "Spawning", meta = (ClampMin = 100.0, Units = "cm"))
+	float EnemyGridCellSize = 2500.0f;
+
+private:
+
+	// Everything spawn requests need to know about the world, built by the first request of a frame
+	struct FSpawnScoringSnapshot
+	{
+		uint64 Frame = 0;
+
+		TArray<FVector> PawnLocations;
+		TArray<int32> PawnTeamIds;
+
+		// Indices of the pawns in every occupied cell, and the range of occupied cells
+		TMap<FIntPoint, TArray<int32>> PawnGrid;
+		FIntPoint MinCell = FIntPoint::ZeroValue;
+		FIntPoint MaxCell = FIntPoint::ZeroValue;
+
+		// Occupancy by player start and pawn class
+		TMap<TPair<TObjectKey<ALyraPlayerStart>, TObjectKey<UClass>>, ELyraPlayerStartLocationOccupancy> StartOccupancy;
+
+		// Scores by player start and the team of the player spawning there
+		TMap<TPair<TObjectKey<ALyraPlayerStart>, int32>, double> StartScores;
+	};
+
+	void UpdateSnapshot();
+
+	FIntPoint GetGridCell(const FVector& Location) const;
+
+	bool HasEnemies(int32 TeamId) const;
+
+	// Returns the score of the player start for a player of the team, higher is better
+	double GetPlayerStartScore(const ALyraPlayerStart* PlayerStart, int32 TeamId);
+
+	double FindNearestEnemyDistance(const FVector& Location, int32 TeamId) const;
+	double FindFurthestEnemyDistance(const FVector& Location, int32 TeamId) const;
+
+	ELyraPlayerStartLocationOccupancy GetPlayerStartOccupancy(ALyraPlayerStart* PlayerStart, AController* Player);
+
+	FSpawnScoringSnapshot Snapshot;
 };
@@ -57,6 +57,9 @@ struct FAimAssistOwnerViewData
 	FTransform ViewTransform = FTransform::Identity;
 	
 	FVector ViewForward = FVector::ZeroVector;
+
+	/** Field of view scale for gamepad input (see UAimAssistTargetManagerComponent::GetFOVScale), updated with the view */
+	float FOVScale = 1.0f;
 	
 	// Player transform is the actor's location and the controller's rotation.
 	FTransform PlayerTransform = FTransform::Identity;
@@ -294,6 +297,13 @@ struct FAimAssistSettings
 	UPROPERTY(EditAnywhere)
 	uint8 bEnableAsyncVisibilityTrace : 1;
 
+	/**
+	 * If true, every target gets an asynchronous visibility trace each frame and uses the result of the trace started the frame before,
+	 * instead of a synchronous trace whenever a target isn't known to be visible. New targets are considered hidden until their first result.
+	 */
+	UPROPERTY(EditAnywhere)
+	uint8 bBatchVisibilityTraces : 1;
+
 	/** Whether or not we require input for aim assist to be applied */
 	UPROPERTY(EditAnywhere)
 	uint8 bRequireInput : 1;
@@ -3,6 +3,8 @@
 #pragma once
 
 #include "Components/GameStateComponent.h"
+#include "Engine/OverlapResult.h"
+#include "Input/IAimAssistTargetInterface.h"
 
 #include "AimAssistTargetManagerComponent.generated.h"
 
@@ -13,10 +15,51 @@ class UObject;
 struct FAimAssistFilter;
 struct FAimAssistOwnerViewData;
 struct FAimAssistSettings;
-struct FAimAssistTargetOptions;
 struct FCollisionQueryParams;
 struct FLyraAimAssistTarget;
 
+/**
+ * The candidate targets of one GetVisibleTargets call, stored as a structure of arrays so that
+ * their screen projections and reticle tests can be done four at a time with vector math.
+ */
+struct FAimAssistCandidateBatch
+{
+	// Every candidate has the same number of vertices, shapes with fewer repeat their last one
+	static constexpr int32 VerticesPerCandidate = 8;
+
+	enum EReticleFlags : uint8
+	{
+		UnderTargetingReticle	= 1 << 0,
+		UnderAssistInnerReticle	= 1 << 1,
+		UnderAssistOuterReticle	= 1 << 2,
+	};
+
+	void Reset(const FVector& InVertexOrigin);
+	void AddCandidate(int32 TargetDataIndex, const FVector& Location, float ViewDot, float ViewDistance, const FVector* Vertices, int32 NumVertices);
+	int32 Num() const { return TargetDataIndices.Num(); }
+
+	// Vertices are stored relative to this location so they stay precise as floats
+	FVector VertexOrigin = FVector::ZeroVector;
+
+	// Per candidate
+	TArray<int32> TargetDataIndices;
+	TArray<FVector> Locations;
+	TArray<float> ViewDots;
+	TArray<float> ViewDistances;
+	TArray<uint8> ReticleFlags;
+
+	// Per candidate screen bounds, padded to a multiple of four candidates. Empty bounds have Min > Max.
+	TArray<float, TAlignedHeapAllocator<16>> ScreenMinX;
+	TArray<float, TAlignedHeapAllocator<16>> ScreenMinY;
+	TArray<float, TAlignedHeapAllocator<16>> ScreenMaxX;
+	TArray<float, TAlignedHeapAllocator<16>> ScreenMaxY;
+
+	// Per vertex, VerticesPerCandidate for every candidate
+	TArray<float, TAlignedHeapAllocator<16>> VertexX;
+	TArray<float, TAlignedHeapAllocator<16>> VertexY;
+	TArray<float, TAlignedHeapAllocator<16>> VertexZ;
+};
+
 /**
  * The Aim Assist Target Manager Component is used to gather all aim assist targets that are within
  * a given player's view. Targets must implement the IAimAssistTargetInterface and be on the
@@ -48,7 +91,19 @@ protected:
 
 	/** Determine if the given target is visible based on our current view data. */
 	void DetermineTargetVisibility(FLyraAimAssistTarget& Target, const FAimAssistSettings& Settings, const FAimAssistFilter& Filter, const FAimAssistOwnerViewData& OwnerData);
+
+	/**
+	 * Updates the visibility of all targets from the asynchronous traces started last frame, then starts the traces for all of them again.
+	 * Used instead of DetermineTargetVisibility when FAimAssistSettings::bBatchVisibilityTraces is set.
+	 */
+	void UpdateTargetVisibilityBatched(TArray<FLyraAimAssistTarget>& Targets, const FAimAssistFilter& Filter, const FAimAssistOwnerViewData& OwnerData);
 	
 	/** Setup CollisionQueryParams to ignore a set of actors based on filter settings. Such as Ignoring Requester or Instigator. */
 	void InitTargetSelectionCollisionParams(FCollisionQueryParams& OutParams, const AActor& RequestedBy, const FAimAssistFilter& Filter) const;
+
+private:
+	// Scratch space for GetVisibleTargets, reused between calls (every local player calls it from the game thread)
+	TArray<FOverlapResult> OverlapResults;
+	TArray<FAimAssistTargetOptions> NewTargetData;
+	FAimAssistCandidateBatch CandidateBatch;
 };
@@ -11,6 +11,13 @@
 
 DEFINE_LOG_CATEGORY(LogGameplayMessageSubsystem);
 
+DECLARE_CYCLE_STAT(TEXT("Broadcast Message"), STAT_GameplayMessageBroadcast, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Gameplay Messages Broadcast"), STAT_GameplayMessagesBroadcast, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Gameplay Message Listeners Called"), STAT_GameplayMessageListenersCalled, STATGROUP_Game);
+DECLARE_CYCLE_STAT(TEXT("Flush Deferred Messages"), STAT_GameplayMessageFlushDeferred, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Gameplay Messages Deferred"), STAT_GameplayMessagesDeferred, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Gameplay Messages Coalesced"), STAT_GameplayMessagesCoalesced, STATGROUP_Game);
+
 namespace UE
 {
 	namespace GameplayMessageSubsystem
@@ -55,13 +62,60 @@ bool UGameplayMessageSubsystem::HasInstance(const UObject* WorldContextObject)
 	return Router != nullptr;
 }
 
+void UGameplayMessageSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &ThisClass::HandleWorldPostActorTick);
+}
+
 void UGameplayMessageSubsystem::Deinitialize()
 {
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	PostActorTickHandle.Reset();
+
+	// Undelivered messages are dropped, but their payloads still need to be destroyed
+	for (FDeferredMessageQueue& Queue : DeferredMessageQueues)
+	{
+		for (const FQueuedMessage& Message : Queue.Messages)
+		{
+			const UScriptStruct* StructType = Message.StructType.Get();
+			if ((StructType != nullptr) && (Message.PayloadOffset != INDEX_NONE))
+			{
+				StructType->DestroyStruct(Queue.PayloadArena.GetData() + Message.PayloadOffset);
+			}
+		}
+		Queue.Messages.Empty();
+		Queue.PayloadArena.Empty();
+		Queue.CoalescedMessageIndices.Empty();
+	}
+
 	ListenerMap.Reset();
+	DispatchListCache.Reset();
+	ChannelDeliverySettings.Reset();
 
 	Super::Deinitialize();
 }
 
+void UGameplayMessageSubsystem::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	Super::AddReferencedObjects(InThis, Collector);
+
+	// Queued payloads live in raw arenas the GC can't see, report the objects they reference so they stay alive until delivered
+	UGameplayMessageSubsystem* This = CastChecked<UGameplayMessageSubsystem>(InThis);
+	for (FDeferredMessageQueue& Queue : This->DeferredMessageQueues)
+	{
+		for (const FQueuedMessage& Message : Queue.Messages)
+		{
+			const UScriptStruct* StructType = Message.StructType.Get();
+			if ((StructType != nullptr) && (Message.PayloadOffset != INDEX_NONE))
+			{
+				Collector.AddPropertyReferences(StructType, Queue.PayloadArena.GetData() + Message.PayloadOffset, This);
+			}
+		}
+	}
+}
+
 void UGameplayMessageSubsystem::BroadcastMessageInternal(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes)
 {
 	// Log the message if enabled
@@ -81,44 +135,230 @@ void UGameplayMessageSubsystem::BroadcastMessageInternal(FGameplayTag Channel, c
 		UE_LOG(LogGameplayMessageSubsystem, Log, TEXT("BroadcastMessage(%s, %s, %s)"), pContextString ? **pContextString : *GetPathNameSafe(this), *Channel.ToString(), *HumanReadableMessage);
 	}
 
+	SCOPE_CYCLE_COUNTER(STAT_GameplayMessageBroadcast);
+	INC_DWORD_STAT(STAT_GameplayMessagesBroadcast);
+
 	// Broadcast the message
+	// Holding on to the dispatch list keeps it (and its listeners) alive in case there are changes while handling callbacks
+	const FChannelDispatchListPtr DispatchList = GetDispatchList(Channel);
+	if (!DispatchList.IsValid())
+	{
+		return;
+	}
+
+	if (DispatchList->DeferredListeners.Num() > 0)
+	{
+		QueueDeferredMessage(Channel, StructType, MessageBytes, DispatchList);
+	}
+
+	DeliverMessage(Channel, StructType, MessageBytes, DispatchList->Listeners);
+}
+
+void UGameplayMessageSubsystem::DeliverMessage(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes, TConstArrayView<FListenerDataRef> Listeners)
+{
+	INC_DWORD_STAT_BY(STAT_GameplayMessageListenersCalled, Listeners.Num());
+
+	for (const FListenerDataRef& ListenerRef : Listeners)
+	{
+		const FGameplayMessageListenerData& Listener = *ListenerRef;
+		if (Listener.bUnregistered)
+		{
+			continue;
+		}
+
+		if (Listener.bHadValidType && !Listener.ListenerStructType.IsValid())
+		{
+			UE_LOG(LogGameplayMessageSubsystem, Warning, TEXT("Listener struct type has gone invalid on Channel %s. Removing listener from list"), *Channel.ToString());
+			UnregisterListenerInternal(Listener.Channel, Listener.HandleID);
+			continue;
+		}
+
+		// The receiving type must be either a parent of the sending type or completely ambiguous (for internal use)
+		if (!Listener.bHadValidType || StructType->IsChildOf(Listener.ListenerStructType.Get()))
+		{
+			Listener.ReceivedCallback(Channel, StructType, MessageBytes);
+		}
+		else
+		{
+			UE_LOG(LogGameplayMessageSubsystem, Error, TEXT("Struct type mismatch on channel %s (broadcast type %s, listener at %s was expecting type %s)"),
+				*Channel.ToString(),
+				*StructType->GetPathName(),
+				*Listener.Channel.ToString(),
+				*Listener.ListenerStructType->GetPathName());
+		}
+	}
+}
+
+UGameplayMessageSubsystem::FChannelDispatchListPtr UGameplayMessageSubsystem::GetDispatchList(FGameplayTag Channel)
+{
+	if (const FChannelDispatchListPtr* pCachedList = DispatchListCache.Find(Channel))
+	{
+		return *pCachedList;
+	}
+
+	// Flatten the listeners of the channel and its parents, in the order they would be found walking up the tag hierarchy
+	TSharedRef<FChannelDispatchList, ESPMode::NotThreadSafe> NewList = MakeShared<FChannelDispatchList, ESPMode::NotThreadSafe>();
+
+	// The delivery setting of the channel comes from the closest tag that has one
+	const FChannelDeliverySettings* pDeliverySettings = nullptr;
+	for (FGameplayTag Tag = Channel; Tag.IsValid() && (pDeliverySettings == nullptr); Tag = Tag.RequestDirectParent())
+	{
+		pDeliverySettings = ChannelDeliverySettings.Find(Tag);
+	}
+
+	const bool bDeferChannel = (pDeliverySettings != nullptr) && (pDeliverySettings->Delivery == EGameplayMessageDelivery::Deferred);
+	NewList->bCoalesce = (pDeliverySettings != nullptr) && pDeliverySettings->bCoalesce;
+
 	bool bOnInitialTag = true;
 	for (FGameplayTag Tag = Channel; Tag.IsValid(); Tag = Tag.RequestDirectParent())
 	{
 		if (const FChannelListenerList* pList = ListenerMap.Find(Tag))
 		{
-			// Copy in case there are removals while handling callbacks
-			TArray<FGameplayMessageListenerData> ListenerArray(pList->Listeners);
-
-			for (const FGameplayMessageListenerData& Listener : ListenerArray)
+			for (const FListenerDataRef& Listener : pList->Listeners)
 			{
-				if (bOnInitialTag || (Listener.MatchType == EGameplayMessageMatch::PartialMatch))
+				if (bOnInitialTag || (Listener->MatchType == EGameplayMessageMatch::PartialMatch))
 				{
-					if (Listener.bHadValidType && !Listener.ListenerStructType.IsValid())
+					if (bDeferChannel || (Listener->Delivery == EGameplayMessageDelivery::Deferred))
 					{
-						UE_LOG(LogGameplayMessageSubsystem, Warning, TEXT("Listener struct type has gone invalid on Channel %s. Removing listener from list"), *Channel.ToString());
-						UnregisterListenerInternal(Channel, Listener.HandleID);
-						continue;
-					}
-
-					// The receiving type must be either a parent of the sending type or completely ambiguous (for internal use)
-					if (!Listener.bHadValidType || StructType->IsChildOf(Listener.ListenerStructType.Get()))
-					{
-						Listener.ReceivedCallback(Channel, StructType, MessageBytes);
+						NewList->DeferredListeners.Add(Listener);
 					}
 					else
 					{
-						UE_LOG(LogGameplayMessageSubsystem, Error, TEXT("Struct type mismatch on channel %s (broadcast type %s, listener at %s was expecting type %s)"),
-							*Channel.ToString(),
-							*StructType->GetPathName(),
-							*Tag.ToString(),
-							*Listener.ListenerStructType->GetPathName());
+						NewList->Listeners.Add(Listener);
 					}
 				}
 			}
 		}
 		bOnInitialTag = false;
 	}
+
+	// Channels nobody listens to are cached as null, so they cost a single lookup too
+	FChannelDispatchListPtr Result;
+	if ((NewList->Listeners.Num() > 0) || (NewList->DeferredListeners.Num() > 0))
+	{
+		Result = NewList;
+	}
+
+	DispatchListCache.Add(Channel, Result);
+	return Result;
+}
+
+void UGameplayMessageSubsystem::QueueDeferredMessage(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes, const FChannelDispatchListPtr& DispatchList)
+{
+	FDeferredMessageQueue& Queue = DeferredMessageQueues[WritingQueueIndex];
+
+	const int32 Alignment = FMath::Max(StructType->GetMinAlignment(), 1);
+	if (!ensureMsgf(Alignment <= 16, TEXT("Message type %s on channel %s is aligned to %d bytes and can't be deferred"), *StructType->GetName(), *Channel.ToString(), Alignment))
+	{
+		return;
+	}
+
+	// Replace the payload of the message already queued on this channel if we can
+	int32* pCoalescedIndex = nullptr;
+	if (DispatchList->bCoalesce)
+	{
+		pCoalescedIndex = &Queue.CoalescedMessageIndices.FindOrAdd(Channel, INDEX_NONE);
+		if (*pCoalescedIndex != INDEX_NONE)
+		{
+			FQueuedMessage& PreviousMessage = Queue.Messages[*pCoalescedIndex];
+			const UScriptStruct* PreviousStructType = PreviousMessage.StructType.Get();
+
+			INC_DWORD_STAT(STAT_GameplayMessagesCoalesced);
+
+			if (PreviousStructType == StructType)
+			{
+				StructType->CopyScriptStruct(Queue.PayloadArena.GetData() + PreviousMessage.PayloadOffset, MessageBytes);
+				PreviousMessage.DispatchList = DispatchList;
+				return;
+			}
+
+			// A different type was broadcast on the channel, drop the previous message and queue this one in order
+			if (PreviousStructType != nullptr)
+			{
+				PreviousStructType->DestroyStruct(Queue.PayloadArena.GetData() + PreviousMessage.PayloadOffset);
+			}
+			PreviousMessage.PayloadOffset = INDEX_NONE;
+			PreviousMessage.DispatchList.Reset();
+		}
+	}
+
+	INC_DWORD_STAT(STAT_GameplayMessagesDeferred);
+
+	const int32 PayloadOffset = Align(Queue.PayloadArena.Num(), Alignment);
+	Queue.PayloadArena.SetNumUninitialized(PayloadOffset + FMath::Max(StructType->GetStructureSize(), 1), EAllowShrinking::No);
+
+	uint8* Payload = Queue.PayloadArena.GetData() + PayloadOffset;
+	StructType->InitializeStruct(Payload);
+	StructType->CopyScriptStruct(Payload, MessageBytes);
+
+	const int32 MessageIndex = Queue.Messages.AddDefaulted();
+	FQueuedMessage& Message = Queue.Messages[MessageIndex];
+	Message.Channel = Channel;
+	Message.StructType = StructType;
+	Message.PayloadOffset = PayloadOffset;
+	Message.DispatchList = DispatchList;
+
+	if (pCoalescedIndex != nullptr)
+	{
+		*pCoalescedIndex = MessageIndex;
+	}
+}
+
+void UGameplayMessageSubsystem::FlushDeferredMessages()
+{
+	if (bIsFlushingDeferredMessages)
+	{
+		return;
+	}
+
+	FDeferredMessageQueue& Queue = DeferredMessageQueues[WritingQueueIndex];
+	if (Queue.Messages.Num() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_GameplayMessageFlushDeferred);
+
+	// Messages broadcast by the listeners go into the other queue, so the arena we are reading from never moves
+	TGuardValue<bool> FlushGuard(bIsFlushingDeferredMessages, true);
+	WritingQueueIndex = 1 - WritingQueueIndex;
+
+	for (FQueuedMessage& Message : Queue.Messages)
+	{
+		const UScriptStruct* StructType = Message.StructType.Get();
+		if ((StructType == nullptr) || (Message.PayloadOffset == INDEX_NONE))
+		{
+			continue;
+		}
+
+		void* Payload = Queue.PayloadArena.GetData() + Message.PayloadOffset;
+		DeliverMessage(Message.Channel, StructType, Payload, Message.DispatchList->DeferredListeners);
+
+		StructType->DestroyStruct(Payload);
+	}
+
+	// Keep the memory around for the next frame
+	Queue.Messages.Reset();
+	Queue.PayloadArena.Reset();
+	Queue.CoalescedMessageIndices.Reset();
+}
+
+void UGameplayMessageSubsystem::HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	// Every world ticks through this delegate, only flush after the one we belong to
+	if ((World != nullptr) && (World->GetGameInstance() == GetGameInstance()))
+	{
+		FlushDeferredMessages();
+	}
+}
+
+void UGameplayMessageSubsystem::SetChannelDelivery(FGameplayTag Channel, EGameplayMessageDelivery Delivery, bool bCoalesce)
+{
+	FChannelDeliverySettings& Settings = ChannelDeliverySettings.FindOrAdd(Channel);
+	Settings.Delivery = Delivery;
+	Settings.bCoalesce = bCoalesce;
+
+	DispatchListCache.Reset();
 }
 
 void UGameplayMessageSubsystem::K2_BroadcastMessage(FGameplayTag Channel, const int32& Message)
@@ -144,16 +384,21 @@ DEFINE_FUNCTION(UGameplayMessageSubsystem::execK2_BroadcastMessage)
 	}
 }
 
-FGameplayMessageListenerHandle UGameplayMessageSubsystem::RegisterListenerInternal(FGameplayTag Channel, TFunction<void(FGameplayTag, const UScriptStruct*, const void*)>&& Callback, const UScriptStruct* StructType, EGameplayMessageMatch MatchType)
+FGameplayMessageListenerHandle UGameplayMessageSubsystem::RegisterListenerInternal(FGameplayTag Channel, TFunction<void(FGameplayTag, const UScriptStruct*, const void*)>&& Callback, const UScriptStruct* StructType, EGameplayMessageMatch MatchType, EGameplayMessageDelivery Delivery)
 {
 	FChannelListenerList& List = ListenerMap.FindOrAdd(Channel);
 
-	FGameplayMessageListenerData& Entry = List.Listeners.AddDefaulted_GetRef();
+	FGameplayMessageListenerData& Entry = *List.Listeners.Add_GetRef(MakeShared<FGameplayMessageListenerData, ESPMode::NotThreadSafe>());
 	Entry.ReceivedCallback = MoveTemp(Callback);
 	Entry.ListenerStructType = StructType;
 	Entry.bHadValidType = StructType != nullptr;
 	Entry.HandleID = ++List.HandleID;
 	Entry.MatchType = MatchType;
+	Entry.Delivery = Delivery;
+	Entry.Channel = Channel;
+
+	// The new listener may receive broadcasts of this channel and (for partial matches) all of its children
+	DispatchListCache.Reset();
 
 	return FGameplayMessageListenerHandle(this, Channel, Entry.HandleID);
 }
@@ -176,10 +421,14 @@ void UGameplayMessageSubsystem::UnregisterListenerInternal(FGameplayTag Channel,
 {
 	if (FChannelListenerList* pList = ListenerMap.Find(Channel))
 	{
-		int32 MatchIndex = pList->Listeners.IndexOfByPredicate([ID = HandleID](const FGameplayMessageListenerData& Other) { return Other.HandleID == ID; });
+		int32 MatchIndex = pList->Listeners.IndexOfByPredicate([ID = HandleID](const FListenerDataRef& Other) { return Other->HandleID == ID; });
 		if (MatchIndex != INDEX_NONE)
 		{
+			// Broadcasts in flight may still reference the entry
+			pList->Listeners[MatchIndex]->bUnregistered = true;
 			pList->Listeners.RemoveAtSwap(MatchIndex);
+
+			DispatchListCache.Reset();
 		}
 
 		if (pList->Listeners.Num() == 0)
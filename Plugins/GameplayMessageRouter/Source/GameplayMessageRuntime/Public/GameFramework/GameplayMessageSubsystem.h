@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "Engine/EngineBaseTypes.h"
 #include "GameFramework/GameplayMessageTypes2.h"
 #include "GameplayTagContainer.h"
 #include "Subsystems/GameInstanceSubsystem.h"
@@ -10,6 +11,7 @@
 #include "GameplayMessageSubsystem.generated.h"
 
 class UGameplayMessageSubsystem;
+class UWorld;
 struct FFrame;
 
 GAMEPLAYMESSAGERUNTIME_API DECLARE_LOG_CATEGORY_EXTERN(LogGameplayMessageSubsystem, Log, All);
@@ -62,6 +64,13 @@ struct FGameplayMessageListenerData
 
 	int32 HandleID;
 	EGameplayMessageMatch MatchType;
+	EGameplayMessageDelivery Delivery = EGameplayMessageDelivery::Immediate;
+
+	// The channel this listener was registered on
+	FGameplayTag Channel;
+
+	// Set when the listener is unregistered, so broadcasts that are already in flight skip it
+	bool bUnregistered = false;
 
 	// Adding some logging and extra variables around some potential problems with this
 	TWeakObjectPtr<const UScriptStruct> ListenerStructType = nullptr;
@@ -102,9 +111,14 @@ public:
 	static bool HasInstance(const UObject* WorldContextObject);
 
 	//~USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
 	virtual void Deinitialize() override;
 	//~End of USubsystem interface
 
+	//~UObject interface
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+	//~End of UObject interface
+
 	/**
 	 * Broadcast a message on the specified channel
 	 *
@@ -123,11 +137,13 @@ public:
 	 *
 	 * @param Channel			The message channel to listen to
 	 * @param Callback			Function to call with the message when someone broadcasts it (must be the same type of UScriptStruct provided by broadcasters for this channel, otherwise an error will be logged)
+	 * @param MatchType			The rule used for matching the channel with broadcasted messages
+	 * @param Delivery			Whether Callback is called from inside the broadcast or when the deferred messages are flushed
 	 *
 	 * @return a handle that can be used to unregister this listener (either by calling Unregister() on the handle or calling UnregisterListener on the router)
 	 */
 	template <typename FMessageStructType>
-	FGameplayMessageListenerHandle RegisterListener(FGameplayTag Channel, TFunction<void(FGameplayTag, const FMessageStructType&)>&& Callback, EGameplayMessageMatch MatchType = EGameplayMessageMatch::ExactMatch)
+	FGameplayMessageListenerHandle RegisterListener(FGameplayTag Channel, TFunction<void(FGameplayTag, const FMessageStructType&)>&& Callback, EGameplayMessageMatch MatchType = EGameplayMessageMatch::ExactMatch, EGameplayMessageDelivery Delivery = EGameplayMessageDelivery::Immediate)
 	{
 		auto ThunkCallback = [InnerCallback = MoveTemp(Callback)](FGameplayTag ActualTag, const UScriptStruct* SenderStructType, const void* SenderPayload)
 		{
@@ -135,7 +151,7 @@ public:
 		};
 
 		const UScriptStruct* StructType = TBaseStructure<FMessageStructType>::Get();
-		return RegisterListenerInternal(Channel, ThunkCallback, StructType, MatchType);
+		return RegisterListenerInternal(Channel, ThunkCallback, StructType, MatchType, Delivery);
 	}
 
 	/**
@@ -185,7 +201,7 @@ public:
 			};
 
 			const UScriptStruct* StructType = TBaseStructure<FMessageStructType>::Get();
-			Handle = RegisterListenerInternal(Channel, ThunkCallback, StructType, Params.MatchType);
+			Handle = RegisterListenerInternal(Channel, ThunkCallback, StructType, Params.MatchType, Params.Delivery);
 		}
 
 		return Handle;
@@ -198,6 +214,18 @@ public:
 	 */
 	void UnregisterListener(FGameplayMessageListenerHandle Handle);
 
+	/**
+	 * Changes how every listener receives messages broadcast on a channel (or any of its children, unless they have their own setting)
+	 *
+	 * @param Channel			The message channel to change
+	 * @param Delivery			Deferred queues the messages for all listeners, Immediate leaves it up to each listener
+	 * @param bCoalesce			If true, only the last message broadcast on the same channel before a flush is delivered to deferred listeners
+	 */
+	void SetChannelDelivery(FGameplayTag Channel, EGameplayMessageDelivery Delivery, bool bCoalesce = false);
+
+	/** Delivers the queued messages to the deferred listeners. Messages broadcast while flushing are delivered by the next flush. */
+	void FlushDeferredMessages();
+
 protected:
 	/**
 	 * Broadcast a message on the specified channel
@@ -219,18 +247,85 @@ private:
 		FGameplayTag Channel, 
 		TFunction<void(FGameplayTag, const UScriptStruct*, const void*)>&& Callback,
 		const UScriptStruct* StructType,
-		EGameplayMessageMatch MatchType);
+		EGameplayMessageMatch MatchType,
+		EGameplayMessageDelivery Delivery = EGameplayMessageDelivery::Immediate);
 
 	void UnregisterListenerInternal(FGameplayTag Channel, int32 HandleID);
 
+	void HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
 private:
+	// Listener entries are shared with the dispatch lists, so they stay alive while a broadcast is iterating over them
+	using FListenerDataRef = TSharedRef<FGameplayMessageListenerData, ESPMode::NotThreadSafe>;
+
 	// List of all entries for a given channel
 	struct FChannelListenerList
 	{
-		TArray<FGameplayMessageListenerData> Listeners;
+		TArray<FListenerDataRef> Listeners;
 		int32 HandleID = 0;
 	};
 
+	// Every listener that receives a broadcast on a channel: the exact listeners of the channel followed by the partial
+	// listeners of each of its parents. Immutable once built, a broadcast holds a reference to the list it is iterating
+	// so registering or unregistering listeners from a callback is safe.
+	struct FChannelDispatchList
+	{
+		TArray<FListenerDataRef> Listeners;
+
+		// Listeners that receive the message when the deferred messages are flushed
+		TArray<FListenerDataRef> DeferredListeners;
+
+		// Only the last deferred message of the channel is delivered per flush
+		bool bCoalesce = false;
+	};
+	using FChannelDispatchListPtr = TSharedPtr<const FChannelDispatchList, ESPMode::NotThreadSafe>;
+
+	// Returns the dispatch list of a channel, building it if the listeners changed since it was last used
+	FChannelDispatchListPtr GetDispatchList(FGameplayTag Channel);
+
+	// Calls the listeners with the message
+	void DeliverMessage(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes, TConstArrayView<FListenerDataRef> Listeners);
+
+	// Copies a message into the queue that will be delivered to the deferred listeners by the next flush
+	void QueueDeferredMessage(FGameplayTag Channel, const UScriptStruct* StructType, const void* MessageBytes, const FChannelDispatchListPtr& DispatchList);
+
+	// Delivery set by SetChannelDelivery
+	struct FChannelDeliverySettings
+	{
+		EGameplayMessageDelivery Delivery = EGameplayMessageDelivery::Immediate;
+		bool bCoalesce = false;
+	};
+
+	// A message waiting for the next flush, its payload lives in the arena of the queue
+	struct FQueuedMessage
+	{
+		FGameplayTag Channel;
+		TWeakObjectPtr<const UScriptStruct> StructType;
+		int32 PayloadOffset = INDEX_NONE; // INDEX_NONE if the message was replaced by a coalesced one
+		FChannelDispatchListPtr DispatchList;
+	};
+
+	// The messages broadcast during one frame. Everything is reset but not freed on flush, so queueing messages doesn't
+	// allocate once the queue has grown to a typical frame's worth of messages.
+	struct FDeferredMessageQueue
+	{
+		TArray<FQueuedMessage> Messages;
+		TArray<uint8, TAlignedHeapAllocator<16>> PayloadArena;
+		TMap<FGameplayTag, int32> CoalescedMessageIndices;
+	};
+
 private:
 	TMap<FGameplayTag, FChannelListenerList> ListenerMap;
+
+	// Dispatch lists by broadcast channel, cleared whenever a listener is registered or unregistered
+	TMap<FGameplayTag, FChannelDispatchListPtr> DispatchListCache;
+
+	TMap<FGameplayTag, FChannelDeliverySettings> ChannelDeliverySettings;
+
+	// Double buffered so messages broadcast while flushing go into the other queue
+	FDeferredMessageQueue DeferredMessageQueues[2];
+	int32 WritingQueueIndex = 0;
+	bool bIsFlushingDeferredMessages = false;
+
+	FDelegateHandle PostActorTickHandle;
 };
@@ -22,6 +22,18 @@ enum class EGameplayMessageMatch : uint8
 	PartialMatch
 };
 
+// When listeners receive a broadcast message
+UENUM(BlueprintType)
+enum class EGameplayMessageDelivery : uint8
+{
+	// The listener is called from inside the broadcast
+	Immediate,
+
+	// The message is copied into a queue and the listener is called when the queue is flushed,
+	// after the actors of the world have ticked (or by UGameplayMessageSubsystem::FlushDeferredMessages)
+	Deferred
+};
+
 /**
  * Struct used to specify advanced behavior when registering a listener for gameplay messages
  */
@@ -31,6 +43,9 @@ struct FGameplayMessageListenerParams
 	/** Whether Callback should be called for broadcasts of more derived channels or if it will only be called for exact matches. */
 	EGameplayMessageMatch MatchType = EGameplayMessageMatch::ExactMatch;
 
+	/** Whether Callback should be called from inside the broadcast, or later when the deferred messages are flushed. */
+	EGameplayMessageDelivery Delivery = EGameplayMessageDelivery::Immediate;
+
 	/** If bound this callback will trigger when a message is broadcast on the specified channel. */
 	TFunction<void(FGameplayTag, const FMessageStructType&)> OnMessageReceivedCallback;
 
@@ -44,6 +44,8 @@ ULyraGameplayAbility::ULyraGameplayAbility(const FObjectInitializer& ObjectIniti
 	ActivationPolicy = ELyraAbilityActivationPolicy::OnInputTriggered;
 	ActivationGroup = ELyraAbilityActivationGroup::Independent;
 
+	bBatchServerRPCs = false;
+
 	bLogCancelation = false;
 
 	ActiveCameraMode = nullptr;
@@ -340,7 +342,7 @@ bool ULyraGameplayAbility::DoesAbilitySatisfyTagRequirements(const UAbilitySyste
 	// Expand our ability tags to add additional required/blocked tags
 	if (LyraASC)
 	{
-		LyraASC->GetAdditionalActivationTagRequirements(GetAssetTags(), AllRequiredTags, AllBlockedTags);
+		LyraASC->GetAdditionalActivationTagRequirements(GetAssetTags(), AllRequiredTags, AllBlockedTags, this);
 	}
 
 	// Check to see the required/blocked tags for this ability
@@ -122,6 +122,7 @@ public:
 
 	ELyraAbilityActivationPolicy GetActivationPolicy() const { return ActivationPolicy; }
 	ELyraAbilityActivationGroup GetActivationGroup() const { return ActivationGroup; }
+	bool ShouldBatchServerRPCs() const { return bBatchServerRPCs; }
 
 	void TryActivateAbilityOnSpawn(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilitySpec& Spec) const;
 
@@ -196,6 +197,12 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Lyra|Ability Activation")
 	ELyraAbilityActivationGroup ActivationGroup;
 
+	// If true, activating this ability from input batches its activate, target data and end RPCs into a single server RPC.
+	// Batched target data is sent under the activation prediction key without an application tag, so leave this off for
+	// abilities that send target data in their own scoped prediction window (e.g., ULyraGameplayAbility_RangedWeapon).
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Lyra|Ability Activation")
+	bool bBatchServerRPCs;
+
 	// Additional costs that must be paid to activate this ability
 	UPROPERTY(EditDefaultsOnly, Instanced, Category = Costs)
 	TArray<TObjectPtr<ULyraAbilityCost>> AdditionalCosts;
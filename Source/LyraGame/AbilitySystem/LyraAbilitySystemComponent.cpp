@@ -19,10 +19,6 @@ UE_DEFINE_GAMEPLAY_TAG(TAG_Gameplay_AbilityInputBlocked, "Gameplay.AbilityInputB
 ULyraAbilitySystemComponent::ULyraAbilitySystemComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
-	InputPressedSpecHandles.Reset();
-	InputReleasedSpecHandles.Reset();
-	InputHeldSpecHandles.Reset();
-
 	FMemory::Memset(ActivationGroupCounts, 0, sizeof(ActivationGroupCounts));
 }
 
@@ -187,12 +183,15 @@ void ULyraAbilitySystemComponent::AbilityInputTagPressed(const FGameplayTag& Inp
 {
 	if (InputTag.IsValid())
 	{
-		for (const FGameplayAbilitySpec& AbilitySpec : ActivatableAbilities.Items)
+		UpdateInputSpecIndex();
+
+		for (int32 SpecIndex = 0; SpecIndex < ActivatableAbilities.Items.Num(); ++SpecIndex)
 		{
+			const FGameplayAbilitySpec& AbilitySpec = ActivatableAbilities.Items[SpecIndex];
 			if (AbilitySpec.Ability && (AbilitySpec.GetDynamicSpecSourceTags().HasTagExact(InputTag)))
 			{
-				InputPressedSpecHandles.AddUnique(AbilitySpec.Handle);
-				InputHeldSpecHandles.AddUnique(AbilitySpec.Handle);
+				InputPressedSpecs[SpecIndex] = true;
+				InputHeldSpecs[SpecIndex] = true;
 			}
 		}
 	}
@@ -202,12 +201,15 @@ void ULyraAbilitySystemComponent::AbilityInputTagReleased(const FGameplayTag& In
 {
 	if (InputTag.IsValid())
 	{
-		for (const FGameplayAbilitySpec& AbilitySpec : ActivatableAbilities.Items)
+		UpdateInputSpecIndex();
+
+		for (int32 SpecIndex = 0; SpecIndex < ActivatableAbilities.Items.Num(); ++SpecIndex)
 		{
+			const FGameplayAbilitySpec& AbilitySpec = ActivatableAbilities.Items[SpecIndex];
 			if (AbilitySpec.Ability && (AbilitySpec.GetDynamicSpecSourceTags().HasTagExact(InputTag)))
 			{
-				InputReleasedSpecHandles.AddUnique(AbilitySpec.Handle);
-				InputHeldSpecHandles.Remove(AbilitySpec.Handle);
+				InputReleasedSpecs[SpecIndex] = true;
+				InputHeldSpecs[SpecIndex] = false;
 			}
 		}
 	}
@@ -221,52 +223,53 @@ void ULyraAbilitySystemComponent::ProcessAbilityInput(float DeltaTime, bool bGam
 		return;
 	}
 
-	static TArray<FGameplayAbilitySpecHandle> AbilitiesToActivate;
-	AbilitiesToActivate.Reset();
+	UpdateInputSpecIndex();
 
-	//@TODO: See if we can use FScopedServerAbilityRPCBatcher ScopedRPCBatcher in some of these loops
+	AbilitiesToActivate.Reset();
 
 	//
 	// Process all abilities that activate when the input is held.
 	//
-	for (const FGameplayAbilitySpecHandle& SpecHandle : InputHeldSpecHandles)
+	for (TConstSetBitIterator<> It(InputHeldSpecs); It; ++It)
 	{
-		if (const FGameplayAbilitySpec* AbilitySpec = FindAbilitySpecFromHandle(SpecHandle))
+		const FGameplayAbilitySpec& AbilitySpec = ActivatableAbilities.Items[It.GetIndex()];
+		if (AbilitySpec.Ability && !AbilitySpec.IsActive())
 		{
-			if (AbilitySpec->Ability && !AbilitySpec->IsActive())
+			const ULyraGameplayAbility* LyraAbilityCDO = Cast<ULyraGameplayAbility>(AbilitySpec.Ability);
+			if (LyraAbilityCDO && LyraAbilityCDO->GetActivationPolicy() == ELyraAbilityActivationPolicy::WhileInputActive)
 			{
-				const ULyraGameplayAbility* LyraAbilityCDO = Cast<ULyraGameplayAbility>(AbilitySpec->Ability);
-				if (LyraAbilityCDO && LyraAbilityCDO->GetActivationPolicy() == ELyraAbilityActivationPolicy::WhileInputActive)
-				{
-					AbilitiesToActivate.AddUnique(AbilitySpec->Handle);
-				}
+				AbilitiesToActivate.Add(AbilitySpec.Handle);
 			}
 		}
 	}
 
 	//
 	// Process all abilities that had their input pressed this frame.
+	// Input events can give or remove abilities, the lock defers that until the loop is done so the indices stay valid.
 	//
-	for (const FGameplayAbilitySpecHandle& SpecHandle : InputPressedSpecHandles)
 	{
-		if (FGameplayAbilitySpec* AbilitySpec = FindAbilitySpecFromHandle(SpecHandle))
+		ABILITYLIST_SCOPE_LOCK();
+
+		for (TConstSetBitIterator<> It(InputPressedSpecs); It; ++It)
 		{
-			if (AbilitySpec->Ability)
+			FGameplayAbilitySpec& AbilitySpec = ActivatableAbilities.Items[It.GetIndex()];
+			if (AbilitySpec.Ability)
 			{
-				AbilitySpec->InputPressed = true;
+				AbilitySpec.InputPressed = true;
 
-				if (AbilitySpec->IsActive())
+				if (AbilitySpec.IsActive())
 				{
 					// Ability is active so pass along the input event.
-					AbilitySpecInputPressed(*AbilitySpec);
+					AbilitySpecInputPressed(AbilitySpec);
 				}
 				else
 				{
-					const ULyraGameplayAbility* LyraAbilityCDO = Cast<ULyraGameplayAbility>(AbilitySpec->Ability);
+					const ULyraGameplayAbility* LyraAbilityCDO = Cast<ULyraGameplayAbility>(AbilitySpec.Ability);
 
+					// Can't have been added by the held loop above, that only adds WhileInputActive abilities
 					if (LyraAbilityCDO && LyraAbilityCDO->GetActivationPolicy() == ELyraAbilityActivationPolicy::OnInputTriggered)
 					{
-						AbilitiesToActivate.AddUnique(AbilitySpec->Handle);
+						AbilitiesToActivate.Add(AbilitySpec.Handle);
 					}
 				}
 			}
@@ -278,43 +281,133 @@ void ULyraAbilitySystemComponent::ProcessAbilityInput(float DeltaTime, bool bGam
 	// We do it all at once so that held inputs don't activate the ability
 	// and then also send a input event to the ability because of the press.
 	//
+	const bool bIsRemoteClient = !IsOwnerActorAuthoritative();
+
 	for (const FGameplayAbilitySpecHandle& AbilitySpecHandle : AbilitiesToActivate)
 	{
-		TryActivateAbility(AbilitySpecHandle);
+		// Remote clients send the activation, target data and end of opted in abilities to the server in one RPC when they happen inside the scope.
+		// An earlier activation in this loop may have given or removed abilities, so refresh the index (a no-op when nothing changed).
+		const ULyraGameplayAbility* LyraAbilityCDO = nullptr;
+		if (bIsRemoteClient)
+		{
+			UpdateInputSpecIndex();
+			if (const int32* SpecIndex = InputSpecIndexByHandle.Find(AbilitySpecHandle))
+			{
+				LyraAbilityCDO = Cast<ULyraGameplayAbility>(ActivatableAbilities.Items[*SpecIndex].Ability);
+			}
+		}
+
+		if (LyraAbilityCDO && LyraAbilityCDO->ShouldBatchServerRPCs())
+		{
+			TGuardValue<bool> AllowRPCBatchGuard(bAllowServerAbilityRPCBatch, true);
+			FScopedServerAbilityRPCBatcher ScopedRPCBatcher(this, AbilitySpecHandle);
+			TryActivateAbility(AbilitySpecHandle);
+		}
+		else
+		{
+			TryActivateAbility(AbilitySpecHandle);
+		}
 	}
 
+	// Activating abilities and the deferred changes of the lock above can give or remove abilities
+	UpdateInputSpecIndex();
+
 	//
 	// Process all abilities that had their input released this frame.
 	//
-	for (const FGameplayAbilitySpecHandle& SpecHandle : InputReleasedSpecHandles)
 	{
-		if (FGameplayAbilitySpec* AbilitySpec = FindAbilitySpecFromHandle(SpecHandle))
+		ABILITYLIST_SCOPE_LOCK();
+
+		for (TConstSetBitIterator<> It(InputReleasedSpecs); It; ++It)
 		{
-			if (AbilitySpec->Ability)
+			FGameplayAbilitySpec& AbilitySpec = ActivatableAbilities.Items[It.GetIndex()];
+			if (AbilitySpec.Ability)
 			{
-				AbilitySpec->InputPressed = false;
+				AbilitySpec.InputPressed = false;
 
-				if (AbilitySpec->IsActive())
+				if (AbilitySpec.IsActive())
 				{
 					// Ability is active so pass along the input event.
-					AbilitySpecInputReleased(*AbilitySpec);
+					AbilitySpecInputReleased(AbilitySpec);
 				}
 			}
 		}
 	}
 
 	//
-	// Clear the cached ability handles.
+	// Clear the pressed and released state.
 	//
-	InputPressedSpecHandles.Reset();
-	InputReleasedSpecHandles.Reset();
+	InputPressedSpecs.SetRange(0, InputPressedSpecs.Num(), false);
+	InputReleasedSpecs.SetRange(0, InputReleasedSpecs.Num(), false);
 }
 
 void ULyraAbilitySystemComponent::ClearAbilityInput()
 {
-	InputPressedSpecHandles.Reset();
-	InputReleasedSpecHandles.Reset();
-	InputHeldSpecHandles.Reset();
+	InputPressedSpecs.SetRange(0, InputPressedSpecs.Num(), false);
+	InputReleasedSpecs.SetRange(0, InputReleasedSpecs.Num(), false);
+	InputHeldSpecs.SetRange(0, InputHeldSpecs.Num(), false);
+}
+
+void ULyraAbilitySystemComponent::UpdateInputSpecIndex()
+{
+	const TArray<FGameplayAbilitySpec>& Specs = ActivatableAbilities.Items;
+	if (!bInputSpecIndexDirty && (InputIndexedSpecHandles.Num() == Specs.Num()))
+	{
+		return;
+	}
+
+	bInputSpecIndexDirty = false;
+
+	InputSpecIndexByHandle.Reset();
+	for (int32 SpecIndex = 0; SpecIndex < Specs.Num(); ++SpecIndex)
+	{
+		InputSpecIndexByHandle.Add(Specs[SpecIndex].Handle, SpecIndex);
+	}
+
+	// Move the input state to the new index of each spec, dropping it for removed specs
+	auto RemapInputState = [this, &Specs](TBitArray<>& InputState)
+	{
+		TBitArray<> NewInputState(false, Specs.Num());
+		for (TConstSetBitIterator<> It(InputState); It; ++It)
+		{
+			if (const int32* NewSpecIndex = InputSpecIndexByHandle.Find(InputIndexedSpecHandles[It.GetIndex()]))
+			{
+				NewInputState[*NewSpecIndex] = true;
+			}
+		}
+		InputState = MoveTemp(NewInputState);
+	};
+
+	RemapInputState(InputPressedSpecs);
+	RemapInputState(InputReleasedSpecs);
+	RemapInputState(InputHeldSpecs);
+
+	InputIndexedSpecHandles.Reset(Specs.Num());
+	for (const FGameplayAbilitySpec& Spec : Specs)
+	{
+		InputIndexedSpecHandles.Add(Spec.Handle);
+	}
+}
+
+void ULyraAbilitySystemComponent::OnGiveAbility(FGameplayAbilitySpec& AbilitySpec)
+{
+	Super::OnGiveAbility(AbilitySpec);
+
+	bInputSpecIndexDirty = true;
+}
+
+void ULyraAbilitySystemComponent::OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec)
+{
+	Super::OnRemoveAbility(AbilitySpec);
+
+	bInputSpecIndexDirty = true;
+}
+
+void ULyraAbilitySystemComponent::OnRep_ActivateAbilities()
+{
+	Super::OnRep_ActivateAbilities();
+
+	bInputSpecIndexDirty = true;
 }
 
 void ULyraAbilitySystemComponent::NotifyAbilityActivated(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability)
@@ -361,7 +454,7 @@ void ULyraAbilitySystemComponent::ApplyAbilityBlockAndCancelTags(const FGameplay
 	if (TagRelationshipMapping)
 	{
 		// Use the mapping to expand the ability tags into block and cancel tag
-		TagRelationshipMapping->GetAbilityTagsToBlockAndCancel(AbilityTags, &ModifiedBlockTags, &ModifiedCancelTags);
+		TagRelationshipMapping->GetAbilityTagsToBlockAndCancel(AbilityTags, &ModifiedBlockTags, &ModifiedCancelTags, RequestingAbility);
 	}
 
 	Super::ApplyAbilityBlockAndCancelTags(AbilityTags, RequestingAbility, bEnableBlockTags, ModifiedBlockTags, bExecuteCancelTags, ModifiedCancelTags);
@@ -376,11 +469,11 @@ void ULyraAbilitySystemComponent::HandleChangeAbilityCanBeCanceled(const FGamepl
 	//@TODO: Apply any special logic like blocking input or movement
 }
 
-void ULyraAbilitySystemComponent::GetAdditionalActivationTagRequirements(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer& OutActivationRequired, FGameplayTagContainer& OutActivationBlocked) const
+void ULyraAbilitySystemComponent::GetAdditionalActivationTagRequirements(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer& OutActivationRequired, FGameplayTagContainer& OutActivationBlocked, const UGameplayAbility* Ability) const
 {
 	if (TagRelationshipMapping)
 	{
-		TagRelationshipMapping->GetRequiredAndBlockedActivationTags(AbilityTags, &OutActivationRequired, &OutActivationBlocked);
+		TagRelationshipMapping->GetRequiredAndBlockedActivationTags(AbilityTags, &OutActivationRequired, &OutActivationBlocked, Ability);
 	}
 }
 
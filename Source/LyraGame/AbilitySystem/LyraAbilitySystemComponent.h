@@ -48,6 +48,9 @@ public:
 	void ProcessAbilityInput(float DeltaTime, bool bGamePaused);
 	void ClearAbilityInput();
 
+	// Only abilities that opt in (ULyraGameplayAbility::bBatchServerRPCs) batch their server RPCs, while they are activated from input
+	virtual bool ShouldDoServerAbilityRPCBatch() const override { return bAllowServerAbilityRPCBatch; }
+
 	bool IsActivationGroupBlocked(ELyraAbilityActivationGroup Group) const;
 	void AddAbilityToActivationGroup(ELyraAbilityActivationGroup Group, ULyraGameplayAbility* LyraAbility);
 	void RemoveAbilityFromActivationGroup(ELyraAbilityActivationGroup Group, ULyraGameplayAbility* LyraAbility);
@@ -66,15 +69,22 @@ public:
 	void SetTagRelationshipMapping(ULyraAbilityTagRelationshipMapping* NewMapping);
 	
 	/** Looks at ability tags and gathers additional required and blocking tags */
-	void GetAdditionalActivationTagRequirements(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer& OutActivationRequired, FGameplayTagContainer& OutActivationBlocked) const;
+	void GetAdditionalActivationTagRequirements(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer& OutActivationRequired, FGameplayTagContainer& OutActivationBlocked, const UGameplayAbility* Ability = nullptr) const;
 
 protected:
 
 	void TryActivateAbilitiesOnSpawn();
 
+	// Rebuilds InputSpecIndexByHandle if abilities were given or removed, moving the input state along with the specs
+	void UpdateInputSpecIndex();
+
 	virtual void AbilitySpecInputPressed(FGameplayAbilitySpec& Spec) override;
 	virtual void AbilitySpecInputReleased(FGameplayAbilitySpec& Spec) override;
 
+	virtual void OnGiveAbility(FGameplayAbilitySpec& AbilitySpec) override;
+	virtual void OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec) override;
+	virtual void OnRep_ActivateAbilities() override;
+
 	virtual void NotifyAbilityActivated(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability) override;
 	virtual void NotifyAbilityFailed(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability, const FGameplayTagContainer& FailureReason) override;
 	virtual void NotifyAbilityEnded(FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability, bool bWasCancelled) override;
@@ -92,14 +102,28 @@ protected:
 	UPROPERTY()
 	TObjectPtr<ULyraAbilityTagRelationshipMapping> TagRelationshipMapping;
 
-	// Handles to abilities that had their input pressed this frame.
-	TArray<FGameplayAbilitySpecHandle> InputPressedSpecHandles;
+	// Abilities that had their input pressed this frame (indexed like ActivatableAbilities.Items).
+	TBitArray<> InputPressedSpecs;
+
+	// Abilities that had their input released this frame (indexed like ActivatableAbilities.Items).
+	TBitArray<> InputReleasedSpecs;
+
+	// Abilities that have their input held (indexed like ActivatableAbilities.Items).
+	TBitArray<> InputHeldSpecs;
+
+	// Index in ActivatableAbilities.Items of every ability spec handle, rebuilt when abilities are given or removed.
+	TMap<FGameplayAbilitySpecHandle, int32> InputSpecIndexByHandle;
+
+	// Handle of every ability spec when the index was built, used to carry the input state over when specs move.
+	TArray<FGameplayAbilitySpecHandle> InputIndexedSpecHandles;
+
+	bool bInputSpecIndexDirty = true;
 
-	// Handles to abilities that had their input released this frame.
-	TArray<FGameplayAbilitySpecHandle> InputReleasedSpecHandles;
+	// Abilities to activate this frame, reused every frame.
+	TArray<FGameplayAbilitySpecHandle> AbilitiesToActivate;
 
-	// Handles to abilities that have their input held.
-	TArray<FGameplayAbilitySpecHandle> InputHeldSpecHandles;
+	// Set while an ability that opted in to server RPC batching is activated from input.
+	bool bAllowServerAbilityRPCBatch = false;
 
 	// Number of abilities running in each activation group.
 	int32 ActivationGroupCounts[(uint8)ELyraAbilityActivationGroup::MAX];
@@ -2,62 +2,147 @@
 
 #include "AbilitySystem/LyraAbilityTagRelationshipMapping.h"
 
+#include "Abilities/GameplayAbility.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraAbilityTagRelationshipMapping)
 
-void ULyraAbilityTagRelationshipMapping::GetAbilityTagsToBlockAndCancel(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutTagsToBlock, FGameplayTagContainer* OutTagsToCancel) const
+void ULyraAbilityTagRelationshipMapping::FMergedRelationship::Append(const FLyraAbilityTagRelationship& Relationship)
 {
-	// Simple iteration for now
-	for (int32 i = 0; i < AbilityTagRelationships.Num(); i++)
+	AbilityTagsToBlock.AppendTags(Relationship.AbilityTagsToBlock);
+	AbilityTagsToCancel.AppendTags(Relationship.AbilityTagsToCancel);
+	ActivationRequiredTags.AppendTags(Relationship.ActivationRequiredTags);
+	ActivationBlockedTags.AppendTags(Relationship.ActivationBlockedTags);
+}
+
+void ULyraAbilityTagRelationshipMapping::FMergedRelationship::Append(const FMergedRelationship& Other)
+{
+	AbilityTagsToBlock.AppendTags(Other.AbilityTagsToBlock);
+	AbilityTagsToCancel.AppendTags(Other.AbilityTagsToCancel);
+	ActivationRequiredTags.AppendTags(Other.ActivationRequiredTags);
+	ActivationBlockedTags.AppendTags(Other.ActivationBlockedTags);
+}
+
+void ULyraAbilityTagRelationshipMapping::PostLoad()
+{
+	Super::PostLoad();
+
+	BuildRelationshipTable();
+}
+
+#if WITH_EDITOR
+void ULyraAbilityTagRelationshipMapping::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	BuildRelationshipTable();
+}
+#endif
+
+void ULyraAbilityTagRelationshipMapping::BuildRelationshipTable() const
+{
+	RelationshipsByTag.Reset();
+	CachedAbilityRelationships.Reset();
+
+	for (const FLyraAbilityTagRelationship& Relationship : AbilityTagRelationships)
 	{
-		const FLyraAbilityTagRelationship& Tags = AbilityTagRelationships[i];
-		if (AbilityTags.HasTag(Tags.AbilityTag))
+		if (Relationship.AbilityTag.IsValid())
 		{
-			if (OutTagsToBlock)
-			{
-				OutTagsToBlock->AppendTags(Tags.AbilityTagsToBlock);
-			}
-			if (OutTagsToCancel)
-			{
-				OutTagsToCancel->AppendTags(Tags.AbilityTagsToCancel);
-			}
+			RelationshipsByTag.FindOrAdd(Relationship.AbilityTag).Append(Relationship);
 		}
 	}
+
+	bRelationshipTableBuilt = true;
 }
 
-void ULyraAbilityTagRelationshipMapping::GetRequiredAndBlockedActivationTags(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutActivationRequired, FGameplayTagContainer* OutActivationBlocked) const
+void ULyraAbilityTagRelationshipMapping::MergeRelationships(const FGameplayTagContainer& AbilityTags, FMergedRelationship& OutRelationship) const
 {
-	// Simple iteration for now
-	for (int32 i = 0; i < AbilityTagRelationships.Num(); i++)
+	if (!bRelationshipTableBuilt)
+	{
+		BuildRelationshipTable();
+	}
+
+	if (RelationshipsByTag.IsEmpty())
 	{
-		const FLyraAbilityTagRelationship& Tags = AbilityTagRelationships[i];
-		if (AbilityTags.HasTag(Tags.AbilityTag))
+		return;
+	}
+
+	// A relationship applies if its tag is one of the ability tags or one of their parents (same as AbilityTags.HasTag)
+	const FGameplayTagContainer AbilityTagsAndParents = AbilityTags.GetGameplayTagParents();
+	for (const FGameplayTag& Tag : AbilityTagsAndParents)
+	{
+		if (const FMergedRelationship* Relationship = RelationshipsByTag.Find(Tag))
 		{
-			if (OutActivationRequired)
-			{
-				OutActivationRequired->AppendTags(Tags.ActivationRequiredTags);
-			}
-			if (OutActivationBlocked)
-			{
-				OutActivationBlocked->AppendTags(Tags.ActivationBlockedTags);
-			}
+			OutRelationship.Append(*Relationship);
 		}
 	}
 }
 
-bool ULyraAbilityTagRelationshipMapping::IsAbilityCancelledByTag(const FGameplayTagContainer& AbilityTags, const FGameplayTag& ActionTag) const
+const ULyraAbilityTagRelationshipMapping::FMergedRelationship& ULyraAbilityTagRelationshipMapping::FindOrMergeRelationships(const FGameplayTagContainer& AbilityTags, const UGameplayAbility* Ability, FMergedRelationship& ScratchRelationship) const
 {
-	// Simple iteration for now
-	for (int32 i = 0; i < AbilityTagRelationships.Num(); i++)
+	if (Ability != nullptr)
 	{
-		const FLyraAbilityTagRelationship& Tags = AbilityTagRelationships[i];
+		if (!bRelationshipTableBuilt)
+		{
+			BuildRelationshipTable();
+		}
 
-		if (Tags.AbilityTag == ActionTag && Tags.AbilityTagsToCancel.HasAny(AbilityTags))
+		if (const FCachedAbilityRelationship* CachedRelationship = CachedAbilityRelationships.Find(Ability->GetClass()))
+		{
+			if (CachedRelationship->AbilityTags == AbilityTags)
+			{
+				return CachedRelationship->Relationship;
+			}
+		}
+		else
 		{
-			return true;
+			FCachedAbilityRelationship& NewCachedRelationship = CachedAbilityRelationships.Add(Ability->GetClass());
+			NewCachedRelationship.AbilityTags = AbilityTags;
+			MergeRelationships(AbilityTags, NewCachedRelationship.Relationship);
+			return NewCachedRelationship.Relationship;
 		}
 	}
 
-	return false;
+	MergeRelationships(AbilityTags, ScratchRelationship);
+	return ScratchRelationship;
+}
+
+void ULyraAbilityTagRelationshipMapping::GetAbilityTagsToBlockAndCancel(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutTagsToBlock, FGameplayTagContainer* OutTagsToCancel, const UGameplayAbility* Ability) const
+{
+	FMergedRelationship ScratchRelationship;
+	const FMergedRelationship& Relationship = FindOrMergeRelationships(AbilityTags, Ability, ScratchRelationship);
+
+	if (OutTagsToBlock)
+	{
+		OutTagsToBlock->AppendTags(Relationship.AbilityTagsToBlock);
+	}
+	if (OutTagsToCancel)
+	{
+		OutTagsToCancel->AppendTags(Relationship.AbilityTagsToCancel);
+	}
 }
 
+void ULyraAbilityTagRelationshipMapping::GetRequiredAndBlockedActivationTags(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutActivationRequired, FGameplayTagContainer* OutActivationBlocked, const UGameplayAbility* Ability) const
+{
+	FMergedRelationship ScratchRelationship;
+	const FMergedRelationship& Relationship = FindOrMergeRelationships(AbilityTags, Ability, ScratchRelationship);
+
+	if (OutActivationRequired)
+	{
+		OutActivationRequired->AppendTags(Relationship.ActivationRequiredTags);
+	}
+	if (OutActivationBlocked)
+	{
+		OutActivationBlocked->AppendTags(Relationship.ActivationBlockedTags);
+	}
+}
+
+bool ULyraAbilityTagRelationshipMapping::IsAbilityCancelledByTag(const FGameplayTagContainer& AbilityTags, const FGameplayTag& ActionTag) const
+{
+	if (!bRelationshipTableBuilt)
+	{
+		BuildRelationshipTable();
+	}
+
+	const FMergedRelationship* Relationship = RelationshipsByTag.Find(ActionTag);
+	return (Relationship != nullptr) && Relationship->AbilityTagsToCancel.HasAny(AbilityTags);
+}
@@ -4,9 +4,11 @@
 
 #include "Engine/DataAsset.h"
 #include "GameplayTagContainer.h"
+#include "UObject/ObjectKey.h"
 
 #include "LyraAbilityTagRelationshipMapping.generated.h"
 
+class UGameplayAbility;
 class UObject;
 
 /** Struct that defines the relationship between different ability tags */
@@ -49,12 +51,62 @@ private:
 	TArray<FLyraAbilityTagRelationship> AbilityTagRelationships;
 
 public:
-	/** Given a set of ability tags, parse the tag relationship and fill out tags to block and cancel */
-	void GetAbilityTagsToBlockAndCancel(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutTagsToBlock, FGameplayTagContainer* OutTagsToCancel) const;
-
-	/** Given a set of ability tags, add additional required and blocking tags */
-	void GetRequiredAndBlockedActivationTags(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutActivationRequired, FGameplayTagContainer* OutActivationBlocked) const;
+	//~UObject interface
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+	//~End of UObject interface
+
+	/**
+	 * Given a set of ability tags, parse the tag relationship and fill out tags to block and cancel.
+	 * If the tags belong to Ability, the merged result is cached per ability class.
+	 */
+	void GetAbilityTagsToBlockAndCancel(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutTagsToBlock, FGameplayTagContainer* OutTagsToCancel, const UGameplayAbility* Ability = nullptr) const;
+
+	/**
+	 * Given a set of ability tags, add additional required and blocking tags.
+	 * If the tags belong to Ability, the merged result is cached per ability class.
+	 */
+	void GetRequiredAndBlockedActivationTags(const FGameplayTagContainer& AbilityTags, FGameplayTagContainer* OutActivationRequired, FGameplayTagContainer* OutActivationBlocked, const UGameplayAbility* Ability = nullptr) const;
 
 	/** Returns true if the specified ability tags are canceled by the passed in action tag */
 	bool IsAbilityCancelledByTag(const FGameplayTagContainer& AbilityTags, const FGameplayTag& ActionTag) const;
+
+private:
+	/** Every relationship that applies to a set of ability tags, merged together */
+	struct FMergedRelationship
+	{
+		FGameplayTagContainer AbilityTagsToBlock;
+		FGameplayTagContainer AbilityTagsToCancel;
+		FGameplayTagContainer ActivationRequiredTags;
+		FGameplayTagContainer ActivationBlockedTags;
+
+		void Append(const FLyraAbilityTagRelationship& Relationship);
+		void Append(const FMergedRelationship& Other);
+	};
+
+	struct FCachedAbilityRelationship
+	{
+		/** The ability tags the result was built for, abilities that change their tags at runtime are not cached */
+		FGameplayTagContainer AbilityTags;
+		FMergedRelationship Relationship;
+	};
+
+	/** Rebuilds RelationshipsByTag from AbilityTagRelationships and clears the per ability cache */
+	void BuildRelationshipTable() const;
+
+	/** Merges the relationships of every ability tag (and their parent tags) */
+	void MergeRelationships(const FGameplayTagContainer& AbilityTags, FMergedRelationship& OutRelationship) const;
+
+	/** Returns the merged relationships for the ability tags, from the per ability class cache if possible */
+	const FMergedRelationship& FindOrMergeRelationships(const FGameplayTagContainer& AbilityTags, const UGameplayAbility* Ability, FMergedRelationship& ScratchRelationship) const;
+
+	/** All relationships with the same AbilityTag merged into one entry */
+	mutable TMap<FGameplayTag, FMergedRelationship> RelationshipsByTag;
+
+	/** Merged relationships of every ability class looked up so far */
+	mutable TMap<TObjectKey<UClass>, FCachedAbilityRelationship> CachedAbilityRelationships;
+
+	mutable bool bRelationshipTableBuilt = false;
 };
@@ -27,6 +27,14 @@ bool FLyraGameplayAbilityTargetData_SingleTargetHit::NetSerialize(FArchive& Ar,
 
 	Ar << CartridgeID;
 
+	uint8 bHasTimestampBit = bHasTimestamp ? 1 : 0;
+	Ar.SerializeBits(&bHasTimestampBit, 1);
+	bHasTimestamp = (bHasTimestampBit != 0);
+	if (bHasTimestamp)
+	{
+		Ar << Timestamp;
+	}
+
 	return true;
 }
 
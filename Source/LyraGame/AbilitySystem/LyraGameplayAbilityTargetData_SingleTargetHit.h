@@ -18,6 +18,8 @@ struct FLyraGameplayAbilityTargetData_SingleTargetHit : public FGameplayAbilityT
 
 	FLyraGameplayAbilityTargetData_SingleTargetHit()
 		: CartridgeID(-1)
+		, Timestamp(0.0)
+		, bHasTimestamp(false)
 	{ }
 
 	virtual void AddTargetDataToContext(FGameplayEffectContextHandle& Context, bool bIncludeActorArray) const override;
@@ -26,6 +28,17 @@ struct FLyraGameplayAbilityTargetData_SingleTargetHit : public FGameplayAbilityT
 	UPROPERTY()
 	int32 CartridgeID;
 
+	/**
+	 * Server world time (as estimated by the client) the shot was fired at, used to rewind hitboxes when validating the hit.
+	 * It is the same for every hit of a cartridge, so only the first hit of each cartridge sends it (see bHasTimestamp).
+	 */
+	UPROPERTY()
+	double Timestamp;
+
+	/** Set on the hit that carries the Timestamp of its cartridge, the other hits get it from that one on the receiving side */
+	UPROPERTY()
+	bool bHasTimestamp;
+
 	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
 
 	virtual UScriptStruct* GetScriptStruct() const override
@@ -15,7 +15,9 @@
 #include "Player/LyraPlayerController.h"
 #include "Player/LyraPlayerState.h"
 #include "System/LyraSignificanceManager.h"
+#include "Weapons/LyraHitboxHistorySubsystem.h"
 #include "TimerManager.h"
+#include "UObject/CoreNet.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraCharacter)
 
@@ -27,6 +29,105 @@ class UInputComponent;
 static FName NAME_LyraCharacterCollisionProfile_Capsule(TEXT("LyraPawnCapsule"));
 static FName NAME_LyraCharacterCollisionProfile_Mesh(TEXT("LyraPawnMesh"));
 
+namespace LyraCharacter
+{
+	static bool bCompactSharedMovement = false;
+	static FAutoConsoleVariableRef CVarCompactSharedMovement(
+		TEXT("Lyra.RepGraph.CompactSharedMovement"),
+		bCompactSharedMovement,
+		TEXT("If true, FastShared movement updates are sent with the compact FSharedRepMovement encoding."),
+		ECVF_Default);
+
+	static int32 CompactSharedMovementKeyFrameInterval = 10;
+	static FAutoConsoleVariableRef CVarCompactSharedMovementKeyFrameInterval(
+		TEXT("Lyra.RepGraph.CompactSharedMovement.KeyFrameInterval"),
+		CompactSharedMovementKeyFrameInterval,
+		TEXT("How many compact FastShared movement updates can be sent relative to a key frame before a new key frame is sent."),
+		ECVF_Default);
+
+	static int32 CompactSharedMovementKeyFrameRepeats = 3;
+	static FAutoConsoleVariableRef CVarCompactSharedMovementKeyFrameRepeats(
+		TEXT("Lyra.RepGraph.CompactSharedMovement.KeyFrameRepeats"),
+		CompactSharedMovementKeyFrameRepeats,
+		TEXT("How many compact FastShared movement updates carry a new key frame, so losing one (unreliable) update doesn't lose the key frame."),
+		ECVF_Default);
+
+	static bool bMeasureCompactSharedMovement = false;
+	static FAutoConsoleVariableRef CVarMeasureCompactSharedMovement(
+		TEXT("Lyra.RepGraph.CompactSharedMovement.Measure"),
+		bMeasureCompactSharedMovement,
+		TEXT("If true, the server serializes every FastShared movement update with both encodings and records the size. See Lyra.RepGraph.CompactSharedMovement.PrintMeasurements"),
+		ECVF_Default);
+
+	static int64 NumMeasuredUpdates = 0;
+	static int64 MeasuredFullBits = 0;
+	static int64 MeasuredCompactBits = 0;
+
+	static FAutoConsoleCommand PrintCompactSharedMovementMeasurementsCmd(
+		TEXT("Lyra.RepGraph.CompactSharedMovement.PrintMeasurements"),
+		TEXT("Prints the average size of the FastShared movement updates recorded while Lyra.RepGraph.CompactSharedMovement.Measure is set, with the full and the compact encoding"),
+		FConsoleCommandDelegate::CreateLambda([]()
+			{
+				if (NumMeasuredUpdates > 0)
+				{
+					UE_LOG(LogLyra, Display, TEXT("FastShared movement: %lld updates, full %.1f bits/update, compact %.1f bits/update (%.1f%%)"),
+						NumMeasuredUpdates, (double)MeasuredFullBits / NumMeasuredUpdates, (double)MeasuredCompactBits / NumMeasuredUpdates, 100.0 * MeasuredCompactBits / FMath::Max(MeasuredFullBits, (int64)1));
+				}
+				else
+				{
+					UE_LOG(LogLyra, Display, TEXT("FastShared movement: nothing measured, see Lyra.RepGraph.CompactSharedMovement.Measure"));
+				}
+			}));
+
+	// Deltas larger than this (e.g., teleports) start a new key frame instead
+	static constexpr double CompactSharedMovementMaxKeyFrameDelta = 5000.0;
+
+	// Serialized size of a FastShared movement update
+	static int64 MeasureSharedRepMovementBits(FSharedRepMovement SharedMovement)
+	{
+		FNetBitWriter Writer(nullptr, 1024);
+		bool bSuccess = true;
+		SharedMovement.NetSerialize(Writer, nullptr, bSuccess);
+		return Writer.GetNumBits();
+	}
+
+	// Serializes quantized components with the smallest number of bits that fits all of them (sent as a 5 bit header)
+	static void SerializeAdaptiveComponents(FArchive& Ar, TArrayView<int32> Components)
+	{
+		static constexpr int32 MaxMagnitude = (1 << 29) - 1;
+
+		uint32 NumBits = 0;
+		if (Ar.IsSaving())
+		{
+			int32 LargestMagnitude = 0;
+			for (int32& Component : Components)
+			{
+				Component = FMath::Clamp(Component, -MaxMagnitude, MaxMagnitude);
+				LargestMagnitude = FMath::Max(LargestMagnitude, FMath::Abs(Component));
+			}
+
+			// One extra bit for the sign
+			NumBits = (LargestMagnitude > 0) ? (FMath::FloorLog2((uint32)LargestMagnitude) + 2) : 0;
+		}
+
+		Ar.SerializeInt(NumBits, 32);
+
+		const int32 Bias = (NumBits > 0) ? (1 << (NumBits - 1)) : 0;
+		for (int32& Component : Components)
+		{
+			if (NumBits == 0)
+			{
+				Component = 0;
+				continue;
+			}
+
+			uint32 BiasedValue = (uint32)(Component + Bias);
+			Ar.SerializeInt(BiasedValue, 1u << NumBits);
+			Component = (int32)BiasedValue - Bias;
+		}
+	}
+}
+
 ALyraCharacter::ALyraCharacter(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer.SetDefaultSubobjectClass<ULyraCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
@@ -96,7 +197,15 @@ void ALyraCharacter::BeginPlay()
 	{
 		if (ULyraSignificanceManager* SignificanceManager = USignificanceManager::Get<ULyraSignificanceManager>(World))
 		{
-//@TODO: SignificanceManager->RegisterObject(this, (EFortSignificanceType)SignificanceType);
+			SignificanceManager->RegisterActor(this);
+		}
+	}
+
+	if (HasAuthority())
+	{
+		if (ULyraHitboxHistorySubsystem* HitboxHistory = World->GetSubsystem<ULyraHitboxHistorySubsystem>())
+		{
+			HitboxHistory->RegisterCharacter(this);
 		}
 	}
 }
@@ -112,9 +221,14 @@ void ALyraCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	{
 		if (ULyraSignificanceManager* SignificanceManager = USignificanceManager::Get<ULyraSignificanceManager>(World))
 		{
-			SignificanceManager->UnregisterObject(this);
+			SignificanceManager->UnregisterActor(this);
 		}
 	}
+
+	if (ULyraHitboxHistorySubsystem* HitboxHistory = World->GetSubsystem<ULyraHitboxHistorySubsystem>())
+	{
+		HitboxHistory->UnregisterCharacter(this);
+	}
 }
 
 void ALyraCharacter::Reset()
@@ -537,6 +651,34 @@ bool ALyraCharacter::UpdateSharedReplication()
 			// it, will get it this frame)
 			if (!SharedMovement.Equals(LastSharedReplication, this))
 			{
+				if (LyraCharacter::bCompactSharedMovement && SharedMovement.CanUseCompactEncoding())
+				{
+					PrepareCompactSharedReplication(SharedMovement);
+				}
+				else
+				{
+					bHasSharedRepMovementKeyFrame = false;
+				}
+
+				if (LyraCharacter::bMeasureCompactSharedMovement)
+				{
+					FSharedRepMovement FullSharedMovement = SharedMovement;
+					FullSharedMovement.bCompact = false;
+
+					FSharedRepMovement CompactSharedMovement = SharedMovement;
+					if (!CompactSharedMovement.bCompact)
+					{
+						// Measure the compact encoding as a key frame when it isn't in use
+						CompactSharedMovement.bCompact = true;
+						CompactSharedMovement.bHasKeyFrame = true;
+						CompactSharedMovement.KeyFrameLocation = SharedMovement.RepMovement.Location;
+					}
+
+					LyraCharacter::NumMeasuredUpdates++;
+					LyraCharacter::MeasuredFullBits += LyraCharacter::MeasureSharedRepMovementBits(FullSharedMovement);
+					LyraCharacter::MeasuredCompactBits += LyraCharacter::MeasureSharedRepMovementBits(CompactSharedMovement);
+				}
+
 				LastSharedReplication = SharedMovement;
 				ReplicatedMovementMode = SharedMovement.RepMovementMode;
 
@@ -550,6 +692,31 @@ bool ALyraCharacter::UpdateSharedReplication()
 	return false;
 }
 
+void ALyraCharacter::PrepareCompactSharedReplication(FSharedRepMovement& SharedMovement)
+{
+	const bool bNeedsKeyFrame = !bHasSharedRepMovementKeyFrame
+		|| (SharedRepMovementUpdatesSinceKeyFrame >= LyraCharacter::CompactSharedMovementKeyFrameInterval)
+		|| (FVector::DistSquared(SharedMovement.RepMovement.Location, SharedRepMovementKeyFrameLocation) > FMath::Square(LyraCharacter::CompactSharedMovementMaxKeyFrameDelta));
+
+	if (bNeedsKeyFrame)
+	{
+		SharedRepMovementKeyFrameSequence = (uint8)(SharedRepMovementKeyFrameSequence + 1);
+		SharedRepMovementKeyFrameLocation = SharedMovement.RepMovement.Location;
+		SharedRepMovementUpdatesSinceKeyFrame = 0;
+		bHasSharedRepMovementKeyFrame = true;
+	}
+	else
+	{
+		++SharedRepMovementUpdatesSinceKeyFrame;
+	}
+
+	// The first few updates of a key frame all carry it, so receivers only miss it if all of them are lost
+	SharedMovement.bCompact = true;
+	SharedMovement.bHasKeyFrame = SharedRepMovementUpdatesSinceKeyFrame < FMath::Max(LyraCharacter::CompactSharedMovementKeyFrameRepeats, 1);
+	SharedMovement.KeyFrameSequence = SharedRepMovementKeyFrameSequence;
+	SharedMovement.KeyFrameLocation = SharedRepMovementKeyFrameLocation;
+}
+
 void ALyraCharacter::FastSharedReplication_Implementation(const FSharedRepMovement& SharedRepMovement)
 {
 	if (GetWorld()->IsPlayingReplay())
@@ -560,6 +727,30 @@ void ALyraCharacter::FastSharedReplication_Implementation(const FSharedRepMoveme
 	// Timestamp is checked to reject old moves.
 	if (GetLocalRole() == ROLE_SimulatedProxy)
 	{
+		// Compact updates are relative to a key frame, resolve that first
+		FVector Location = SharedRepMovement.RepMovement.Location;
+		if (SharedRepMovement.bCompact)
+		{
+			if (SharedRepMovement.bHasKeyFrame)
+			{
+				SharedRepMovementKeyFrameLocation = SharedRepMovement.KeyFrameLocation;
+				SharedRepMovementKeyFrameSequence = SharedRepMovement.KeyFrameSequence;
+				bHasSharedRepMovementKeyFrame = true;
+			}
+
+			if (bHasSharedRepMovementKeyFrame && (SharedRepMovementKeyFrameSequence == SharedRepMovement.KeyFrameSequence))
+			{
+				Location += SharedRepMovementKeyFrameLocation;
+			}
+			else
+			{
+				// We missed every update that carried this key frame (FastShared sends to far connections are throttled, so that can happen
+				// every time), so the delta can't be resolved. Keep our location but still apply the rest of the update, the next key frame
+				// we receive or regular replication corrects the location.
+				Location = FRepMovement::RebaseOntoZeroOrigin(GetActorLocation(), this);
+			}
+		}
+
 		// Timestamp
 		ReplicatedServerLastTransformUpdateTimeStamp = SharedRepMovement.RepTimeStamp;
 
@@ -574,6 +765,7 @@ void ALyraCharacter::FastSharedReplication_Implementation(const FSharedRepMoveme
 		// Location, Rotation, Velocity, etc.
 		FRepMovement& MutableRepMovement = GetReplicatedMovement_Mutable();
 		MutableRepMovement = SharedRepMovement.RepMovement;
+		MutableRepMovement.Location = Location;
 
 		// This also sets LastRepMovement
 		OnRep_ReplicatedMovement();
@@ -661,10 +853,22 @@ bool FSharedRepMovement::Equals(const FSharedRepMovement& Other, ACharacter* Cha
 bool FSharedRepMovement::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
 {
 	bOutSuccess = true;
-	RepMovement.NetSerialize(Ar, Map, bOutSuccess);
-	Ar << RepMovementMode;
-	Ar << bProxyIsJumpForceApplied;
-	Ar << bIsCrouched;
+
+	uint8 bCompactBit = bCompact;
+	Ar.SerializeBits(&bCompactBit, 1);
+	bCompact = (bCompactBit != 0);
+
+	if (bCompact)
+	{
+		bOutSuccess = NetSerializeCompact(Ar);
+	}
+	else
+	{
+		RepMovement.NetSerialize(Ar, Map, bOutSuccess);
+		Ar << RepMovementMode;
+		Ar << bProxyIsJumpForceApplied;
+		Ar << bIsCrouched;
+	}
 
 	// Timestamp, if non-zero.
 	uint8 bHasTimeStamp = (RepTimeStamp != 0.f);
@@ -679,4 +883,87 @@ bool FSharedRepMovement::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool
 	}
 
 	return true;
-}
\ No newline at end of file
+}
+
+bool FSharedRepMovement::CanUseCompactEncoding() const
+{
+	// The compact encoding has fixed quantization, matching the FRepMovement defaults, and doesn't carry the physics replication state
+	return (RepMovement.LocationQuantizationLevel == EVectorQuantization::RoundTwoDecimals)
+		&& (RepMovement.VelocityQuantizationLevel == EVectorQuantization::RoundWholeNumber)
+		&& (RepMovement.RotationQuantizationLevel == ERotatorQuantization::ByteComponents)
+		&& !RepMovement.bRepPhysics;
+}
+
+bool FSharedRepMovement::NetSerializeCompact(FArchive& Ar)
+{
+	bool bSuccess = true;
+
+	// Flags
+	uint8 Flags = (bHasKeyFrame ? 1 : 0) | (bProxyIsJumpForceApplied ? 2 : 0) | (bIsCrouched ? 4 : 0) | (RepMovement.bSimulatedPhysicSleep ? 8 : 0);
+	Ar.SerializeBits(&Flags, 4);
+	bHasKeyFrame = (Flags & 1) != 0;
+	bProxyIsJumpForceApplied = (Flags & 2) != 0;
+	bIsCrouched = (Flags & 4) != 0;
+	RepMovement.bSimulatedPhysicSleep = (Flags & 8) != 0;
+
+	if (Ar.IsLoading())
+	{
+		// Only sent with the compact encoding when these are the quantization levels in use (see CanUseCompactEncoding)
+		RepMovement.bRepPhysics = false;
+		RepMovement.LocationQuantizationLevel = EVectorQuantization::RoundTwoDecimals;
+		RepMovement.VelocityQuantizationLevel = EVectorQuantization::RoundWholeNumber;
+		RepMovement.RotationQuantizationLevel = ERotatorQuantization::ByteComponents;
+	}
+
+	Ar << RepMovementMode;
+
+	// Location relative to the key frame, which is included in the first updates after it changes.
+	// Uses the same two decimal quantization as RepMovement.
+	Ar << KeyFrameSequence;
+	if (bHasKeyFrame)
+	{
+		bSuccess &= SerializePackedVector<100, 30>(KeyFrameLocation, Ar);
+	}
+
+	FVector Delta = Ar.IsSaving() ? (RepMovement.Location - KeyFrameLocation) : FVector::ZeroVector;
+	bSuccess &= SerializePackedVector<100, 30>(Delta, Ar);
+	if (Ar.IsLoading())
+	{
+		RepMovement.Location = Delta;
+	}
+
+	// Velocity, in whole units like RepMovement. Characters on the ground have no Z velocity, so that only costs a bit.
+	int32 Velocity[3] = { FMath::RoundToInt32(RepMovement.LinearVelocity.X), FMath::RoundToInt32(RepMovement.LinearVelocity.Y), FMath::RoundToInt32(RepMovement.LinearVelocity.Z) };
+	uint8 bHasVelocityZ = (Velocity[2] != 0);
+	Ar.SerializeBits(&bHasVelocityZ, 1);
+	if (!bHasVelocityZ)
+	{
+		Velocity[2] = 0;
+	}
+	LyraCharacter::SerializeAdaptiveComponents(Ar, TArrayView<int32>(Velocity, bHasVelocityZ ? 3 : 2));
+	if (Ar.IsLoading())
+	{
+		RepMovement.LinearVelocity = FVector(Velocity[0], Velocity[1], Velocity[2]);
+	}
+
+	// Rotation, with the same byte quantization as RepMovement. Upright characters only need their yaw.
+	uint8 Yaw = FRotator::CompressAxisToByte(RepMovement.Rotation.Yaw);
+	uint8 Pitch = FRotator::CompressAxisToByte(RepMovement.Rotation.Pitch);
+	uint8 Roll = FRotator::CompressAxisToByte(RepMovement.Rotation.Roll);
+	uint8 bYawOnly = (Pitch == 0) && (Roll == 0);
+	Ar.SerializeBits(&bYawOnly, 1);
+	Ar << Yaw;
+	if (!bYawOnly)
+	{
+		Ar << Pitch;
+		Ar << Roll;
+	}
+	if (Ar.IsLoading())
+	{
+		RepMovement.Rotation = bYawOnly
+			? FRotator(0.0, FRotator::DecompressAxisFromByte(Yaw), 0.0)
+			: FRotator(FRotator::DecompressAxisFromByte(Pitch), FRotator::DecompressAxisFromByte(Yaw), FRotator::DecompressAxisFromByte(Roll));
+	}
+
+	return bSuccess;
+}
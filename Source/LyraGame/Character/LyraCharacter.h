@@ -46,7 +46,16 @@ struct FLyraReplicatedAcceleration
 	int8 AccelZ = 0;	// Raw Z accel rate component, quantized to represent [-MaxAcceleration, MaxAcceleration]
 };
 
-/** The type we use to send FastShared movement updates. */
+/**
+ * The type we use to send FastShared movement updates.
+ *
+ * When bCompact is set (see Lyra.RepGraph.CompactSharedMovement) the update is encoded with a smaller format: the location is sent relative to
+ * a periodic key frame, velocity uses an adaptive number of bits per component and upright characters only send their yaw.
+ * The struct uses shared serialization (the same bits go to every connection), so the deltas are against the last key frame rather than
+ * anything acknowledged per connection. The first few updates of a key frame carry it along with its sequence number. Receivers that
+ * missed all of them (e.g., far connections whose FastShared sends are throttled) can't resolve the delta, they keep their location and
+ * apply the rest of the update (rotation, velocity, movement mode, ...) until they get a key frame.
+ */
 USTRUCT()
 struct FSharedRepMovement
 {
@@ -59,6 +68,9 @@ struct FSharedRepMovement
 
 	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
 
+	/** True if this update can be sent with the compact encoding (default quantization levels, no physics replication) */
+	bool CanUseCompactEncoding() const;
+
 	UPROPERTY(Transient)
 	FRepMovement RepMovement;
 
@@ -73,6 +85,27 @@ struct FSharedRepMovement
 
 	UPROPERTY(Transient)
 	bool bIsCrouched = false;
+
+	/** Use the compact encoding for this update */
+	UPROPERTY(Transient)
+	bool bCompact = false;
+
+	/** Compact encoding only: KeyFrameLocation is included in this update */
+	UPROPERTY(Transient)
+	bool bHasKeyFrame = false;
+
+	/** Compact encoding only: identifies the key frame the location is relative to */
+	UPROPERTY(Transient)
+	uint8 KeyFrameSequence = 0;
+
+	/**
+	 * Compact encoding only. The absolute location of the key frame the delta is computed against (only serialized when bHasKeyFrame is set).
+	 * On the receiving side, RepMovement.Location holds the delta until ALyraCharacter resolves it against its copy of the key frame.
+	 */
+	FVector KeyFrameLocation = FVector::ZeroVector;
+
+private:
+	bool NetSerializeCompact(FArchive& Ar);
 };
 
 template<>
@@ -188,6 +221,14 @@ protected:
 	virtual bool CanJumpInternal_Implementation() const;
 
 private:
+	// Fills in the key frame information of a compact FSharedRepMovement on the server
+	void PrepareCompactSharedReplication(FSharedRepMovement& SharedMovement);
+
+	// Key frame the compact FSharedRepMovement updates are encoded against (on the server) or decoded with (on simulated proxies)
+	FVector SharedRepMovementKeyFrameLocation = FVector::ZeroVector;
+	int32 SharedRepMovementUpdatesSinceKeyFrame = 0;
+	uint8 SharedRepMovementKeyFrameSequence = 0;
+	bool bHasSharedRepMovementKeyFrame = false;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Lyra|Character", Meta = (AllowPrivateAccess = "true"))
 	TObjectPtr<ULyraPawnExtensionComponent> PawnExtComponent;
@@ -3,9 +3,12 @@
 
 #include "LyraContextEffectComponent.h"
 
+#include "Components/AudioComponent.h"
 #include "Engine/World.h"
+#include "NiagaraComponent.h"
 #include "LyraContextEffectsSubsystem.h"
 #include "PhysicalMaterials/PhysicalMaterial.h"
+#include "System/LyraSignificanceManager.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraContextEffectComponent)
 
@@ -63,9 +66,11 @@ void ULyraContextEffectComponent::AnimMotionEffect_Implementation(const FName Bo
 	const bool bHitSuccess, const FHitResult HitResult, FGameplayTagContainer Contexts,
 	FVector VFXScale, float AudioVolume, float AudioPitch)
 {
-	// Prep Components
-	TArray<UAudioComponent*> AudioComponentsToAdd;
-	TArray<UNiagaraComponent*> NiagaraComponentsToAdd;
+	// Skip effects from characters that are too insignificant to notice (far away, occluded, ...)
+	if (!ULyraSignificanceManager::ShouldSpawnContextEffects(GetOwner()))
+	{
+		return;
+	}
 
 	FGameplayTagContainer TotalContexts;
 
@@ -99,23 +104,9 @@ void ULyraContextEffectComponent::AnimMotionEffect_Implementation(const FName Bo
 		}
 	}
 
-	// Cycle through Active Audio Components and cache
-	for (UAudioComponent* ActiveAudioComponent : ActiveAudioComponents)
-	{
-		if (ActiveAudioComponent)
-		{
-			AudioComponentsToAdd.Add(ActiveAudioComponent);
-		}
-	}
-
-	// Cycle through Active Niagara Components and cache
-	for (UNiagaraComponent* ActiveNiagaraComponent : ActiveNiagaraComponents)
-	{
-		if (ActiveNiagaraComponent)
-		{
-			NiagaraComponentsToAdd.Add(ActiveNiagaraComponent);
-		}
-	}
+	// Drop components that finished (pooled components are never returned to us, they are reused by other effects)
+	ActiveAudioComponents.RemoveAll([](const UAudioComponent* AudioComponent) { return !IsValid(AudioComponent) || !AudioComponent->IsPlaying(); });
+	ActiveNiagaraComponents.RemoveAll([](const UNiagaraComponent* NiagaraComponent) { return !IsValid(NiagaraComponent) || !NiagaraComponent->IsActive(); });
 
 	// Get World
 	if (const UWorld* World = GetWorld())
@@ -123,29 +114,20 @@ void ULyraContextEffectComponent::AnimMotionEffect_Implementation(const FName Bo
 		// Get Subsystem
 		if (ULyraContextEffectsSubsystem* LyraContextEffectsSubsystem = World->GetSubsystem<ULyraContextEffectsSubsystem>())
 		{
-			// Set up Audio Components and Niagara
-			TArray<UAudioComponent*> AudioComponents;
-			TArray<UNiagaraComponent*> NiagaraComponents;
+			// Set up Audio Components and Niagara, reusing the scratch arrays
+			SpawnedAudioComponents.Reset();
+			SpawnedNiagaraComponents.Reset();
 
 			// Spawn effects
 			LyraContextEffectsSubsystem->SpawnContextEffects(GetOwner(), StaticMeshComponent, Bone, 
 				LocationOffset, RotationOffset, MotionEffect, TotalContexts,
-				AudioComponents, NiagaraComponents, VFXScale, AudioVolume, AudioPitch);
+				SpawnedAudioComponents, SpawnedNiagaraComponents, VFXScale, AudioVolume, AudioPitch);
 
 			// Append resultant effects
-			AudioComponentsToAdd.Append(AudioComponents);
-			NiagaraComponentsToAdd.Append(NiagaraComponents);
+			ActiveAudioComponents.Append(SpawnedAudioComponents);
+			ActiveNiagaraComponents.Append(SpawnedNiagaraComponents);
 		}
 	}
-
-	// Append Active Audio Components
-	ActiveAudioComponents.Empty();
-	ActiveAudioComponents.Append(AudioComponentsToAdd);
-
-	// Append Active
-	ActiveNiagaraComponents.Empty();
-	ActiveNiagaraComponents.Append(NiagaraComponentsToAdd);
-
 }
 
 void ULyraContextEffectComponent::UpdateEffectContexts(FGameplayTagContainer NewEffectContexts)
@@ -72,4 +72,8 @@ private:
 
 	UPROPERTY(Transient)
 	TArray<TObjectPtr<UNiagaraComponent>> ActiveNiagaraComponents;
+
+	// Scratch space for the components spawned by one AnimMotionEffect call
+	TArray<UAudioComponent*> SpawnedAudioComponents;
+	TArray<UNiagaraComponent*> SpawnedNiagaraComponents;
 };
@@ -2,32 +2,138 @@
 
 #include "Feedback/ContextEffects/LyraContextEffectsLibrary.h"
 
+#include "LyraLogChannels.h"
 #include "NiagaraSystem.h"
 #include "Sound/SoundBase.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraContextEffectsLibrary)
 
 
+namespace LyraContextEffectsLibrary
+{
+	// Context masks are 64 bits, effects with more distinct context tags than that can't be indexed
+	static constexpr int32 MaxContextTagsPerEffect = 64;
+
+	// Upper bound on the number of resolved contexts kept per effect, in case contexts are built from unbounded data
+	static constexpr int32 MaxResolvedContextsPerEffect = 256;
+}
+
 void ULyraContextEffectsLibrary::GetEffects(const FGameplayTag Effect, const FGameplayTagContainer Context, 
 	TArray<USoundBase*>& Sounds, TArray<UNiagaraSystem*>& NiagaraSystems)
 {
+	TConstArrayView<TObjectPtr<USoundBase>> FoundSounds;
+	TConstArrayView<TObjectPtr<UNiagaraSystem>> FoundNiagaraSystems;
+	if (FindEffects(Effect, Context, FoundSounds, FoundNiagaraSystems))
+	{
+		// Get all Matching Sounds and Niagara Systems
+		Sounds.Reserve(Sounds.Num() + FoundSounds.Num());
+		for (USoundBase* Sound : FoundSounds)
+		{
+			Sounds.Add(Sound);
+		}
+
+		NiagaraSystems.Reserve(NiagaraSystems.Num() + FoundNiagaraSystems.Num());
+		for (UNiagaraSystem* NiagaraSystem : FoundNiagaraSystems)
+		{
+			NiagaraSystems.Add(NiagaraSystem);
+		}
+	}
+}
+
+bool ULyraContextEffectsLibrary::FindEffects(const FGameplayTag& Effect, const FGameplayTagContainer& Context,
+	TConstArrayView<TObjectPtr<USoundBase>>& OutSounds, TConstArrayView<TObjectPtr<UNiagaraSystem>>& OutNiagaraSystems)
+{
+	OutSounds = TConstArrayView<TObjectPtr<USoundBase>>();
+	OutNiagaraSystems = TConstArrayView<TObjectPtr<UNiagaraSystem>>();
+
 	// Make sure Effect is valid and Library is loaded
-	if (Effect.IsValid() && Context.IsValid() && EffectsLoadState == EContextEffectsLibraryLoadState::Loaded)
+	if (!Effect.IsValid() || !Context.IsValid() || EffectsLoadState != EContextEffectsLibraryLoadState::Loaded)
+	{
+		return false;
+	}
+
+	// Only the entries with the exact effect tag are considered
+	FEffectTagIndex* Index = EffectIndex.Find(Effect);
+	if (Index == nullptr)
+	{
+		return false;
+	}
+
+	// Which of the context tags used by this effect are in the context
+	uint64 ContextMask = 0;
+	for (int32 TagIndex = 0; TagIndex < Index->ContextTags.Num(); ++TagIndex)
+	{
+		if (Context.HasTagExact(Index->ContextTags[TagIndex]))
+		{
+			ContextMask |= (1ull << TagIndex);
+		}
+	}
+
+	FResolvedContextEffects* Resolved = Index->ResolvedByContextMask.Find(ContextMask);
+	if (Resolved == nullptr)
 	{
-		// Loop through Context Effects
-		for (const auto& ActiveContextEffect : ActiveContextEffects)
+		if (Index->ResolvedByContextMask.Num() >= LyraContextEffectsLibrary::MaxResolvedContextsPerEffect)
 		{
-			// Make sure the Effect is an exact Tag Match and ensure the Context has all tags in the Effect (and neither or both are empty)
-			if (Effect.MatchesTagExact(ActiveContextEffect->EffectTag)
-				&& Context.HasAllExact(ActiveContextEffect->Context)
-				&& (ActiveContextEffect->Context.IsEmpty() == Context.IsEmpty()))
+			Index->ResolvedByContextMask.Reset();
+		}
+
+		Resolved = &Index->ResolvedByContextMask.Add(ContextMask);
+
+		// The context has to have all tags of an entry (entries and contexts are never empty, see LoadEffectsInternal)
+		for (const TPair<int32, uint64>& Entry : Index->Entries)
+		{
+			if ((Entry.Value & ~ContextMask) == 0)
 			{
-				// Get all Matching Sounds and Niagara Systems
-				Sounds.Append(ActiveContextEffect->Sounds);
-				NiagaraSystems.Append(ActiveContextEffect->NiagaraSystems);
+				const ULyraActiveContextEffects* ActiveContextEffect = ActiveContextEffects[Entry.Key];
+				Resolved->Sounds.Append(ActiveContextEffect->Sounds);
+				Resolved->NiagaraSystems.Append(ActiveContextEffect->NiagaraSystems);
 			}
 		}
 	}
+
+	OutSounds = Resolved->Sounds;
+	OutNiagaraSystems = Resolved->NiagaraSystems;
+	return (OutSounds.Num() > 0) || (OutNiagaraSystems.Num() > 0);
+}
+
+void ULyraContextEffectsLibrary::BuildEffectIndex()
+{
+	EffectIndex.Reset();
+
+	for (int32 EntryIndex = 0; EntryIndex < ActiveContextEffects.Num(); ++EntryIndex)
+	{
+		const ULyraActiveContextEffects* ActiveContextEffect = ActiveContextEffects[EntryIndex];
+		if (ActiveContextEffect == nullptr)
+		{
+			continue;
+		}
+
+		FEffectTagIndex& Index = EffectIndex.FindOrAdd(ActiveContextEffect->EffectTag);
+
+		uint64 EntryMask = 0;
+		bool bIndexable = true;
+		for (const FGameplayTag& ContextTag : ActiveContextEffect->Context)
+		{
+			int32 TagIndex = Index.ContextTags.AddUnique(ContextTag);
+			if (TagIndex >= LyraContextEffectsLibrary::MaxContextTagsPerEffect)
+			{
+				Index.ContextTags.RemoveAt(TagIndex);
+				bIndexable = false;
+				break;
+			}
+			EntryMask |= (1ull << TagIndex);
+		}
+
+		if (bIndexable)
+		{
+			Index.Entries.Emplace(EntryIndex, EntryMask);
+		}
+		else
+		{
+			UE_LOG(LogLyra, Warning, TEXT("%s: effect %s uses more than %d different context tags, some of its entries will be ignored"),
+				*GetPathName(), *ActiveContextEffect->EffectTag.ToString(), LyraContextEffectsLibrary::MaxContextTagsPerEffect);
+		}
+	}
 }
 
 void ULyraContextEffectsLibrary::LoadEffects()
@@ -40,6 +146,7 @@ void ULyraContextEffectsLibrary::LoadEffects()
 
 		// Clear out any old Active Effects
 		ActiveContextEffects.Empty();
+		EffectIndex.Reset();
 
 		// Call internal loading function
 		LoadEffectsInternal();
@@ -115,5 +222,8 @@ void ULyraContextEffectsLibrary::LyraContextEffectLibraryLoadingComplete(
 
 	// Append incoming Context Effects Array to current list of Active Context Effects
 	ActiveContextEffects.Append(LyraActiveContextEffects);
+
+	// Index them so lookups don't have to scan every entry
+	BuildEffectIndex();
 }
 
@@ -81,6 +81,12 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void GetEffects(const FGameplayTag Effect, const FGameplayTagContainer Context, TArray<USoundBase*>& Sounds, TArray<UNiagaraSystem*>& NiagaraSystems);
 
+	/**
+	 * Same as GetEffects, but returns views of the matching effects instead of copying them.
+	 * The views are only valid until the next call or until the library is reloaded. Returns false if nothing matched.
+	 */
+	bool FindEffects(const FGameplayTag& Effect, const FGameplayTagContainer& Context, TConstArrayView<TObjectPtr<USoundBase>>& OutSounds, TConstArrayView<TObjectPtr<UNiagaraSystem>>& OutNiagaraSystems);
+
 	UFUNCTION(BlueprintCallable)
 	void LoadEffects();
 
@@ -91,6 +97,32 @@ private:
 
 	void LyraContextEffectLibraryLoadingComplete(TArray<ULyraActiveContextEffects*> LyraActiveContextEffects);
 
+	// Rebuilds EffectIndex from ActiveContextEffects
+	void BuildEffectIndex();
+
+	// The effects matching one (effect, context) query
+	struct FResolvedContextEffects
+	{
+		TArray<TObjectPtr<USoundBase>> Sounds;
+		TArray<TObjectPtr<UNiagaraSystem>> NiagaraSystems;
+	};
+
+	// All entries of one effect tag
+	struct FEffectTagIndex
+	{
+		// Distinct context tags used by the entries, a tag's position in this array is its bit in the context masks
+		TArray<FGameplayTag> ContextTags;
+
+		// Index into ActiveContextEffects and the mask of the context tags each entry requires
+		TArray<TPair<int32, uint64>> Entries;
+
+		// Resolved effects, keyed by the mask of ContextTags present in the queried context
+		TMap<uint64, FResolvedContextEffects> ResolvedByContextMask;
+	};
+
+	// Built when loading completes. The objects referenced here are kept alive by ActiveContextEffects.
+	TMap<FGameplayTag, FEffectTagIndex> EffectIndex;
+
 	UPROPERTY(Transient)
 	TArray< TObjectPtr<ULyraActiveContextEffects>> ActiveContextEffects;
 
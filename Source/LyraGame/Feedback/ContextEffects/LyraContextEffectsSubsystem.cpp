@@ -3,11 +3,15 @@
 
 #include "LyraContextEffectsSubsystem.h"
 
+#include "Components/AudioComponent.h"
+#include "Engine/World.h"
 #include "Feedback/ContextEffects/LyraContextEffectsLibrary.h"
 #include "Feedback/ContextEffects/LyraContextEffectsSubsystem.h"
+#include "GameFramework/PlayerController.h"
 #include "Kismet/GameplayStatics.h"
 #include "NiagaraFunctionLibrary.h"
 #include "NiagaraSystem.h"
+#include "Sound/SoundBase.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraContextEffectsSubsystem)
 
@@ -17,6 +21,58 @@ class UNiagaraSystem;
 class USceneComponent;
 class USoundBase;
 
+namespace LyraContextEffects
+{
+	static bool bUsePooling = true;
+	static FAutoConsoleVariableRef CVarUsePooling(
+		TEXT("Lyra.ContextEffects.UsePooling"),
+		bUsePooling,
+		TEXT("Should context effects reuse pooled Niagara and audio components instead of spawning new ones"),
+		ECVF_Default);
+
+	static int32 MaxSpawnsPerFrame = 48;
+	static FAutoConsoleVariableRef CVarMaxSpawnsPerFrame(
+		TEXT("Lyra.ContextEffects.MaxSpawnsPerFrame"),
+		MaxSpawnsPerFrame,
+		TEXT("Maximum number of context effect sounds and Niagara systems spawned per frame (0 = unlimited)"),
+		ECVF_Default);
+
+	static int32 MaxSpawnsPerEffectPerFrame = 12;
+	static FAutoConsoleVariableRef CVarMaxSpawnsPerEffectPerFrame(
+		TEXT("Lyra.ContextEffects.MaxSpawnsPerEffectPerFrame"),
+		MaxSpawnsPerEffectPerFrame,
+		TEXT("Maximum number of context effect sounds and Niagara systems spawned per frame for the same effect tag (0 = unlimited)"),
+		ECVF_Default);
+
+	static float MaxSpawnDistance = 6000.0f;
+	static FAutoConsoleVariableRef CVarMaxSpawnDistance(
+		TEXT("Lyra.ContextEffects.MaxSpawnDistance"),
+		MaxSpawnDistance,
+		TEXT("Context effects further than this (in uu) from every local viewer are not spawned (0 = no distance culling)"),
+		ECVF_Default);
+
+	static int32 MaxPooledAudioComponents = 64;
+	static FAutoConsoleVariableRef CVarMaxPooledAudioComponents(
+		TEXT("Lyra.ContextEffects.MaxPooledAudioComponents"),
+		MaxPooledAudioComponents,
+		TEXT("Maximum number of audio components kept for context effect sounds. Sounds are skipped when all of them are playing"),
+		ECVF_Default);
+}
+
+void ULyraContextEffectsSubsystem::Deinitialize()
+{
+	for (UAudioComponent* AudioComponent : PooledAudioComponents)
+	{
+		if (IsValid(AudioComponent))
+		{
+			AudioComponent->DestroyComponent();
+		}
+	}
+	PooledAudioComponents.Reset();
+
+	Super::Deinitialize();
+}
+
 void ULyraContextEffectsSubsystem::SpawnContextEffects(
 	const AActor* SpawningActor
 	, USceneComponent* AttachToComponent
@@ -37,9 +93,20 @@ void ULyraContextEffectsSubsystem::SpawnContextEffects(
 		// Validate the pointers from the Map Find
 		if (ULyraContextEffectsSet* EffectsLibraries = *EffectsLibrariesSetPtr)
 		{
-			// Prepare Arrays for Sounds and Niagara Systems
-			TArray<USoundBase*> TotalSounds;
-			TArray<UNiagaraSystem*> TotalNiagaraSystems;
+			BeginSpawnFrame();
+
+			// Skip the library lookups entirely if nothing would be spawned anyway
+			const FVector SpawnLocation = AttachToComponent ? AttachToComponent->GetSocketLocation(AttachPoint) : SpawningActor->GetActorLocation();
+			if (!CanSpawnEffectsAt(SpawnLocation))
+			{
+				return;
+			}
+
+			// Prepare Arrays for Sounds and Niagara Systems, reusing their allocations from previous calls
+			TArray<TObjectPtr<USoundBase>>& TotalSounds = ScratchSounds;
+			TArray<TObjectPtr<UNiagaraSystem>>& TotalNiagaraSystems = ScratchNiagaraSystems;
+			TotalSounds.Reset();
+			TotalNiagaraSystems.Reset();
 
 			// Cycle through Effect Libraries
 			for (ULyraContextEffectsLibrary* EffectLibrary : EffectsLibraries->LyraContextEffectsLibraries)
@@ -47,16 +114,14 @@ void ULyraContextEffectsSubsystem::SpawnContextEffects(
 				// Check if the Effect Library is valid and data Loaded
 				if (EffectLibrary && EffectLibrary->GetContextEffectsLibraryLoadState() == EContextEffectsLibraryLoadState::Loaded)
 				{
-					// Set up local list of Sounds and Niagara Systems
-					TArray<USoundBase*> Sounds;
-					TArray<UNiagaraSystem*> NiagaraSystems;
-
-					// Get Sounds and Niagara Systems
-					EffectLibrary->GetEffects(Effect, Contexts, Sounds, NiagaraSystems);
-
-					// Append to accumulating array
-					TotalSounds.Append(Sounds);
-					TotalNiagaraSystems.Append(NiagaraSystems);
+					// Get views of the Sounds and Niagara Systems and append them to the accumulating arrays
+					TConstArrayView<TObjectPtr<USoundBase>> Sounds;
+					TConstArrayView<TObjectPtr<UNiagaraSystem>> NiagaraSystems;
+					if (EffectLibrary->FindEffects(Effect, Contexts, Sounds, NiagaraSystems))
+					{
+						TotalSounds.Append(Sounds);
+						TotalNiagaraSystems.Append(NiagaraSystems);
+					}
 				}
 				else if (EffectLibrary && EffectLibrary->GetContextEffectsLibraryLoadState() == EContextEffectsLibraryLoadState::Unloaded)
 				{
@@ -68,26 +133,200 @@ void ULyraContextEffectsSubsystem::SpawnContextEffects(
 			// Cycle through found Sounds
 			for (USoundBase* Sound : TotalSounds)
 			{
-				// Spawn Sounds Attached, add Audio Component to List of ACs
-				UAudioComponent* AudioComponent = UGameplayStatics::SpawnSoundAttached(Sound, AttachToComponent, AttachPoint, LocationOffset, RotationOffset, EAttachLocation::KeepRelativeOffset,
-					false, AudioVolume, AudioPitch, 0.0f, nullptr, nullptr, true);
+				if (!HasSpawnBudget(Effect))
+				{
+					break;
+				}
 
-				AudioOut.Add(AudioComponent);
+				// Spawn Sounds Attached, add Audio Component to List of ACs unless it belongs to the pool
+				if (LyraContextEffects::bUsePooling)
+				{
+					if (SpawnPooledSoundAttached(Sound, AttachToComponent, AttachPoint, LocationOffset, RotationOffset, AudioVolume, AudioPitch))
+					{
+						ConsumeSpawnBudget(Effect);
+					}
+				}
+				else if (UAudioComponent* AudioComponent = UGameplayStatics::SpawnSoundAttached(Sound, AttachToComponent, AttachPoint, LocationOffset, RotationOffset, EAttachLocation::KeepRelativeOffset,
+					false, AudioVolume, AudioPitch, 0.0f, nullptr, nullptr, true))
+				{
+					ConsumeSpawnBudget(Effect);
+					AudioOut.Add(AudioComponent);
+				}
 			}
 
 			// Cycle through found Niagara Systems
 			for (UNiagaraSystem* NiagaraSystem : TotalNiagaraSystems)
 			{
-				// Spawn Niagara Systems Attached, add Niagara Component to List of NCs
+				if (!HasSpawnBudget(Effect))
+				{
+					break;
+				}
+
+				// Spawn Niagara Systems Attached, add Niagara Component to List of NCs unless it belongs to the pool
+				// Pooled components are returned to the world's Niagara pool when they complete
+				const ENCPoolMethod PoolMethod = LyraContextEffects::bUsePooling ? ENCPoolMethod::AutoRelease : ENCPoolMethod::None;
 				UNiagaraComponent* NiagaraComponent = UNiagaraFunctionLibrary::SpawnSystemAttached(NiagaraSystem, AttachToComponent, AttachPoint, LocationOffset,
-					RotationOffset, VFXScale, EAttachLocation::KeepRelativeOffset, true, ENCPoolMethod::None, true, true);
+					RotationOffset, VFXScale, EAttachLocation::KeepRelativeOffset, true, PoolMethod, true, true);
+
+				if (NiagaraComponent)
+				{
+					ConsumeSpawnBudget(Effect);
+					if (PoolMethod == ENCPoolMethod::None)
+					{
+						NiagaraOut.Add(NiagaraComponent);
+					}
+				}
+			}
+		}
+	}
+}
+
+void ULyraContextEffectsSubsystem::BeginSpawnFrame()
+{
+	if (SpawnFrameNumber == GFrameCounter)
+	{
+		return;
+	}
+
+	SpawnFrameNumber = GFrameCounter;
+	NumSpawnsThisFrame = 0;
+	NumSpawnsPerEffectThisFrame.Reset();
 
-				NiagaraOut.Add(NiagaraComponent);
+	// Gather where the local players are looking from, once per frame
+	LocalViewLocations.Reset();
+	if (LyraContextEffects::MaxSpawnDistance > 0.0f)
+	{
+		for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+		{
+			const APlayerController* PlayerController = Iterator->Get();
+			if (PlayerController && PlayerController->IsLocalController())
+			{
+				FVector ViewLocation;
+				FRotator ViewRotation;
+				PlayerController->GetPlayerViewPoint(/*out*/ ViewLocation, /*out*/ ViewRotation);
+				LocalViewLocations.Add(ViewLocation);
 			}
 		}
 	}
 }
 
+bool ULyraContextEffectsSubsystem::CanSpawnEffectsAt(const FVector& Location) const
+{
+	// Nobody can see or hear effects on a dedicated server
+	if (GetWorld()->GetNetMode() == NM_DedicatedServer)
+	{
+		return false;
+	}
+
+	if ((LyraContextEffects::MaxSpawnsPerFrame > 0) && (NumSpawnsThisFrame >= LyraContextEffects::MaxSpawnsPerFrame))
+	{
+		return false;
+	}
+
+	// Without any local viewer (e.g. before the local player has spawned) there is nothing to cull against
+	if (LocalViewLocations.Num() == 0)
+	{
+		return true;
+	}
+
+	const double MaxDistanceSquared = FMath::Square((double)LyraContextEffects::MaxSpawnDistance);
+	for (const FVector& ViewLocation : LocalViewLocations)
+	{
+		if (FVector::DistSquared(ViewLocation, Location) <= MaxDistanceSquared)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool ULyraContextEffectsSubsystem::HasSpawnBudget(const FGameplayTag& Effect) const
+{
+	if ((LyraContextEffects::MaxSpawnsPerFrame > 0) && (NumSpawnsThisFrame >= LyraContextEffects::MaxSpawnsPerFrame))
+	{
+		return false;
+	}
+
+	const int32* NumSpawnsForEffect = NumSpawnsPerEffectThisFrame.Find(Effect);
+	if ((LyraContextEffects::MaxSpawnsPerEffectPerFrame > 0) && NumSpawnsForEffect && (*NumSpawnsForEffect >= LyraContextEffects::MaxSpawnsPerEffectPerFrame))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void ULyraContextEffectsSubsystem::ConsumeSpawnBudget(const FGameplayTag& Effect)
+{
+	++NumSpawnsThisFrame;
+	++NumSpawnsPerEffectThisFrame.FindOrAdd(Effect);
+}
+
+UAudioComponent* ULyraContextEffectsSubsystem::AcquirePooledAudioComponent()
+{
+	for (int32 PoolIndex = 0; PoolIndex < PooledAudioComponents.Num(); ++PoolIndex)
+	{
+		UAudioComponent* AudioComponent = PooledAudioComponents[PoolIndex];
+		if (!IsValid(AudioComponent))
+		{
+			// Destroyed by someone else (e.g., along with what it was attached to), make room for a new one
+			PooledAudioComponents.RemoveAtSwap(PoolIndex--);
+			continue;
+		}
+
+		if (!AudioComponent->IsPlaying())
+		{
+			return AudioComponent;
+		}
+	}
+
+	if (PooledAudioComponents.Num() >= LyraContextEffects::MaxPooledAudioComponents)
+	{
+		return nullptr;
+	}
+
+	UAudioComponent* AudioComponent = NewObject<UAudioComponent>(this);
+	AudioComponent->bAutoActivate = false;
+	AudioComponent->bAutoDestroy = false;
+	AudioComponent->bStopWhenOwnerDestroyed = false;
+	AudioComponent->RegisterComponentWithWorld(GetWorld());
+	AudioComponent->OnAudioFinishedNative.AddUObject(this, &ThisClass::OnPooledAudioFinished);
+
+	PooledAudioComponents.Add(AudioComponent);
+	return AudioComponent;
+}
+
+UAudioComponent* ULyraContextEffectsSubsystem::SpawnPooledSoundAttached(USoundBase* Sound, USceneComponent* AttachToComponent, const FName AttachPoint,
+	const FVector& LocationOffset, const FRotator& RotationOffset, float AudioVolume, float AudioPitch)
+{
+	if ((Sound == nullptr) || (AttachToComponent == nullptr))
+	{
+		return nullptr;
+	}
+
+	UAudioComponent* AudioComponent = AcquirePooledAudioComponent();
+	if (AudioComponent == nullptr)
+	{
+		return nullptr;
+	}
+
+	AudioComponent->AttachToComponent(AttachToComponent, FAttachmentTransformRules::KeepRelativeTransform, AttachPoint);
+	AudioComponent->SetRelativeLocationAndRotation(LocationOffset, RotationOffset);
+	AudioComponent->SetSound(Sound);
+	AudioComponent->SetVolumeMultiplier(AudioVolume);
+	AudioComponent->SetPitchMultiplier(AudioPitch);
+	AudioComponent->Play();
+
+	return AudioComponent;
+}
+
+void ULyraContextEffectsSubsystem::OnPooledAudioFinished(UAudioComponent* AudioComponent)
+{
+	// Don't keep finished sounds attached to (and moving with) whatever they were last played on
+	AudioComponent->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+}
+
 bool ULyraContextEffectsSubsystem::GetContextFromSurfaceType(
 	TEnumAsByte<EPhysicalSurface> PhysicalSurface, FGameplayTag& Context)
 {
@@ -14,7 +14,9 @@ class AActor;
 class UAudioComponent;
 class ULyraContextEffectsLibrary;
 class UNiagaraComponent;
+class UNiagaraSystem;
 class USceneComponent;
+class USoundBase;
 struct FFrame;
 struct FGameplayTag;
 struct FGameplayTagContainer;
@@ -48,7 +50,13 @@ public:
 
 
 /**
- * 
+ * ULyraContextEffectsSubsystem
+ *
+ *	Spawns the sounds and Niagara systems of context effects for actors with registered effect libraries.
+ *
+ *	Effects are spawned from pools (the Niagara world component pool and a small pool of audio components owned by
+ *	this subsystem), limited by a per frame budget and a per effect tag budget, and culled when they are too far from
+ *	every local viewer, so a firefight with many characters doesn't allocate a component for every footstep.
  */
 UCLASS()
 class LYRAGAME_API ULyraContextEffectsSubsystem : public UWorldSubsystem
@@ -56,7 +64,15 @@ class LYRAGAME_API ULyraContextEffectsSubsystem : public UWorldSubsystem
 	GENERATED_BODY()
 	
 public:
-	/** */
+	//~USubsystem interface
+	virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
+	/**
+	 * Spawns the sounds and Niagara systems matching Effect and Contexts. Only components the caller owns are returned in
+	 * AudioOut and NiagaraOut: pooled components (see Lyra.ContextEffects.UsePooling) are reused by other effects once they
+	 * finish, so they are never handed out.
+	 */
 	UFUNCTION(BlueprintCallable, Category = "ContextEffects")
 	void SpawnContextEffects(
 		const AActor* SpawningActor
@@ -85,8 +101,41 @@ public:
 	void UnloadAndRemoveContextEffectsLibraries(AActor* OwningActor);
 
 private:
+	// Resets the spawn budgets and the local viewer locations when called on a new frame
+	void BeginSpawnFrame();
+
+	// Returns false if effects at Location should be skipped because the frame budget is used up or nobody is close enough to notice them
+	bool CanSpawnEffectsAt(const FVector& Location) const;
+
+	// Returns false if either the frame or the effect tag budget is used up
+	bool HasSpawnBudget(const FGameplayTag& Effect) const;
+
+	// Consumes one spawn from the frame and the effect tag budgets, once something was actually spawned
+	void ConsumeSpawnBudget(const FGameplayTag& Effect);
+
+	// Returns an audio component from the pool that isn't playing, or creates one if the pool isn't full yet.
+	// Components destroyed by someone else are dropped from the pool.
+	UAudioComponent* AcquirePooledAudioComponent();
+
+	UAudioComponent* SpawnPooledSoundAttached(USoundBase* Sound, USceneComponent* AttachToComponent, const FName AttachPoint,
+		const FVector& LocationOffset, const FRotator& RotationOffset, float AudioVolume, float AudioPitch);
+
+	void OnPooledAudioFinished(UAudioComponent* AudioComponent);
 
 	UPROPERTY(Transient)
 	TMap<TObjectPtr<AActor>, TObjectPtr<ULyraContextEffectsSet>> ActiveActorEffectsMap;
 
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UAudioComponent>> PooledAudioComponents;
+
+	// Scratch space reused by every SpawnContextEffects call
+	TArray<TObjectPtr<USoundBase>> ScratchSounds;
+	TArray<TObjectPtr<UNiagaraSystem>> ScratchNiagaraSystems;
+
+	// Per frame spawn budget and culling state
+	uint64 SpawnFrameNumber = 0;
+	int32 NumSpawnsThisFrame = 0;
+	TMap<FGameplayTag, int32> NumSpawnsPerEffectThisFrame;
+	TArray<FVector> LocalViewLocations;
+
 };
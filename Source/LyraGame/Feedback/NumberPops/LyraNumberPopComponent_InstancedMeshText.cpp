@@ -0,0 +1,257 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "LyraNumberPopComponent_InstancedMeshText.h"
+
+#include "Algo/Reverse.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "LyraDamagePopStyle.h"
+#include "TimerManager.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LyraNumberPopComponent_InstancedMeshText)
+
+class UStaticMesh;
+
+ULyraNumberPopComponent_InstancedMeshText::ULyraNumberPopComponent_InstancedMeshText(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	NumberLifespan = 1.f;
+
+	DistanceFromCameraBeforeDoublingSize = 1024.f;
+	CriticalHitSizeMultiplier = 1.7f;
+
+	MaxDigits = 6;
+	MaxLiveNumbers = 64;
+}
+
+void ULyraNumberPopComponent_InstancedMeshText::AddNumberPop(const FLyraNumberPopRequest& NewRequest)
+{
+	// Drop requests for remote players on the floor
+	// (this prevents multiple pops from showing up for the host of a listen server)
+	APlayerController* PC = GetController<APlayerController>();
+	if ((PC != nullptr) && !PC->IsLocalController())
+	{
+		return;
+	}
+
+	UWorld* LocalWorld = GetWorld();
+	check(LocalWorld);
+
+	UInstancedStaticMeshComponent* ISMComponent = GetOrCreateInstancedMeshComponent();
+	if (ISMComponent == nullptr)
+	{
+		return;
+	}
+
+	// Split the number into digits, most significant first, without any allocations
+	const int32 NumDigitSlots = FMath::Clamp(MaxDigits, 1, 9);
+	int32 Digits[9];
+	int32 NumDigits = 0;
+	{
+		int32 LocalDamage = FMath::Max(NewRequest.NumberToDisplay, 0);
+		do
+		{
+			Digits[NumDigits++] = LocalDamage % 10;
+			LocalDamage /= 10;
+		}
+		while ((LocalDamage > 0) && (NumDigits < NumDigitSlots));
+
+		// IF the number has more digits than we support
+		// THEN show the largest number we can support
+		if (LocalDamage > 0)
+		{
+			for (int32 DigitIndex = 0; DigitIndex < NumDigits; ++DigitIndex)
+			{
+				Digits[DigitIndex] = 9;
+			}
+		}
+
+		Algo::Reverse(Digits, NumDigits);
+	}
+
+	// Determine the position and size
+	FTransform CameraTransform;
+	FVector NumberLocation(NewRequest.WorldLocation);
+	if (PC != nullptr)
+	{
+		if (APlayerCameraManager* PlayerCameraManager = PC->PlayerCameraManager)
+		{
+			CameraTransform = FTransform(PlayerCameraManager->GetCameraRotation(), PlayerCameraManager->GetCameraLocation());
+
+			const float RandomMagnitude = 5.0f; //@TODO: Make this style driven
+			NumberLocation += FMath::RandPointInBox(FBox(FVector(-RandomMagnitude), FVector(RandomMagnitude)));
+		}
+	}
+
+	const float DistanceFromCameraToNumber = (CameraTransform.GetLocation() - NumberLocation).Size();
+	const float DistanceSpriteScale = DistanceFromCameraBeforeDoublingSize == 0.f ? 1.f : FMath::Max(DistanceFromCameraToNumber / DistanceFromCameraBeforeDoublingSize, 1.f);
+	const float HitSizeMultiplier = NewRequest.bIsCriticalDamage ? CriticalHitSizeMultiplier : 1.f;
+	const FTransform InstanceTransform(CameraTransform.GetRotation(), NumberLocation, FVector(DistanceSpriteScale * HitSizeMultiplier));
+
+	// Fill in the custom data. The material fades the number on real time, so it is also what we expire the instances on.
+	const float SpawnTime = LocalWorld->GetRealTimeSeconds();
+	const FLinearColor Color = DetermineColor(NewRequest);
+	InstanceCustomData.Reset();
+	InstanceCustomData.Add(SpawnTime);
+	InstanceCustomData.Add(NumberLifespan);
+	InstanceCustomData.Add(Color.R);
+	InstanceCustomData.Add(Color.G);
+	InstanceCustomData.Add(Color.B);
+	InstanceCustomData.Add(NewRequest.bIsCriticalDamage ? 1.f : 0.f);
+	InstanceCustomData.Add(NumDigits);
+	for (int32 DigitIndex = 0; DigitIndex < NumDigitSlots; ++DigitIndex)
+	{
+		InstanceCustomData.Add((DigitIndex < NumDigits) ? Digits[DigitIndex] : 0.f);
+	}
+
+	// Add a new instance until we have enough of them, then reuse the oldest one
+	int32 InstanceIndex = INDEX_NONE;
+	if (ISMComponent->GetInstanceCount() < MaxLiveNumbers)
+	{
+		InstanceIndex = ISMComponent->AddInstance(InstanceTransform, /*bWorldSpace=*/ true);
+		InstanceReleaseTimes.Add(0.f);
+	}
+	else
+	{
+		InstanceIndex = NextInstanceToReuse;
+		NextInstanceToReuse = (NextInstanceToReuse + 1) % ISMComponent->GetInstanceCount();
+		ISMComponent->UpdateInstanceTransform(InstanceIndex, InstanceTransform, /*bWorldSpace=*/ true, /*bMarkRenderStateDirty=*/ false);
+	}
+
+	ISMComponent->SetCustomData(InstanceIndex, InstanceCustomData, /*bMarkRenderStateDirty=*/ true);
+	InstanceReleaseTimes[InstanceIndex] = SpawnTime + NumberLifespan;
+
+	// Start the timer if it wasn't already running
+	if (!LocalWorld->GetTimerManager().IsTimerActive(ReleaseTimerHandle))
+	{
+		LocalWorld->GetTimerManager().SetTimer(ReleaseTimerHandle, this, &ThisClass::ReleaseExpiredInstances, NumberLifespan);
+	}
+}
+
+void ULyraNumberPopComponent_InstancedMeshText::OnUnregister()
+{
+	if (UWorld* LocalWorld = GetWorld())
+	{
+		LocalWorld->GetTimerManager().ClearTimer(ReleaseTimerHandle);
+	}
+
+	if (InstancedMeshComponent != nullptr)
+	{
+		InstancedMeshComponent->DestroyComponent();
+		InstancedMeshComponent = nullptr;
+	}
+
+	InstanceReleaseTimes.Reset();
+	NextInstanceToReuse = 0;
+
+	Super::OnUnregister();
+}
+
+UInstancedStaticMeshComponent* ULyraNumberPopComponent_InstancedMeshText::GetOrCreateInstancedMeshComponent()
+{
+	if ((InstancedMeshComponent == nullptr) && (NumberMesh != nullptr))
+	{
+		InstancedMeshComponent = NewObject<UInstancedStaticMeshComponent>(GetOwner());
+		InstancedMeshComponent->SetupAttachment(nullptr);
+		InstancedMeshComponent->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+		InstancedMeshComponent->SetStaticMesh(NumberMesh);
+		if (NumberMaterial != nullptr)
+		{
+			InstancedMeshComponent->SetMaterial(0, NumberMaterial);
+		}
+
+		// Instances are placed in world space, don't follow the controller around
+		InstancedMeshComponent->SetUsingAbsoluteLocation(true);
+		InstancedMeshComponent->SetUsingAbsoluteRotation(true);
+		InstancedMeshComponent->SetUsingAbsoluteScale(true);
+
+		InstancedMeshComponent->NumCustomDataFloats = FirstDigitCustomDataIndex + FMath::Clamp(MaxDigits, 1, 9);
+		InstanceCustomData.Reserve(InstancedMeshComponent->NumCustomDataFloats);
+		InstanceReleaseTimes.Reserve(MaxLiveNumbers);
+
+		// Used to allow post-processes to opt out of affecting the number pop digits
+		InstancedMeshComponent->SetRenderCustomDepth(true);
+		InstancedMeshComponent->SetCustomDepthStencilValue(123);
+
+		// The digits travel a great distance from their original bounds due to
+		// world position offset (WPO) animation in the material, so expand bounds
+		InstancedMeshComponent->SetBoundsScale(2000.0f);
+
+		InstancedMeshComponent->RegisterComponent();
+		InstancedMeshComponent->SetWorldTransform(FTransform::Identity);
+	}
+
+	return InstancedMeshComponent;
+}
+
+void ULyraNumberPopComponent_InstancedMeshText::ReleaseExpiredInstances()
+{
+	UWorld* LocalWorld = GetWorld();
+	check(LocalWorld);
+
+	if (InstancedMeshComponent == nullptr)
+	{
+		return;
+	}
+
+	// Same clock as the spawn time in the instance custom data. The timer runs on game time, so under pause or time dilation it can fire
+	// late (the number has already faded out) or early (we just schedule the rest).
+	const float CurrentTime = LocalWorld->GetRealTimeSeconds();
+
+	// Collapse every expired instance in one render state update, and find when the next one expires
+	bool bAnyReleased = false;
+	float NextReleaseTime = TNumericLimits<float>::Max();
+	for (int32 InstanceIndex = 0; InstanceIndex < InstanceReleaseTimes.Num(); ++InstanceIndex)
+	{
+		float& ReleaseTime = InstanceReleaseTimes[InstanceIndex];
+		if (ReleaseTime <= 0.f)
+		{
+			continue;
+		}
+
+		if (CurrentTime >= ReleaseTime)
+		{
+			FTransform InstanceTransform;
+			InstancedMeshComponent->GetInstanceTransform(InstanceIndex, /*out*/ InstanceTransform, /*bWorldSpace=*/ true);
+			InstanceTransform.SetScale3D(FVector::ZeroVector);
+			InstancedMeshComponent->UpdateInstanceTransform(InstanceIndex, InstanceTransform, /*bWorldSpace=*/ true, /*bMarkRenderStateDirty=*/ false);
+
+			ReleaseTime = 0.f;
+			bAnyReleased = true;
+		}
+		else
+		{
+			NextReleaseTime = FMath::Min(NextReleaseTime, ReleaseTime);
+		}
+	}
+
+	if (bAnyReleased)
+	{
+		InstancedMeshComponent->MarkRenderStateDirty();
+	}
+
+	// If we still have live numbers animating, set the timer to release the next one
+	if (NextReleaseTime < TNumericLimits<float>::Max())
+	{
+		LocalWorld->GetTimerManager().SetTimer(ReleaseTimerHandle, this, &ThisClass::ReleaseExpiredInstances, NextReleaseTime - CurrentTime);
+	}
+}
+
+FLinearColor ULyraNumberPopComponent_InstancedMeshText::DetermineColor(const FLyraNumberPopRequest& Request) const
+{
+	for (ULyraDamagePopStyle* Style : Styles)
+	{
+		if ((Style != nullptr) && Style->bOverrideColor)
+		{
+			if (Style->MatchPattern.Matches(Request.TargetTags))
+			{
+				return Request.bIsCriticalDamage ? Style->CriticalColor : Style->Color;
+			}
+		}
+	}
+
+	return FLinearColor::White;
+}
@@ -0,0 +1,104 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "LyraNumberPopComponent.h"
+
+#include "LyraNumberPopComponent_InstancedMeshText.generated.h"
+
+class UInstancedStaticMeshComponent;
+class ULyraDamagePopStyle;
+class UMaterialInterface;
+class UObject;
+class UStaticMesh;
+
+/**
+ * ULyraNumberPopComponent_InstancedMeshText
+ *
+ *	Number pop renderer that draws every live number as one instance of a single instanced static mesh component,
+ *	instead of a static mesh component with its own material instances per number (see ULyraNumberPopComponent_MeshText).
+ *
+ *	The instances use a fixed number of slots that are reused oldest first, so adding a number never creates components
+ *	or materials. Everything the material needs is in the per instance custom data:
+ *		[0]		Real time (in seconds) the number was added, age = real time - this
+ *		[1]		Lifespan (in seconds)
+ *		[2..4]	Color (RGB)
+ *		[5]		1 if critical damage, otherwise 0
+ *		[6]		Number of digits
+ *		[7..]	The digits, most significant first (MaxDigits floats)
+ *
+ *	Instances face the camera when added and are scaled by distance and critical hits. Expired instances are collapsed
+ *	to zero scale, but the material is expected to hide numbers older than their lifespan too.
+ */
+UCLASS(Blueprintable)
+class ULyraNumberPopComponent_InstancedMeshText : public ULyraNumberPopComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	ULyraNumberPopComponent_InstancedMeshText(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	//~ULyraNumberPopComponent interface
+	virtual void AddNumberPop(const FLyraNumberPopRequest& NewRequest) override;
+	//~End of ULyraNumberPopComponent interface
+
+	// Index of the first digit in the per instance custom data
+	static constexpr int32 FirstDigitCustomDataIndex = 7;
+
+protected:
+	//~UActorComponent interface
+	virtual void OnUnregister() override;
+	//~End of UActorComponent interface
+
+	FLinearColor DetermineColor(const FLyraNumberPopRequest& Request) const;
+
+	/** Creates the instanced mesh component the first time a number is added */
+	UInstancedStaticMeshComponent* GetOrCreateInstancedMeshComponent();
+
+	/** Collapses the instances that have exceeded their lifespan */
+	void ReleaseExpiredInstances();
+
+	/** Style patterns to attempt to apply to the incoming number pops (only the color is used) */
+	UPROPERTY(EditDefaultsOnly, Category = "Number Pop|Style")
+	TArray<TObjectPtr<ULyraDamagePopStyle>> Styles;
+
+	/** Mesh drawn for every number, its material has to read the per instance custom data described above */
+	UPROPERTY(EditDefaultsOnly, Category = "Number Pop|Style")
+	TObjectPtr<UStaticMesh> NumberMesh;
+
+	/** Optional material override for NumberMesh */
+	UPROPERTY(EditDefaultsOnly, Category = "Number Pop|Style")
+	TObjectPtr<UMaterialInterface> NumberMaterial;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Number Pop|Style")
+	float NumberLifespan;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Number Pop|Style")
+	float DistanceFromCameraBeforeDoublingSize;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Number Pop|Style")
+	float CriticalHitSizeMultiplier;
+
+	/** Maximum number of digits shown, larger numbers are clamped to all nines */
+	UPROPERTY(EditDefaultsOnly, Category = "Number Pop|Style", meta = (ClampMin = 1, ClampMax = 9))
+	int32 MaxDigits;
+
+	/** Maximum number of numbers on screen at once, the oldest number is replaced when a new one doesn't fit */
+	UPROPERTY(EditDefaultsOnly, Category = "Number Pop|Style", meta = (ClampMin = 1))
+	int32 MaxLiveNumbers;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UInstancedStaticMeshComponent> InstancedMeshComponent;
+
+	/** Release time (real time seconds) of every instance, indexed by instance */
+	TArray<float> InstanceReleaseTimes;
+
+	/** Instance that the next number will replace once all MaxLiveNumbers instances exist */
+	int32 NextInstanceToReuse = 0;
+
+	/** Scratch custom data, reused for every number */
+	TArray<float> InstanceCustomData;
+
+	FTimerHandle ReleaseTimerHandle;
+};
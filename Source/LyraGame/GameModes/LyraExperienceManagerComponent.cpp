@@ -6,6 +6,8 @@
 #include "LyraExperienceDefinition.h"
 #include "LyraExperienceActionSet.h"
 #include "LyraExperienceManager.h"
+#include "LyraExperiencePreloadSubsystem.h"
+#include "Engine/GameInstance.h"
 #include "GameFeaturesSubsystem.h"
 #include "System/LyraAssetManager.h"
 #include "GameFeatureAction.h"
@@ -202,12 +204,10 @@ void ULyraExperienceManagerComponent::StartExperienceLoad()
 			}));
 	}
 
-	// This set of assets gets preloaded, but we don't block the start of the experience based on it
-	TSet<FPrimaryAssetId> PreloadAssetList;
-	//@TODO: Determine assets to preload (but not blocking-ly)
-	if (PreloadAssetList.Num() > 0)
+	// Anything the preload subsystem warmed up for this experience has to stay around until the bundles above have loaded
+	if (ULyraExperiencePreloadSubsystem* PreloadSubsystem = GetPreloadSubsystem())
 	{
-		AssetManager.ChangeBundleStateForPrimaryAssets(PreloadAssetList.Array(), BundlesToLoad, {});
+		PreloadSubsystem->NotifyExperienceLoadStarted(CurrentExperience->GetPrimaryAssetId());
 	}
 }
 
@@ -344,6 +344,11 @@ void ULyraExperienceManagerComponent::OnExperienceFullLoadCompleted()
 
 	LoadState = ELyraExperienceLoadState::Loaded;
 
+	if (ULyraExperiencePreloadSubsystem* PreloadSubsystem = GetPreloadSubsystem())
+	{
+		PreloadSubsystem->NotifyExperienceLoaded(CurrentExperience->GetPrimaryAssetId());
+	}
+
 	OnExperienceLoaded_HighPriority.Broadcast(CurrentExperience);
 	OnExperienceLoaded_HighPriority.Clear();
 
@@ -359,6 +364,12 @@ void ULyraExperienceManagerComponent::OnExperienceFullLoadCompleted()
 #endif
 }
 
+ULyraExperiencePreloadSubsystem* ULyraExperienceManagerComponent::GetPreloadSubsystem() const
+{
+	const UGameInstance* GameInstance = GetWorld()->GetGameInstance();
+	return (GameInstance != nullptr) ? GameInstance->GetSubsystem<ULyraExperiencePreloadSubsystem>() : nullptr;
+}
+
 void ULyraExperienceManagerComponent::OnActionDeactivationCompleted()
 {
 	check(IsInGameThread());
@@ -391,6 +402,15 @@ void ULyraExperienceManagerComponent::EndPlay(const EEndPlayReason::Type EndPlay
 		}
 	}
 
+	// A load that never finished (e.g., we travelled away first) no longer needs what was preloaded for it
+	if ((LoadState != ELyraExperienceLoadState::Loaded) && (LoadState != ELyraExperienceLoadState::Unloaded) && (CurrentExperience != nullptr))
+	{
+		if (ULyraExperiencePreloadSubsystem* PreloadSubsystem = GetPreloadSubsystem())
+		{
+			PreloadSubsystem->NotifyExperienceLoadAborted(CurrentExperience->GetPrimaryAssetId());
+		}
+	}
+
 	//@TODO: Ensure proper handling of a partially-loaded state too
 	if (LoadState == ELyraExperienceLoadState::Loaded)
 	{
@@ -10,6 +10,7 @@
 namespace UE::GameFeatures { struct FResult; }
 
 class ULyraExperienceDefinition;
+class ULyraExperiencePreloadSubsystem;
 
 DECLARE_MULTICAST_DELEGATE_OneParam(FOnLyraExperienceLoaded, const ULyraExperienceDefinition* /*Experience*/);
 
@@ -76,6 +77,8 @@ private:
 	void OnActionDeactivationCompleted();
 	void OnAllActionsDeactivated();
 
+	ULyraExperiencePreloadSubsystem* GetPreloadSubsystem() const;
+
 private:
 	UPROPERTY(ReplicatedUsing=OnRep_CurrentExperience)
 	TObjectPtr<const ULyraExperienceDefinition> CurrentExperience;
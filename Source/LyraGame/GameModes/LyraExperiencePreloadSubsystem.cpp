@@ -0,0 +1,432 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "LyraExperiencePreloadSubsystem.h"
+
+#include "Engine/GameInstance.h"
+#include "Engine/StreamableManager.h"
+#include "Engine/World.h"
+#include "GameFeaturesSubsystem.h"
+#include "GameFeaturesSubsystemSettings.h"
+#include "GameModes/LyraExperienceActionSet.h"
+#include "GameModes/LyraExperienceDefinition.h"
+#include "GameModes/LyraUserFacingExperienceDefinition.h"
+#include "HAL/PlatformMemory.h"
+#include "LyraLogChannels.h"
+#include "Misc/CoreDelegates.h"
+#include "System/LyraAssetManager.h"
+#include "UObject/UObjectGlobals.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LyraExperiencePreloadSubsystem)
+
+namespace LyraExperiencePreload
+{
+	static bool bEnablePreloading = true;
+	static FAutoConsoleVariableRef CVarEnablePreloading(
+		TEXT("Lyra.Experience.Preload.Enable"),
+		bEnablePreloading,
+		TEXT("Should the experiences that are likely to be played next be preloaded in the background"),
+		ECVF_Default);
+
+	static int32 MaxPreloadedExperiences = 2;
+	static FAutoConsoleVariableRef CVarMaxPreloadedExperiences(
+		TEXT("Lyra.Experience.Preload.MaxExperiences"),
+		MaxPreloadedExperiences,
+		TEXT("Maximum number of experiences that are speculatively preloaded at once (the highest priority candidates)"),
+		ECVF_Default);
+
+	static int32 MinFreeMemoryMB = 1024;
+	static FAutoConsoleVariableRef CVarMinFreeMemoryMB(
+		TEXT("Lyra.Experience.Preload.MinFreeMemoryMB"),
+		MinFreeMemoryMB,
+		TEXT("When less physical memory (in MB) than this is available, no new preloads are started and the lowest priority preload is released"),
+		ECVF_Default);
+
+	static float MemoryCheckInterval = 5.0f;
+	static FAutoConsoleVariableRef CVarMemoryCheckInterval(
+		TEXT("Lyra.Experience.Preload.MemoryCheckInterval"),
+		MemoryCheckInterval,
+		TEXT("How often (in seconds) available memory is checked while experiences are preloaded, so preloads are released under memory pressure during a match. Read at startup"),
+		ECVF_Default);
+}
+
+//////////////////////////////////////////////////////////////////////
+// ULyraExperiencePreloadSubsystem
+
+void ULyraExperiencePreloadSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Map loads are the biggest change in memory use, so check the budget again once they're done
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &ThisClass::HandlePostLoadMap);
+
+	// Memory can also run low during a match, long after the last map load
+	MemoryCheckHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::HandleMemoryCheck), FMath::Max(LyraExperiencePreload::MemoryCheckInterval, 0.0f));
+	MemoryTrimHandle = FCoreDelegates::GetMemoryTrimDelegate().AddUObject(this, &ThisClass::HandleMemoryTrim);
+
+	// Dedicated servers don't have a front end, they only preload experiences they are told about
+	if (!IsRunningDedicatedServer() && LyraExperiencePreload::bEnablePreloading)
+	{
+		const FPrimaryAssetType UserFacingExperienceType = ULyraUserFacingExperienceDefinition::StaticClass()->GetFName();
+		UserFacingExperiencesHandle = ULyraAssetManager::Get().LoadPrimaryAssetsWithType(UserFacingExperienceType, {},
+			FStreamableDelegate::CreateUObject(this, &ThisClass::OnUserFacingExperiencesLoaded), FStreamableManager::AsyncLoadLowPriority);
+
+		if (UserFacingExperiencesHandle.IsValid() && UserFacingExperiencesHandle->HasLoadCompleted())
+		{
+			OnUserFacingExperiencesLoaded();
+		}
+	}
+}
+
+void ULyraExperiencePreloadSubsystem::Deinitialize()
+{
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+	FCoreDelegates::GetMemoryTrimDelegate().Remove(MemoryTrimHandle);
+	FTSTicker::GetCoreTicker().RemoveTicker(MemoryCheckHandle);
+
+	for (FExperiencePreload& Preload : Preloads)
+	{
+		ReleasePreload(Preload);
+	}
+	Preloads.Reset();
+
+	if (UserFacingExperiencesHandle.IsValid())
+	{
+		UserFacingExperiencesHandle->CancelHandle();
+		UserFacingExperiencesHandle.Reset();
+	}
+
+	Super::Deinitialize();
+}
+
+void ULyraExperiencePreloadSubsystem::AddPreloadCandidate(FPrimaryAssetId ExperienceId, ELyraExperiencePreloadSource Source)
+{
+	if (!ExperienceId.IsValid())
+	{
+		return;
+	}
+
+	FExperiencePreload* Preload = Preloads.FindByPredicate([&ExperienceId](const FExperiencePreload& Candidate) { return Candidate.ExperienceId == ExperienceId; });
+	if (Preload == nullptr)
+	{
+		Preload = &Preloads.AddDefaulted_GetRef();
+		Preload->ExperienceId = ExperienceId;
+		Preload->Source = Source;
+	}
+	else
+	{
+		Preload->Source = FMath::Max(Preload->Source, Source);
+	}
+	Preload->Sequence = ++NextSequence;
+
+	UpdatePreloads();
+}
+
+void ULyraExperiencePreloadSubsystem::AddUserFacingPreloadCandidate(const ULyraUserFacingExperienceDefinition* UserFacingExperience, ELyraExperiencePreloadSource Source)
+{
+	if (UserFacingExperience != nullptr)
+	{
+		AddPreloadCandidate(UserFacingExperience->ExperienceID, Source);
+	}
+}
+
+void ULyraExperiencePreloadSubsystem::RemovePreloadCandidates(ELyraExperiencePreloadSource Source)
+{
+	for (int32 PreloadIndex = Preloads.Num() - 1; PreloadIndex >= 0; --PreloadIndex)
+	{
+		FExperiencePreload& Preload = Preloads[PreloadIndex];
+		if ((Preload.Source == Source) && !Preload.bPinned)
+		{
+			ReleasePreload(Preload);
+			Preloads.RemoveAt(PreloadIndex);
+		}
+	}
+
+	UpdatePreloads();
+}
+
+void ULyraExperiencePreloadSubsystem::NotifyExperienceLoadStarted(const FPrimaryAssetId& ExperienceId)
+{
+	if (FExperiencePreload* Preload = Preloads.FindByPredicate([&ExperienceId](const FExperiencePreload& Candidate) { return Candidate.ExperienceId == ExperienceId; }))
+	{
+		UE_LOG(LogLyraExperience, Log, TEXT("EXPERIENCE PRELOAD: %s is being loaded (%s)"), *ExperienceId.ToString(), Preload->IsActive() ? TEXT("preloaded") : TEXT("not preloaded"));
+		Preload->bPinned = true;
+	}
+}
+
+void ULyraExperiencePreloadSubsystem::NotifyExperienceLoaded(const FPrimaryAssetId& ExperienceId)
+{
+	// The experience's bundle state keeps its assets loaded from now on
+	const int32 PreloadIndex = Preloads.IndexOfByPredicate([&ExperienceId](const FExperiencePreload& Candidate) { return Candidate.ExperienceId == ExperienceId; });
+	if (PreloadIndex != INDEX_NONE)
+	{
+		ReleasePreload(Preloads[PreloadIndex]);
+		Preloads.RemoveAt(PreloadIndex);
+
+		UpdatePreloads();
+	}
+}
+
+void ULyraExperiencePreloadSubsystem::NotifyExperienceLoadAborted(const FPrimaryAssetId& ExperienceId)
+{
+	if (FExperiencePreload* Preload = Preloads.FindByPredicate([&ExperienceId](const FExperiencePreload& Candidate) { return Candidate.ExperienceId == ExperienceId; }))
+	{
+		UE_LOG(LogLyraExperience, Log, TEXT("EXPERIENCE PRELOAD: Loading %s was aborted"), *ExperienceId.ToString());
+
+		// It stays a candidate (it was likely to be played a moment ago), competing for the budget like any other
+		Preload->bPinned = false;
+		UpdatePreloads();
+	}
+}
+
+void ULyraExperiencePreloadSubsystem::UpdatePreloads()
+{
+	// Pinned preloads first, then the most likely source, then the most recently added
+	Preloads.Sort([](const FExperiencePreload& A, const FExperiencePreload& B)
+	{
+		if (A.bPinned != B.bPinned)
+		{
+			return A.bPinned;
+		}
+		if (A.Source != B.Source)
+		{
+			return A.Source > B.Source;
+		}
+		return A.Sequence > B.Sequence;
+	});
+
+	const bool bLowOnMemory = IsLowOnMemory();
+	const int32 MaxSpeculativePreloads = LyraExperiencePreload::bEnablePreloading ? FMath::Max(LyraExperiencePreload::MaxPreloadedExperiences, 0) : 0;
+
+	int32 NumSpeculativePreloads = 0;
+	int32 LowestPriorityActiveIndex = INDEX_NONE;
+	for (int32 PreloadIndex = 0; PreloadIndex < Preloads.Num(); ++PreloadIndex)
+	{
+		FExperiencePreload& Preload = Preloads[PreloadIndex];
+		if (Preload.bPinned)
+		{
+			continue;
+		}
+
+		if (NumSpeculativePreloads >= MaxSpeculativePreloads)
+		{
+			// Pushed out of the budget by higher priority candidates
+			if (Preload.IsActive())
+			{
+				UE_LOG(LogLyraExperience, Verbose, TEXT("EXPERIENCE PRELOAD: Releasing %s, over budget"), *Preload.ExperienceId.ToString());
+				ReleasePreload(Preload);
+			}
+			continue;
+		}
+
+		++NumSpeculativePreloads;
+
+		if (!Preload.IsActive() && !bLowOnMemory)
+		{
+			StartPreload(Preload);
+		}
+
+		if (Preload.IsActive())
+		{
+			LowestPriorityActiveIndex = PreloadIndex;
+		}
+	}
+
+	// Give memory back one preload at a time, a released preload only frees its memory at the next garbage collection
+	if (bLowOnMemory && (LowestPriorityActiveIndex != INDEX_NONE))
+	{
+		FExperiencePreload& Preload = Preloads[LowestPriorityActiveIndex];
+		UE_LOG(LogLyraExperience, Log, TEXT("EXPERIENCE PRELOAD: Releasing %s, low on memory"), *Preload.ExperienceId.ToString());
+		ReleasePreload(Preload);
+	}
+}
+
+void ULyraExperiencePreloadSubsystem::StartPreload(FExperiencePreload& Preload)
+{
+	UE_LOG(LogLyraExperience, Log, TEXT("EXPERIENCE PRELOAD: Preloading %s"), *Preload.ExperienceId.ToString());
+
+	// Preloaded assets are not officially loaded, so this doesn't change the bundle state of the experience and releasing the handle frees them
+	Preload.ExperienceHandle = ULyraAssetManager::Get().PreloadPrimaryAssets({ Preload.ExperienceId }, GetBundlesToPreload(), /*bLoadRecursive=*/ false,
+		FStreamableDelegate::CreateUObject(this, &ThisClass::OnExperiencePreloaded, Preload.ExperienceId), FStreamableManager::AsyncLoadLowPriority);
+
+	if (!Preload.ExperienceHandle.IsValid())
+	{
+		// Nothing to load, the experience is resident already
+		return;
+	}
+
+	if (Preload.ExperienceHandle->HasLoadCompleted())
+	{
+		OnExperiencePreloaded(Preload.ExperienceId);
+	}
+}
+
+void ULyraExperiencePreloadSubsystem::ReleasePreload(FExperiencePreload& Preload)
+{
+	if (Preload.ExperienceHandle.IsValid())
+	{
+		Preload.ExperienceHandle->CancelHandle();
+		Preload.ExperienceHandle.Reset();
+	}
+
+	if (Preload.ActionSetHandle.IsValid())
+	{
+		Preload.ActionSetHandle->CancelHandle();
+		Preload.ActionSetHandle.Reset();
+	}
+
+	// A pinned experience is being loaded for real, its plugins belong to the experience manager component now. Otherwise only
+	// undo the install if nothing has moved the plugin past it since (e.g., another experience activating it).
+	if (!Preload.bPinned)
+	{
+		UGameFeaturesSubsystem& GameFeaturesSubsystem = UGameFeaturesSubsystem::Get();
+		for (const FString& PluginURL : Preload.InstalledPluginURLs)
+		{
+			if (GameFeaturesSubsystem.GetPluginState(PluginURL) == EGameFeaturePluginState::Installed)
+			{
+				UE_LOG(LogLyraExperience, Verbose, TEXT("EXPERIENCE PRELOAD: Uninstalling game feature plugin %s"), *PluginURL);
+				GameFeaturesSubsystem.UninstallGameFeaturePlugin(PluginURL, FGameFeaturePluginUninstallComplete());
+			}
+		}
+	}
+	Preload.InstalledPluginURLs.Reset();
+}
+
+void ULyraExperiencePreloadSubsystem::OnUserFacingExperiencesLoaded()
+{
+	TArray<UObject*> UserFacingExperiences;
+	ULyraAssetManager::Get().GetPrimaryAssetObjectList(ULyraUserFacingExperienceDefinition::StaticClass()->GetFName(), UserFacingExperiences);
+
+	for (UObject* Object : UserFacingExperiences)
+	{
+		const ULyraUserFacingExperienceDefinition* UserFacingExperience = Cast<ULyraUserFacingExperienceDefinition>(Object);
+		if ((UserFacingExperience != nullptr) && UserFacingExperience->bShowInFrontEnd)
+		{
+			AddUserFacingPreloadCandidate(UserFacingExperience, UserFacingExperience->bIsDefaultExperience ? ELyraExperiencePreloadSource::PlaylistDefault : ELyraExperiencePreloadSource::Playlist);
+		}
+	}
+}
+
+void ULyraExperiencePreloadSubsystem::OnExperiencePreloaded(FPrimaryAssetId ExperienceId)
+{
+	FExperiencePreload* Preload = Preloads.FindByPredicate([&ExperienceId](const FExperiencePreload& Candidate) { return Candidate.ExperienceId == ExperienceId; });
+	if ((Preload == nullptr) || !Preload->IsActive() || Preload->ActionSetHandle.IsValid())
+	{
+		return;
+	}
+
+	ULyraAssetManager& AssetManager = ULyraAssetManager::Get();
+
+	// Experiences are blueprints, the definition is the class default object (see ULyraExperienceManagerComponent::SetCurrentExperience)
+	const UClass* ExperienceClass = Cast<UClass>(AssetManager.GetPrimaryAssetPath(ExperienceId).ResolveObject());
+	const ULyraExperienceDefinition* Experience = (ExperienceClass != nullptr) ? GetDefault<ULyraExperienceDefinition>(ExperienceClass) : nullptr;
+	if (Experience == nullptr)
+	{
+		return;
+	}
+
+	TArray<FPrimaryAssetId> ActionSetIds;
+	TArray<FString> PluginNames = Experience->GameFeaturesToEnable;
+	for (const TObjectPtr<ULyraExperienceActionSet>& ActionSet : Experience->ActionSets)
+	{
+		if (ActionSet != nullptr)
+		{
+			ActionSetIds.Add(ActionSet->GetPrimaryAssetId());
+			PluginNames.Append(ActionSet->GameFeaturesToEnable);
+		}
+	}
+
+	// Game feature plugins are only brought up to Installed (downloaded), registering them would run their registration observers
+	// for an experience that may never be played. The experience manager component registers, loads and activates them.
+	UGameFeaturesSubsystem& GameFeaturesSubsystem = UGameFeaturesSubsystem::Get();
+	for (const FString& PluginName : PluginNames)
+	{
+		FString PluginURL;
+		if (!GameFeaturesSubsystem.GetPluginURLByName(PluginName, /*out*/ PluginURL) || (GameFeaturesSubsystem.GetPluginState(PluginURL) >= EGameFeaturePluginState::Installed))
+		{
+			continue;
+		}
+
+		const bool bInstalledByAnotherPreload = Preloads.ContainsByPredicate([&PluginURL](const FExperiencePreload& Other) { return Other.InstalledPluginURLs.Contains(PluginURL); });
+		if (!bInstalledByAnotherPreload)
+		{
+			UE_LOG(LogLyraExperience, Verbose, TEXT("EXPERIENCE PRELOAD: Installing game feature plugin %s"), *PluginURL);
+			Preload->InstalledPluginURLs.Add(PluginURL);
+			GameFeaturesSubsystem.ChangeGameFeatureTargetState(PluginURL, EGameFeatureTargetState::Installed,
+				FGameFeaturePluginChangeStateComplete::CreateUObject(this, &ThisClass::OnGameFeaturePluginInstalled, PluginURL));
+		}
+	}
+
+	if (ActionSetIds.Num() > 0)
+	{
+		Preload->ActionSetHandle = AssetManager.PreloadPrimaryAssets(ActionSetIds, GetBundlesToPreload(), /*bLoadRecursive=*/ false, FStreamableDelegate(), FStreamableManager::AsyncLoadLowPriority);
+	}
+}
+
+void ULyraExperiencePreloadSubsystem::OnGameFeaturePluginInstalled(const UE::GameFeatures::FResult& Result, FString PluginURL)
+{
+	if (Result.HasError())
+	{
+		UE_LOG(LogLyraExperience, Warning, TEXT("EXPERIENCE PRELOAD: Failed to install game feature plugin %s (%s)"), *PluginURL, *UE::GameFeatures::ToString(Result));
+
+		for (FExperiencePreload& Preload : Preloads)
+		{
+			Preload.InstalledPluginURLs.Remove(PluginURL);
+		}
+	}
+}
+
+void ULyraExperiencePreloadSubsystem::HandlePostLoadMap(UWorld* LoadedWorld)
+{
+	if ((LoadedWorld != nullptr) && (LoadedWorld->GetGameInstance() == GetGameInstance()))
+	{
+		UpdatePreloads();
+	}
+}
+
+bool ULyraExperiencePreloadSubsystem::HandleMemoryCheck(float DeltaTime)
+{
+	const bool bHasSpeculativePreloads = Preloads.ContainsByPredicate([](const FExperiencePreload& Preload) { return Preload.IsActive() && !Preload.bPinned; });
+	if (bHasSpeculativePreloads && IsLowOnMemory())
+	{
+		// Releases the lowest priority preload, the next check releases another one if that wasn't enough
+		UpdatePreloads();
+	}
+
+	return true;
+}
+
+void ULyraExperiencePreloadSubsystem::HandleMemoryTrim()
+{
+	UE_LOG(LogLyraExperience, Log, TEXT("EXPERIENCE PRELOAD: Releasing speculative preloads, memory warning"));
+	ReleaseSpeculativePreloads();
+}
+
+void ULyraExperiencePreloadSubsystem::ReleaseSpeculativePreloads()
+{
+	for (FExperiencePreload& Preload : Preloads)
+	{
+		if (!Preload.bPinned)
+		{
+			ReleasePreload(Preload);
+		}
+	}
+}
+
+TArray<FName> ULyraExperiencePreloadSubsystem::GetBundlesToPreload() const
+{
+	// Same bundles as ULyraExperienceManagerComponent::StartExperienceLoad, a client may end up hosting so it warms both sides
+	TArray<FName> BundlesToLoad;
+	BundlesToLoad.Add(FLyraBundles::Equipped);
+	if (!IsRunningDedicatedServer())
+	{
+		BundlesToLoad.Add(UGameFeaturesSubsystemSettings::LoadStateClient);
+	}
+	BundlesToLoad.Add(UGameFeaturesSubsystemSettings::LoadStateServer);
+	return BundlesToLoad;
+}
+
+bool ULyraExperiencePreloadSubsystem::IsLowOnMemory() const
+{
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	return MemoryStats.AvailablePhysical < (uint64)FMath::Max(LyraExperiencePreload::MinFreeMemoryMB, 0) * 1024 * 1024;
+}
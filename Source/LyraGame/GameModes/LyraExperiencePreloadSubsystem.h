@@ -0,0 +1,127 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Ticker.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "UObject/PrimaryAssetId.h"
+
+#include "LyraExperiencePreloadSubsystem.generated.h"
+
+class FSubsystemCollectionBase;
+class ULyraUserFacingExperienceDefinition;
+class UObject;
+class UWorld;
+struct FStreamableHandle;
+namespace UE::GameFeatures { struct FResult; }
+
+/** Where a preload candidate came from, later entries are more likely to be played next and are preloaded first */
+UENUM(BlueprintType)
+enum class ELyraExperiencePreloadSource : uint8
+{
+	// Shown in the front end playlist
+	Playlist,
+
+	// Default (quick play) experience of the front end playlist
+	PlaylistDefault,
+
+	// Hinted at by matchmaking
+	MatchmakingHint,
+
+	// Selected by the party host
+	PartyHostSelection
+};
+
+/**
+ * Speculatively warms the bundles of the experiences that are most likely to be played next (while in the front end or
+ * during the previous match), so ULyraExperienceManagerComponent finds them in memory once the experience is chosen.
+ *
+ * Candidates come from the user facing experiences shown in the front end, and from anything calling AddPreloadCandidate
+ * (party host selection, matchmaking hints). The assets of the highest priority candidates and their action sets are
+ * preloaded, and their game feature plugins are installed (downloaded) but not registered: registering a plugin runs
+ * registration observers (e.g., gameplay cue paths) for experiences that may never be played.
+ * Speculative preloads (assets and plugin installs) are released lowest priority first when they are pushed out of the budget or the platform is
+ * running low on memory (checked periodically), and all of them are released on memory warnings.
+ */
+UCLASS()
+class LYRAGAME_API ULyraExperiencePreloadSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
+	// Adds (or raises the priority of) an experience that is likely to be played next
+	UFUNCTION(BlueprintCallable, Category=Experience, meta=(AllowedTypes="LyraExperienceDefinition"))
+	void AddPreloadCandidate(FPrimaryAssetId ExperienceId, ELyraExperiencePreloadSource Source);
+
+	// Adds the experience of a user facing experience (e.g., the one the party host just selected)
+	UFUNCTION(BlueprintCallable, Category=Experience)
+	void AddUserFacingPreloadCandidate(const ULyraUserFacingExperienceDefinition* UserFacingExperience, ELyraExperiencePreloadSource Source);
+
+	// Removes all candidates that came from the specified source (e.g., when the party host changes their selection)
+	UFUNCTION(BlueprintCallable, Category=Experience)
+	void RemovePreloadCandidates(ELyraExperiencePreloadSource Source);
+
+	// Called when an experience starts loading for real, keeps its preload alive (and never evicts it) until it has loaded
+	void NotifyExperienceLoadStarted(const FPrimaryAssetId& ExperienceId);
+
+	// Called once an experience has loaded, it no longer needs to be preloaded
+	void NotifyExperienceLoaded(const FPrimaryAssetId& ExperienceId);
+
+	// Called when an experience load was abandoned before it completed (e.g., the world was torn down), unpins its preload
+	void NotifyExperienceLoadAborted(const FPrimaryAssetId& ExperienceId);
+
+private:
+	struct FExperiencePreload
+	{
+		FPrimaryAssetId ExperienceId;
+		ELyraExperiencePreloadSource Source = ELyraExperiencePreloadSource::Playlist;
+
+		// Order in which the candidate was last added, more recent candidates win ties
+		uint32 Sequence = 0;
+
+		// Set while the experience is being loaded by an experience manager component
+		bool bPinned = false;
+
+		// The experience itself, then its action sets once the experience has loaded
+		TSharedPtr<FStreamableHandle> ExperienceHandle;
+		TSharedPtr<FStreamableHandle> ActionSetHandle;
+
+		// Game feature plugins this preload brought up to Installed, undone when the preload is released
+		TArray<FString> InstalledPluginURLs;
+
+		bool IsActive() const { return ExperienceHandle.IsValid(); }
+	};
+
+	void UpdatePreloads();
+	void StartPreload(FExperiencePreload& Preload);
+	void ReleasePreload(FExperiencePreload& Preload);
+
+	void OnUserFacingExperiencesLoaded();
+	void OnExperiencePreloaded(FPrimaryAssetId ExperienceId);
+	void OnGameFeaturePluginInstalled(const UE::GameFeatures::FResult& Result, FString PluginURL);
+	void HandlePostLoadMap(UWorld* LoadedWorld);
+	bool HandleMemoryCheck(float DeltaTime);
+	void HandleMemoryTrim();
+
+	// Releases every preload that isn't pinned, keeping the candidates
+	void ReleaseSpeculativePreloads();
+
+	TArray<FName> GetBundlesToPreload() const;
+	bool IsLowOnMemory() const;
+
+	// Sorted by priority whenever the preloads are updated
+	TArray<FExperiencePreload> Preloads;
+
+	uint32 NextSequence = 0;
+
+	TSharedPtr<FStreamableHandle> UserFacingExperiencesHandle;
+
+	FDelegateHandle PostLoadMapHandle;
+	FDelegateHandle MemoryTrimHandle;
+	FTSTicker::FDelegateHandle MemoryCheckHandle;
+};
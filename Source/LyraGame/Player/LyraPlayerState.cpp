@@ -272,11 +272,13 @@ void ALyraPlayerState::OnRep_MySquadID()
 void ALyraPlayerState::AddStatTagStack(FGameplayTag Tag, int32 StackCount)
 {
 	StatTags.AddStack(Tag, StackCount);
+	LastStatTagChangeTime = GetWorld()->GetTimeSeconds();
 }
 
 void ALyraPlayerState::RemoveStatTagStack(FGameplayTag Tag, int32 StackCount)
 {
 	StatTags.RemoveStack(Tag, StackCount);
+	LastStatTagChangeTime = GetWorld()->GetTimeSeconds();
 }
 
 int32 ALyraPlayerState::GetStatTagStackCount(FGameplayTag Tag) const
@@ -121,6 +121,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category=Teams)
 	bool HasStatTag(FGameplayTag Tag) const;
 
+	// Returns the world time (in seconds) of the last stat tag stack change, only valid on the server
+	double GetLastStatTagChangeTime() const { return LastStatTagChangeTime; }
+
 	// Send a message to just this player
 	// (use only for client notifications like accolades, quest toasts, etc... that can handle being occasionally lost)
 	UFUNCTION(Client, Unreliable, BlueprintCallable, Category = "Lyra|PlayerState")
@@ -172,6 +175,9 @@ private:
 	UPROPERTY(Replicated)
 	FGameplayTagStackContainer StatTags;
 
+	// World time of the last AddStatTagStack/RemoveStatTagStack (used by the replication graph to prioritize recently changed player states)
+	double LastStatTagChangeTime = -UE_BIG_NUMBER;
+
 	UPROPERTY(Replicated)
 	FRotator ReplicatedViewRotation;
 
@@ -6,6 +6,7 @@
 #include "LyraGameData.h"
 #include "AbilitySystemGlobals.h"
 #include "Character/LyraPawnData.h"
+#include "Algo/AllOf.h"
 #include "Misc/App.h"
 #include "Stats/StatsMisc.h"
 #include "Engine/Engine.h"
@@ -110,11 +111,19 @@ void ULyraAssetManager::StartInitialLoading()
 	// This does all of the scanning, need to do this now even if loads are deferred
 	Super::StartInitialLoading();
 
+	// Loads are started first so they run while the synchronous jobs do their work
+	const int32 LoadGameDataJob = STARTUP_JOB_WEIGHTED(StartLoadingGameData(LoadHandle), 25.f);
+	const int32 LoadDefaultPawnDataJob = STARTUP_JOB_WEIGHTED(StartLoadingDefaultPawnData(LoadHandle), 5.f);
+
 	STARTUP_JOB(InitializeGameplayCueManager());
 
 	{
 		// Load base game data asset
-		STARTUP_JOB_WEIGHTED(GetGameData(), 25.f);
+		const int32 GameDataJob = STARTUP_JOB(GetGameData());
+		StartupJobs[GameDataJob].Dependencies.Add(LoadGameDataJob);
+
+		const int32 DefaultPawnDataJob = STARTUP_JOB(GetDefaultPawnData());
+		StartupJobs[DefaultPawnDataJob].Dependencies.Add(LoadDefaultPawnDataJob);
 	}
 
 	// Run all the queued up startup jobs
@@ -130,6 +139,22 @@ void ULyraAssetManager::InitializeGameplayCueManager()
 	GCM->LoadAlwaysLoadedCues();
 }
 
+void ULyraAssetManager::StartLoadingGameData(TSharedPtr<FStreamableHandle>& LoadHandle)
+{
+	// The editor loads game data synchronously on demand (see LoadGameDataOfClass)
+	if (!GIsEditor && !LyraGameDataPath.IsNull())
+	{
+		LoadHandle = LoadPrimaryAssetsWithType(ULyraGameData::StaticClass()->GetFName());
+	}
+}
+
+void ULyraAssetManager::StartLoadingDefaultPawnData(TSharedPtr<FStreamableHandle>& LoadHandle)
+{
+	if (!DefaultPawnData.IsNull())
+	{
+		LoadHandle = GetStreamableManager().RequestAsyncLoad(DefaultPawnData.ToSoftObjectPath());
+	}
+}
 
 const ULyraGameData& ULyraAssetManager::GetGameData()
 {
@@ -195,49 +220,131 @@ void ULyraAssetManager::DoAllStartupJobs()
 	SCOPED_BOOT_TIMING("ULyraAssetManager::DoAllStartupJobs");
 	const double AllStartupJobsStartTime = FPlatformTime::Seconds();
 
-	if (IsRunningDedicatedServer())
+	const int32 NumJobs = StartupJobs.Num();
+
+	// No need for periodic progress updates on a dedicated server
+	const bool bReportProgress = !IsRunningDedicatedServer();
+
+	float TotalJobValue = 0.0f;
+	for (const FLyraAssetManagerStartupJob& StartupJob : StartupJobs)
 	{
-		// No need for periodic progress updates, just run the jobs
-		for (const FLyraAssetManagerStartupJob& StartupJob : StartupJobs)
+		TotalJobValue += StartupJob.JobWeight;
+	}
+
+	// Progress of every job from 0 to 1, weighted by the job weights for the overall progress
+	TArray<float> JobProgress;
+	JobProgress.SetNumZeroed(NumJobs);
+
+	auto UpdateOverallProgress = [this, &JobProgress, TotalJobValue]()
+	{
+		float AccumulatedJobValue = 0.0f;
+		for (int32 JobIndex = 0; JobIndex < StartupJobs.Num(); ++JobIndex)
 		{
-			StartupJob.DoJob();
+			AccumulatedJobValue += JobProgress[JobIndex] * StartupJobs[JobIndex].JobWeight;
 		}
-	}
-	else
+
+		UpdateInitialGameContentLoadPercent((TotalJobValue > 0.0f) ? (AccumulatedJobValue / TotalJobValue) : 1.0f);
+	};
+
+	TBitArray<> StartedJobs(false, NumJobs);
+	TBitArray<> FinishedJobs(false, NumJobs);
+	TArray<TSharedPtr<FStreamableHandle>> JobHandles;
+	JobHandles.SetNum(NumJobs);
+	TArray<TUniquePtr<FScopedBootTiming>> JobBootTimings;
+	JobBootTimings.SetNum(NumJobs);
+
+	auto FinishJob = [&](int32 JobIndex)
 	{
-		if (StartupJobs.Num() > 0)
+		FLyraAssetManagerStartupJob& StartupJob = StartupJobs[JobIndex];
+		StartupJob.FinishJob(JobHandles[JobIndex]);
+		StartupJob.SubstepProgressDelegate.Unbind();
+		JobHandles[JobIndex].Reset();
+		JobBootTimings[JobIndex].Reset();
+
+		FinishedJobs[JobIndex] = true;
+		JobProgress[JobIndex] = 1.0f;
+
+		if (bReportProgress)
 		{
-			float TotalJobValue = 0.0f;
-			for (const FLyraAssetManagerStartupJob& StartupJob : StartupJobs)
+			UpdateOverallProgress();
+		}
+	};
+
+	// Start every job as soon as the jobs it depends on are done. Jobs that start a load don't wait for it,
+	// so independent loads are in flight together (and with the synchronous jobs) instead of one after the other.
+	int32 NumFinishedJobs = 0;
+	while (NumFinishedJobs < NumJobs)
+	{
+		bool bStartedAnyJob = false;
+		for (int32 JobIndex = 0; JobIndex < NumJobs; ++JobIndex)
+		{
+			FLyraAssetManagerStartupJob& StartupJob = StartupJobs[JobIndex];
+			if (StartedJobs[JobIndex])
 			{
-				TotalJobValue += StartupJob.JobWeight;
+				continue;
 			}
 
-			float AccumulatedJobValue = 0.0f;
-			for (FLyraAssetManagerStartupJob& StartupJob : StartupJobs)
+			const bool bDependenciesDone = Algo::AllOf(StartupJob.Dependencies, [&](int32 DependencyIndex)
 			{
-				const float JobValue = StartupJob.JobWeight;
-				StartupJob.SubstepProgressDelegate.BindLambda([This = this, AccumulatedJobValue, JobValue, TotalJobValue](float NewProgress)
-					{
-						const float SubstepAdjustment = FMath::Clamp(NewProgress, 0.0f, 1.0f) * JobValue;
-						const float OverallPercentWithSubstep = (AccumulatedJobValue + SubstepAdjustment) / TotalJobValue;
+				// Only earlier jobs can be depended on, which also means there can't be any cycles
+				return !ensureMsgf(StartupJobs.IsValidIndex(DependencyIndex) && (DependencyIndex < JobIndex), TEXT("Startup job \"%s\" has an invalid dependency %d"), *StartupJob.JobName, DependencyIndex)
+					|| FinishedJobs[DependencyIndex];
+			});
 
-						This->UpdateInitialGameContentLoadPercent(OverallPercentWithSubstep);
-					});
+			if (!bDependenciesDone)
+			{
+				continue;
+			}
 
-				StartupJob.DoJob();
+			if (bReportProgress)
+			{
+				StartupJob.SubstepProgressDelegate.BindLambda([&JobProgress, JobIndex, UpdateOverallProgress](float NewProgress)
+					{
+						JobProgress[JobIndex] = FMath::Clamp(NewProgress, 0.0f, 1.0f);
+						UpdateOverallProgress();
+					});
+			}
 
-				StartupJob.SubstepProgressDelegate.Unbind();
+			StartedJobs[JobIndex] = true;
+			bStartedAnyJob = true;
 
-				AccumulatedJobValue += JobValue;
+			JobBootTimings[JobIndex] = MakeUnique<FScopedBootTiming>("ULyraAssetManager::StartupJob", FName(*StartupJob.JobName));
+			JobHandles[JobIndex] = StartupJob.StartJob();
 
-				UpdateInitialGameContentLoadPercent(AccumulatedJobValue / TotalJobValue);
+			if (!JobHandles[JobIndex].IsValid() || JobHandles[JobIndex]->HasLoadCompletedOrStalled())
+			{
+				FinishJob(JobIndex);
+				++NumFinishedJobs;
 			}
 		}
-		else
+
+		if (bStartedAnyJob)
 		{
-			UpdateInitialGameContentLoadPercent(1.0f);
+			continue;
 		}
+
+		// Nothing else can start until a load completes. Waiting for the first load keeps all the others going too.
+		const int32 WaitJobIndex = JobHandles.IndexOfByPredicate([](const TSharedPtr<FStreamableHandle>& Handle) { return Handle.IsValid(); });
+		if (!ensure(WaitJobIndex != INDEX_NONE))
+		{
+			break;
+		}
+
+		JobHandles[WaitJobIndex]->WaitUntilComplete(0.0f, false);
+
+		for (int32 JobIndex = 0; JobIndex < NumJobs; ++JobIndex)
+		{
+			if (JobHandles[JobIndex].IsValid() && JobHandles[JobIndex]->HasLoadCompletedOrStalled())
+			{
+				FinishJob(JobIndex);
+				++NumFinishedJobs;
+			}
+		}
+	}
+
+	if (bReportProgress)
+	{
+		UpdateInitialGameContentLoadPercent(1.0f);
 	}
 
 	StartupJobs.Empty();
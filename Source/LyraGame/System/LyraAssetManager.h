@@ -101,6 +101,10 @@ private:
 	// Sets up the ability system
 	void InitializeGameplayCueManager();
 
+	// Start async loads of the game data and default pawn data, so the jobs that need them don't have to load them one after the other
+	void StartLoadingGameData(TSharedPtr<FStreamableHandle>& LoadHandle);
+	void StartLoadingDefaultPawnData(TSharedPtr<FStreamableHandle>& LoadHandle);
+
 	// Called periodically during loads, could be used to feed the status to a loading screen
 	void UpdateInitialGameContentLoadPercent(float GameContentPercent);
 
@@ -14,6 +14,10 @@ struct FLyraAssetManagerStartupJob
 	FString JobName;
 	float JobWeight;
 	mutable double LastUpdate = 0;
+	mutable double JobStartTime = 0;
+
+	/** Indices of the startup jobs that have to be done before this one starts (they have to be added before this one) */
+	TArray<int32> Dependencies;
 
 	/** Simple job that is all synchronous */
 	FLyraAssetManagerStartupJob(const FString& InJobName, const TFunction<void(const FLyraAssetManagerStartupJob&, TSharedPtr<FStreamableHandle>&)>& InJobFunc, float InJobWeight)
@@ -25,6 +29,12 @@ struct FLyraAssetManagerStartupJob
 	/** Perform actual loading, will return a handle if it created one */
 	TSharedPtr<FStreamableHandle> DoJob() const;
 
+	/** Runs the job function without waiting for the load it starts, returns the handle of that load if it created one */
+	TSharedPtr<FStreamableHandle> StartJob() const;
+
+	/** Called once the load started by StartJob (if any) has completed */
+	void FinishJob(const TSharedPtr<FStreamableHandle>& Handle) const;
+
 	void UpdateSubstepProgress(float NewProgress) const
 	{
 		SubstepProgressDelegate.ExecuteIfBound(NewProgress);
@@ -36,7 +46,7 @@ struct FLyraAssetManagerStartupJob
 		{
 			// StreamableHandle::GetProgress traverses() a large graph and is quite expensive
 			double Now = FPlatformTime::Seconds();
-			if (LastUpdate - Now > 1.0 / 60)
+			if (Now - LastUpdate > 1.0 / 60)
 			{
 				SubstepProgressDelegate.Execute(StreamableHandle->GetProgress());
 				LastUpdate = Now;
@@ -33,12 +33,16 @@
 *		ULyraReplicationGraphNode_AlwaysRelevant_ForConnection
 *		This is the node for connection specific always relevant actors. This node does not maintain a persistent list but builds it each frame. This is possible because (currently)
 *		these actors are all easily accessed from the PlayerController. A persistent list would require notifications to be broadcast when these actors change, which would be possible
-*		but currently not necessary.
+*		but currently not necessary. This node also returns the simulated proxy player states that matter most to this connection (teammates, nearby enemies and players whose
+*		stats just changed) at their own higher rates, and takes the remaining low priority player states from the rolling buckets of
+*		ULyraReplicationGraphNode_PlayerStateFrequencyLimiter at a lower rate.
 *		
 *		ULyraReplicationGraphNode_PlayerStateFrequencyLimiter
-*		A custom node for handling player state replication. This replicates a small rolling set of player states (currently 2/frame). This is so player states replicate
+*		A custom node for handling player state replication. This holds a small rolling set of player states (currently 2/frame), gathered for each connection by
+*		ULyraReplicationGraphNode_AlwaysRelevant_ForConnection minus the player states it already replicates at a higher rate. This is so player states replicate
 *		to simulated connections at a low, steady frequency, and to take advantage of serialization sharing. Auto proxy player states are replicated at higher frequency (to the
-*		owning connection only) via ULyraReplicationGraphNode_AlwaysRelevant_ForConnection.
+*		owning connection only) via ULyraReplicationGraphNode_AlwaysRelevant_ForConnection. Player states are NotRouted, but ULyraReplicationGraph forwards their add/remove
+*		notifications to this node so it can maintain its buckets persistently.
 *		
 *		UReplicationGraphNode_TearOff_ForConnection
 *		Connection specific node for handling tear off actors. This is created and managed in the base implementation of Replication Graph.
@@ -65,6 +69,10 @@
 *		Net.RepGraph.PrintAllActorInfo <ActorMatchString> - will print the class, global, and connection replication info associated with an actor/class. If MatchString is empty will print everything. Call directly from client.
 *		
 *		Lyra.RepGraph.PrintRouting - will print the EClassRepNodeMapping for each class. That is, how a given actor class is routed (or not) in the Replication Graph.
+*
+*		Lyra.RepGraph.Telemetry.Enable 1 - starts recording, per connection and per class, the bytes sent, actors considered vs. replicated and the gather/prioritize time.
+*		The per frame totals (split by EClassRepNodeMapping) are also written to the LyraRepGraph CSV profiler category.
+*		Lyra.RepGraph.Telemetry.Print <MaxClasses> - prints what was recorded so far, with the most expensive classes of each connection. Lyra.RepGraph.Telemetry.Reset clears it.
 *	
 */
 
@@ -85,14 +93,25 @@
 #include "GameFramework/Pawn.h"
 #include "Engine/LevelScriptActor.h"
 #include "Engine/NetConnection.h"
+#include "ProfilingDebugging/CsvProfiler.h"
 #include "UObject/UObjectIterator.h"
 
 #include "LyraReplicationGraphSettings.h"
 #include "Character/LyraCharacter.h"
 #include "Player/LyraPlayerController.h"
+#include "Player/LyraPlayerState.h"
+#include "Teams/LyraTeamSubsystem.h"
 
 DEFINE_LOG_CATEGORY( LogLyraRepGraph );
 
+DECLARE_STATS_GROUP(TEXT("LyraRepGraph"), STATGROUP_LyraRepGraph, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Lyra.RepGraph.PlayerStateLimiter.Prepare"), STAT_LyraRepGraph_PlayerStateLimiter_Prepare, STATGROUP_LyraRepGraph);
+DECLARE_CYCLE_STAT(TEXT("Lyra.RepGraph.PlayerStateLimiter.Rebalance"), STAT_LyraRepGraph_PlayerStateLimiter_Rebalance, STATGROUP_LyraRepGraph);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Lyra.RepGraph.PlayerStateLimiter.NumPlayerStates"), STAT_LyraRepGraph_PlayerStateLimiter_NumPlayerStates, STATGROUP_LyraRepGraph);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Lyra.RepGraph.PlayerStateLimiter.NumBuckets"), STAT_LyraRepGraph_PlayerStateLimiter_NumBuckets, STATGROUP_LyraRepGraph);
+
+CSV_DEFINE_CATEGORY(LyraRepGraph, false);
+
 namespace Lyra::RepGraph
 {
 	float DestructionInfoMaxDist = 30000.f;
@@ -132,6 +151,59 @@ namespace Lyra::RepGraph
 	int32 EnableFastSharedPath = 1;
 	static FAutoConsoleVariableRef CVarLyraRepEnableFastSharedPath(TEXT("Lyra.RepGraph.EnableFastSharedPath"), EnableFastSharedPath, TEXT(""), ECVF_Default);
 
+	int32 EnableTelemetry = 0;
+	static FAutoConsoleVariableRef CVarLyraRepEnableTelemetry(TEXT("Lyra.RepGraph.Telemetry.Enable"), EnableTelemetry, TEXT("Records per connection and per class replication cost. See Lyra.RepGraph.Telemetry.Print"), ECVF_Default);
+
+	int32 PlayerStatePriorityUpdatePeriod = 10;
+	static FAutoConsoleVariableRef CVarLyraRepPlayerStatePriorityUpdatePeriod(TEXT("Lyra.RepGraph.PlayerState.PriorityUpdatePeriod"), PlayerStatePriorityUpdatePeriod, TEXT("How many frames between re-evaluating the simulated proxy player state priorities of a connection"), ECVF_Default);
+
+	int32 PlayerStateHighPriorityPeriod = 2;
+	static FAutoConsoleVariableRef CVarLyraRepPlayerStateHighPriorityPeriod(TEXT("Lyra.RepGraph.PlayerState.HighPriorityPeriod"), PlayerStateHighPriorityPeriod, TEXT("Replication period (in frames) for the owning and high priority player states"), ECVF_Default);
+
+	int32 PlayerStateMediumPriorityPeriod = 6;
+	static FAutoConsoleVariableRef CVarLyraRepPlayerStateMediumPriorityPeriod(TEXT("Lyra.RepGraph.PlayerState.MediumPriorityPeriod"), PlayerStateMediumPriorityPeriod, TEXT("Replication period (in frames) for medium priority player states"), ECVF_Default);
+
+	float PlayerStateNearDistance = 5000.f;
+	static FAutoConsoleVariableRef CVarLyraRepPlayerStateNearDistance(TEXT("Lyra.RepGraph.PlayerState.NearDistance"), PlayerStateNearDistance, TEXT("Enemies closer than this (not squared) to a viewer are high priority"), ECVF_Default);
+
+	float PlayerStateMediumDistance = 15000.f;
+	static FAutoConsoleVariableRef CVarLyraRepPlayerStateMediumDistance(TEXT("Lyra.RepGraph.PlayerState.MediumDistance"), PlayerStateMediumDistance, TEXT("Enemies closer than this (not squared) to a viewer are medium priority"), ECVF_Default);
+
+	int32 PlayerStateLowPriorityPeriod = 2;
+	static FAutoConsoleVariableRef CVarLyraRepPlayerStateLowPriorityPeriod(TEXT("Lyra.RepGraph.PlayerState.LowPriorityPeriod"), PlayerStateLowPriorityPeriod, TEXT("How many frames between taking a connection's low priority player states from the rolling buckets"), ECVF_Default);
+
+	float PlayerStateRecentStatChangeTime = 2.f;
+	static FAutoConsoleVariableRef CVarLyraRepPlayerStateRecentStatChangeTime(TEXT("Lyra.RepGraph.PlayerState.RecentStatChangeTime"), PlayerStateRecentStatChangeTime, TEXT("Player states whose stat tags changed within this many seconds are high priority"), ECVF_Default);
+
+	// Adds the time spent in its scope to the gather time of the connection, while telemetry is being recorded
+	struct FScopedGatherTelemetry
+	{
+		FScopedGatherTelemetry(const UReplicationGraphNode* Node, const FConnectionGatherActorListParameters& Params)
+			: Graph(EnableTelemetry ? Cast<ULyraReplicationGraph>(Node->GetOuter()) : nullptr)
+			, ConnectionManager(Params.ConnectionManager)
+			, StartSeconds(Graph ? FPlatformTime::Seconds() : 0.0)
+		{
+		}
+
+		~FScopedGatherTelemetry()
+		{
+			if (Graph)
+			{
+				Graph->RecordGatherSeconds(ConnectionManager, FPlatformTime::Seconds() - StartSeconds);
+			}
+		}
+
+		ULyraReplicationGraph* Graph;
+		const UNetReplicationGraphConnection& ConnectionManager;
+		double StartSeconds;
+	};
+
+	// Returns true on the frames a list with the given period should be gathered for this connection. Connections are staggered so they don't all replicate the same frame.
+	static bool IsPeriodDue(const FConnectionGatherActorListParameters& Params, int32 Period)
+	{
+		return Period <= 1 || ((Params.ReplicationFrameNum + Params.ConnectionManager.ConnectionOrderNum) % (uint32)Period) == 0;
+	}
+
 	UReplicationDriver* ConditionalCreateReplicationDriver(UNetDriver* ForNetDriver, UWorld* World)
 	{
 		// Only create for GameNetDriver
@@ -535,7 +607,7 @@ void ULyraReplicationGraph::InitGlobalGraphNodes()
 	//	Spatial Actors
 	// -----------------------------------------------
 
-	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode = CreateNewNode<ULyraReplicationGraphNode_GridSpatialization2D>();
 	GridNode->CellSize = Lyra::RepGraph::CellSize;
 	GridNode->SpatialBias = FVector2D(Lyra::RepGraph::SpatialBiasX, Lyra::RepGraph::SpatialBiasY);
 
@@ -555,7 +627,7 @@ void ULyraReplicationGraph::InitGlobalGraphNodes()
 	// -----------------------------------------------
 	//	Player State specialization. This will return a rolling subset of the player states to replicate
 	// -----------------------------------------------
-	ULyraReplicationGraphNode_PlayerStateFrequencyLimiter* PlayerStateNode = CreateNewNode<ULyraReplicationGraphNode_PlayerStateFrequencyLimiter>();
+	PlayerStateNode = CreateNewNode<ULyraReplicationGraphNode_PlayerStateFrequencyLimiter>();
 	AddGlobalGraphNode(PlayerStateNode);
 }
 
@@ -586,6 +658,11 @@ void ULyraReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActo
 	{
 		case EClassRepNodeMapping::NotRouted:
 		{
+			// Player states are not routed to the generic nodes, but the frequency limiter keeps a persistent list of them
+			if (PlayerStateNode && ActorInfo.Class->IsChildOf(APlayerState::StaticClass()))
+			{
+				PlayerStateNode->NotifyAddNetworkActor(ActorInfo);
+			}
 			break;
 		}
 		
@@ -630,6 +707,11 @@ void ULyraReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedA
 	{
 		case EClassRepNodeMapping::NotRouted:
 		{
+			if (PlayerStateNode && ActorInfo.Class->IsChildOf(APlayerState::StaticClass()))
+			{
+				PlayerStateNode->NotifyRemoveNetworkActor(ActorInfo);
+				NotifyPlayerStateRemoved(ActorInfo.GetActor());
+			}
 			break;
 		}
 		
@@ -673,6 +755,27 @@ void ULyraReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedA
 	};
 }
 
+void ULyraReplicationGraph::NotifyPlayerStateRemoved(AActor* PlayerState)
+{
+	// The per connection nodes keep prioritized lists of player states, make sure they don't hold on to this one
+	auto RemoveFromConnections = [PlayerState](const auto& ConnectionManagers)
+	{
+		for (UNetReplicationGraphConnection* ConnManager : ConnectionManagers)
+		{
+			for (UReplicationGraphNode* ConnectionNode : ConnManager->GetConnectionGraphNodes())
+			{
+				if (ULyraReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantConnectionNode = Cast<ULyraReplicationGraphNode_AlwaysRelevant_ForConnection>(ConnectionNode))
+				{
+					AlwaysRelevantConnectionNode->OnPlayerStateRemoved(PlayerState);
+				}
+			}
+		}
+	};
+
+	RemoveFromConnections(Connections);
+	RemoveFromConnections(PendingConnections);
+}
+
 // Since we listen to global (static) events, we need to watch out for cross world broadcasts (PIE)
 #if WITH_EDITOR
 #define CHECK_WORLDS(X) if(X->GetWorld() != GetWorld()) return;
@@ -730,14 +833,97 @@ void ULyraReplicationGraphNode_AlwaysRelevant_ForConnection::ResetGameWorldState
 {
 	ReplicationActorList.Reset();
 	AlwaysRelevantStreamingLevelsNeedingReplication.Empty();
+	HighPriorityPlayerStates.Reset();
+	MediumPriorityPlayerStates.Reset();
+	LowPriorityPlayerStates.Reset();
+	bHasPlayerStatePriorities = false;
+}
+
+void ULyraReplicationGraphNode_AlwaysRelevant_ForConnection::OnPlayerStateRemoved(AActor* PlayerState)
+{
+	HighPriorityPlayerStates.RemoveFast(PlayerState);
+	MediumPriorityPlayerStates.RemoveFast(PlayerState);
+	LowPriorityPlayerStates.RemoveFast(PlayerState);
+}
+
+void ULyraReplicationGraphNode_AlwaysRelevant_ForConnection::UpdatePlayerStatePriorities(const FConnectionGatherActorListParameters& Params, const AActor* TeamViewer, TConstArrayView<FVector> ViewerLocations)
+{
+	HighPriorityPlayerStates.Reset();
+	MediumPriorityPlayerStates.Reset();
+	bHasPlayerStatePriorities = true;
+
+	UWorld* World = GetWorld();
+	AGameStateBase* GameState = World ? World->GetGameState() : nullptr;
+	if (!GameState)
+	{
+		return;
+	}
+
+	const ULyraTeamSubsystem* TeamSubsystem = World->GetSubsystem<ULyraTeamSubsystem>();
+	const int32 ViewerTeamId = (TeamSubsystem && TeamViewer) ? TeamSubsystem->FindTeamFromObject(TeamViewer) : INDEX_NONE;
+
+	const double CurrentTime = World->GetTimeSeconds();
+	const double NearDistSq = FMath::Square((double)Lyra::RepGraph::PlayerStateNearDistance);
+	const double MediumDistSq = FMath::Square((double)Lyra::RepGraph::PlayerStateMediumDistance);
+
+	for (APlayerState* PS : GameState->PlayerArray)
+	{
+		// The owning player state is handled separately and everything that doesn't make it into a list here is low priority (rolling buckets)
+		if (!PS || PS->GetOwner() == TeamViewer || !IsActorValidForReplicationGather(PS))
+		{
+			continue;
+		}
+
+		if (const ALyraPlayerState* LyraPS = Cast<ALyraPlayerState>(PS))
+		{
+			if ((CurrentTime - LyraPS->GetLastStatTagChangeTime()) < Lyra::RepGraph::PlayerStateRecentStatChangeTime)
+			{
+				HighPriorityPlayerStates.Add(PS);
+				continue;
+			}
+		}
+
+		if (TeamSubsystem && (ViewerTeamId != INDEX_NONE) && (TeamSubsystem->FindTeamFromObject(PS) == ViewerTeamId))
+		{
+			HighPriorityPlayerStates.Add(PS);
+			continue;
+		}
+
+		if (const APawn* Pawn = PS->GetPawn())
+		{
+			const FVector PawnLocation = Pawn->GetActorLocation();
+
+			double ClosestDistSq = UE_BIG_NUMBER;
+			for (const FVector& ViewerLocation : ViewerLocations)
+			{
+				ClosestDistSq = FMath::Min(ClosestDistSq, FVector::DistSquared(PawnLocation, ViewerLocation));
+			}
+
+			if (ClosestDistSq < NearDistSq)
+			{
+				HighPriorityPlayerStates.Add(PS);
+			}
+			else if (ClosestDistSq < MediumDistSq)
+			{
+				MediumPriorityPlayerStates.Add(PS);
+			}
+		}
+	}
 }
 
 void ULyraReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
 {
+	Lyra::RepGraph::FScopedGatherTelemetry GatherTelemetry(this, Params);
+
 	ULyraReplicationGraph* LyraGraph = CastChecked<ULyraReplicationGraph>(GetOuter());
 
 	ReplicationActorList.Reset();
 
+	const bool bHighPriorityPlayerStatesDue = Lyra::RepGraph::IsPeriodDue(Params, Lyra::RepGraph::PlayerStateHighPriorityPeriod);
+
+	const AActor* TeamViewer = nullptr;
+	TArray<FVector, TInlineAllocator<4>> ViewerLocations;
+
 	for (const FNetViewer& CurViewer : Params.Viewers)
 	{
 		ReplicationActorList.ConditionalAdd(CurViewer.InViewer);
@@ -745,9 +931,16 @@ void ULyraReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsFor
 
 		if (ALyraPlayerController* PC = Cast<ALyraPlayerController>(CurViewer.InViewer))
 		{
-			// 50% throttling of PlayerStates.
-			const bool bReplicatePS = (Params.ConnectionManager.ConnectionOrderNum % 2) == (Params.ReplicationFrameNum % 2);
-			if (bReplicatePS)
+			if (!TeamViewer)
+			{
+				TeamViewer = PC;
+			}
+
+			const APawn* ViewerPawn = PC->GetPawn();
+			ViewerLocations.Add(ViewerPawn ? ViewerPawn->GetActorLocation() : CurViewer.ViewLocation);
+
+			// The owning player state is always high priority
+			if (bHighPriorityPlayerStatesDue)
 			{
 				// Always return the player state to the owning player. Simulated proxy player states are handled by ULyraReplicationGraphNode_PlayerStateFrequencyLimiter
 				if (APlayerState* PS = PC->PlayerState)
@@ -784,6 +977,58 @@ void ULyraReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsFor
 
 	CleanupCachedRelevantActors(PastRelevantActorMap);
 
+	// Simulated proxy player states that matter to this connection. Re-sorting them is staggered across connections since it walks every player state.
+	if (TeamViewer)
+	{
+		if (!bHasPlayerStatePriorities || Lyra::RepGraph::IsPeriodDue(Params, Lyra::RepGraph::PlayerStatePriorityUpdatePeriod))
+		{
+			UpdatePlayerStatePriorities(Params, TeamViewer, ViewerLocations);
+		}
+
+		if (bHighPriorityPlayerStatesDue && HighPriorityPlayerStates.Num() > 0)
+		{
+			Params.OutGatheredReplicationLists.AddReplicationActorList(HighPriorityPlayerStates);
+		}
+
+		if (MediumPriorityPlayerStates.Num() > 0 && Lyra::RepGraph::IsPeriodDue(Params, Lyra::RepGraph::PlayerStateMediumPriorityPeriod))
+		{
+			Params.OutGatheredReplicationLists.AddReplicationActorList(MediumPriorityPlayerStates);
+		}
+	}
+
+	// Everything else comes from the rolling buckets. Connections that prioritize player states walk the buckets at a lower rate, one bucket every
+	// PlayerStateLowPriorityPeriod frames (staggered like the other periods), and leave out the player states they already gathered above.
+	if (ULyraReplicationGraphNode_PlayerStateFrequencyLimiter* PlayerStateNode = LyraGraph->PlayerStateNode)
+	{
+		if (!bHasPlayerStatePriorities)
+		{
+			const FActorRepListRefView& Bucket = PlayerStateNode->GetValidBucket(Params.ReplicationFrameNum, Params.ReplicationFrameNum);
+			if (Bucket.Num() > 0)
+			{
+				Params.OutGatheredReplicationLists.AddReplicationActorList(Bucket);
+			}
+		}
+		else if (Lyra::RepGraph::IsPeriodDue(Params, Lyra::RepGraph::PlayerStateLowPriorityPeriod))
+		{
+			const uint32 LowPriorityPeriod = (uint32)FMath::Max(Lyra::RepGraph::PlayerStateLowPriorityPeriod, 1);
+			const uint32 BucketCycle = (Params.ReplicationFrameNum + Params.ConnectionManager.ConnectionOrderNum) / LowPriorityPeriod;
+
+			LowPriorityPlayerStates.Reset();
+			for (FActorRepListType Actor : PlayerStateNode->GetValidBucket(Params.ReplicationFrameNum, BucketCycle))
+			{
+				if (!HighPriorityPlayerStates.Contains(Actor) && !MediumPriorityPlayerStates.Contains(Actor))
+				{
+					LowPriorityPlayerStates.Add(Actor);
+				}
+			}
+
+			if (LowPriorityPlayerStates.Num() > 0)
+			{
+				Params.OutGatheredReplicationLists.AddReplicationActorList(LowPriorityPlayerStates);
+			}
+		}
+	}
+
 	// Always relevant streaming level actors.
 	FPerConnectionActorInfoMap& ConnectionActorInfoMap = Params.ConnectionManager.ActorInfoMap;
 	
@@ -862,6 +1107,9 @@ void ULyraReplicationGraphNode_AlwaysRelevant_ForConnection::LogNode(FReplicatio
 	DebugInfo.Log(NodeName);
 	DebugInfo.PushIndent();
 	LogActorRepList(DebugInfo, NodeName, ReplicationActorList);
+	LogActorRepList(DebugInfo, TEXT("High Priority PlayerStates"), HighPriorityPlayerStates);
+	LogActorRepList(DebugInfo, TEXT("Medium Priority PlayerStates"), MediumPriorityPlayerStates);
+	LogActorRepList(DebugInfo, TEXT("Low Priority PlayerStates"), LowPriorityPlayerStates);
 
 	for (const FName& LevelName : AlwaysRelevantStreamingLevelsNeedingReplication)
 	{
@@ -882,40 +1130,135 @@ ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::ULyraReplicationGraphNode
 	bRequiresPrepareForReplicationCall = true;
 }
 
-void ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::PrepareForReplication()
+void ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	if (ReplicationActorLists.Num() == 0 || ReplicationActorLists.Last().Num() >= TargetActorsPerFrame)
+	{
+		ReplicationActorLists.AddDefaulted();
+	}
+
+	ReplicationActorLists.Last().Add(ActorInfo.Actor);
+	++NumTrackedActors;
+}
+
+bool ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	ForceNetUpdateReplicationActorList.RemoveFast(ActorInfo.Actor);
+	ValidBucketActorList.RemoveFast(ActorInfo.Actor);
+
+	for (FActorRepListRefView& List : ReplicationActorLists)
+	{
+		if (List.RemoveFast(ActorInfo.Actor))
+		{
+			// Leave the hole for now, the buckets get compacted the next time we prepare for replication
+			--NumTrackedActors;
+			bBucketsNeedRebalance = true;
+			return true;
+		}
+	}
+
+	UE_CLOG(bWarnIfNotFound, LogLyraRepGraph, Warning, TEXT("ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::NotifyRemoveNetworkActor - %s was not found in any bucket"), *GetActorRepListTypeDebugString(ActorInfo.Actor));
+	return false;
+}
+
+void ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::NotifyResetAllNetworkActors()
 {
 	ReplicationActorLists.Reset();
 	ForceNetUpdateReplicationActorList.Reset();
+	ValidBucketActorList.Reset();
+	bHasValidBucketActorList = false;
+	NumTrackedActors = 0;
+	bBucketsNeedRebalance = false;
+}
+
+void ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::PrepareForReplication()
+{
+	SCOPE_CYCLE_COUNTER(STAT_LyraRepGraph_PlayerStateLimiter_Prepare);
+
+	ForceNetUpdateReplicationActorList.Reset();
+	bHasValidBucketActorList = false;
+
+	// The buckets are persistent. We only need to touch them when a player left (leaving a hole) or the target bucket size changed.
+	if (bBucketsNeedRebalance || BalancedTargetActorsPerFrame != TargetActorsPerFrame)
+	{
+		RebalanceBuckets();
+	}
 
-	ReplicationActorLists.AddDefaulted();
-	FActorRepListRefView* CurrentList = &ReplicationActorLists[0];
+	SET_DWORD_STAT(STAT_LyraRepGraph_PlayerStateLimiter_NumPlayerStates, NumTrackedActors);
+	SET_DWORD_STAT(STAT_LyraRepGraph_PlayerStateLimiter_NumBuckets, ReplicationActorLists.Num());
+}
 
-	// We rebuild our lists of player states each frame. This is not as efficient as it could be but its the simplest way
-	// to handle players disconnecting and keeping the lists compact. If the lists were persistent we would need to defrag them as players left.
+void ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::RebalanceBuckets()
+{
+	SCOPE_CYCLE_COUNTER(STAT_LyraRepGraph_PlayerStateLimiter_Rebalance);
 
-	for (TActorIterator<APlayerState> It(GetWorld()); It; ++It)
+	const int32 BucketSize = FMath::Max(TargetActorsPerFrame, 1);
+	const int32 NumBuckets = FMath::DivideAndRoundUp(NumTrackedActors, BucketSize);
+
+	TArray<FActorRepListType, TInlineAllocator<128>> AllPlayerStates;
+	AllPlayerStates.Reserve(NumTrackedActors);
+	for (const FActorRepListRefView& List : ReplicationActorLists)
 	{
-		APlayerState* PS = *It;
-		if (IsActorValidForReplicationGather(PS) == false)
+		for (FActorRepListType Actor : List)
 		{
-			continue;
+			AllPlayerStates.Add(Actor);
 		}
+	}
+
+	ReplicationActorLists.SetNum(NumBuckets);
+	for (int32 BucketIdx = 0; BucketIdx < NumBuckets; ++BucketIdx)
+	{
+		FActorRepListRefView& List = ReplicationActorLists[BucketIdx];
+		List.Reset(BucketSize);
 
-		if (CurrentList->Num() >= TargetActorsPerFrame)
+		const int32 FirstIdx = BucketIdx * BucketSize;
+		const int32 LastIdx = FMath::Min(FirstIdx + BucketSize, AllPlayerStates.Num());
+		for (int32 Idx = FirstIdx; Idx < LastIdx; ++Idx)
 		{
-			ReplicationActorLists.AddDefaulted();
-			CurrentList = &ReplicationActorLists.Last(); 
+			List.Add(AllPlayerStates[Idx]);
 		}
-		
-		CurrentList->Add(PS);
-	}	
+	}
+
+	BalancedTargetActorsPerFrame = TargetActorsPerFrame;
+	bBucketsNeedRebalance = false;
+}
+
+const FActorRepListRefView& ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::GetValidBucket(uint32 ReplicationFrameNum, uint32 BucketCycle)
+{
+	if (ReplicationActorLists.Num() == 0)
+	{
+		ValidBucketActorList.Reset();
+		return ValidBucketActorList;
+	}
+
+	const int32 ListIdx = BucketCycle % ReplicationActorLists.Num();
+
+	// Connections that gather the same bucket on the same frame share the filtered list
+	if (!bHasValidBucketActorList || ValidBucketFrameNum != ReplicationFrameNum || ValidBucketListIdx != ListIdx)
+	{
+		// The buckets are persistent, skip player states that are pending kill or torn off until they are removed
+		ValidBucketActorList.Reset();
+		for (FActorRepListType Actor : ReplicationActorLists[ListIdx])
+		{
+			if (IsActorValidForReplicationGather(Actor))
+			{
+				ValidBucketActorList.Add(Actor);
+			}
+		}
+
+		ValidBucketFrameNum = ReplicationFrameNum;
+		ValidBucketListIdx = ListIdx;
+		bHasValidBucketActorList = true;
+	}
+
+	return ValidBucketActorList;
 }
 
 void ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
 {
-	const int32 ListIdx = Params.ReplicationFrameNum % ReplicationActorLists.Num();
-	Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorLists[ListIdx]);
+	Lyra::RepGraph::FScopedGatherTelemetry GatherTelemetry(this, Params);
 
+	// The buckets are gathered by ULyraReplicationGraphNode_AlwaysRelevant_ForConnection, which leaves out the player states it replicates at a higher rate
 	if (ForceNetUpdateReplicationActorList.Num() > 0)
 	{
 		Params.OutGatheredReplicationLists.AddReplicationActorList(ForceNetUpdateReplicationActorList);
@@ -938,6 +1281,223 @@ void ULyraReplicationGraphNode_PlayerStateFrequencyLimiter::LogNode(FReplication
 
 // ------------------------------------------------------------------------------
 
+void ULyraReplicationGraphNode_GridSpatialization2D::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	Lyra::RepGraph::FScopedGatherTelemetry GatherTelemetry(this, Params);
+
+	Super::GatherActorListsForConnection(Params);
+}
+
+// ------------------------------------------------------------------------------
+
+int32 ULyraReplicationGraph::ServerReplicateActors(float DeltaSeconds)
+{
+	if (Lyra::RepGraph::EnableTelemetry == 0)
+	{
+		return Super::ServerReplicateActors(DeltaSeconds);
+	}
+
+	FMemory::Memzero(FrameBitsSentPerMapping);
+	FrameNumActorsConsidered = 0;
+	FrameNumActorsReplicated = 0;
+	FrameGatherSeconds = 0.0;
+	FramePrioritizeSeconds = 0.0;
+
+	const int32 Result = Super::ServerReplicateActors(DeltaSeconds);
+
+	RecordTelemetryCsvStats();
+
+	return Result;
+}
+
+void ULyraReplicationGraph::ReplicateActorListsForConnections_Default(UNetReplicationGraphConnection* ConnectionManager, FGatheredReplicationActorLists& GatheredReplicationListsForConnection, FNetViewerArray& Viewers)
+{
+	if (Lyra::RepGraph::EnableTelemetry == 0)
+	{
+		Super::ReplicateActorListsForConnections_Default(ConnectionManager, GatheredReplicationListsForConnection, Viewers);
+		return;
+	}
+
+	const double StartSeconds = FPlatformTime::Seconds();
+
+	FLyraRepGraphConnectionTelemetry& Telemetry = ConnectionTelemetry.FindOrAdd(ConnectionManager);
+	Telemetry.NumFrames++;
+
+	int64 NumConsidered = 0;
+	for (const auto& List : GatheredReplicationListsForConnection.GetLists(EActorRepListTypeFlags::Default))
+	{
+		NumConsidered += List.Num();
+
+		for (AActor* Actor : List)
+		{
+			if (Actor)
+			{
+				Telemetry.PerClass.FindOrAdd(Actor->GetClass()).NumConsidered++;
+			}
+		}
+	}
+	Telemetry.NumActorsConsidered += NumConsidered;
+	FrameNumActorsConsidered += NumConsidered;
+
+	Super::ReplicateActorListsForConnections_Default(ConnectionManager, GatheredReplicationListsForConnection, Viewers);
+
+	const double PrioritizeSeconds = FPlatformTime::Seconds() - StartSeconds;
+
+	// The map may have grown while replicating (e.g., a new connection), so look the entry up again
+	ConnectionTelemetry.FindChecked(ConnectionManager).PrioritizeSeconds += PrioritizeSeconds;
+	FramePrioritizeSeconds += PrioritizeSeconds;
+}
+
+void ULyraReplicationGraph::RecordGatherSeconds(const UNetReplicationGraphConnection& ConnectionManager, double Seconds)
+{
+	ConnectionTelemetry.FindOrAdd(&ConnectionManager).GatherSeconds += Seconds;
+	FrameGatherSeconds += Seconds;
+}
+
+void ULyraReplicationGraph::RemoveClientConnection(UNetConnection* NetConnection)
+{
+	// Drop the telemetry of the connection, its connection manager goes away with it
+	for (const UNetReplicationGraphConnection* ConnectionManager : Connections)
+	{
+		if (ConnectionManager && ConnectionManager->NetConnection == NetConnection)
+		{
+			ConnectionTelemetry.Remove(ConnectionManager);
+			break;
+		}
+	}
+
+	Super::RemoveClientConnection(NetConnection);
+}
+
+int64 ULyraReplicationGraph::ReplicateSingleActor(AActor* Actor, FConnectionReplicationActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalActorInfo, FPerConnectionActorInfoMap& ConnectionActorInfoMap, UNetReplicationGraphConnection& ConnectionManager, const uint32 FrameNum)
+{
+	const int64 BitsWritten = Super::ReplicateSingleActor(Actor, ActorInfo, GlobalActorInfo, ConnectionActorInfoMap, ConnectionManager, FrameNum);
+
+	if (Lyra::RepGraph::EnableTelemetry != 0)
+	{
+		RecordActorReplicated(Actor, ConnectionManager, BitsWritten, false);
+	}
+
+	return BitsWritten;
+}
+
+int64 ULyraReplicationGraph::ReplicateSingleActor_FastShared(AActor* Actor, FConnectionReplicationActorInfo& ConnectionData, FGlobalActorReplicationInfo& GlobalActorInfo, UNetReplicationGraphConnection& ConnectionManager, const uint32 FrameNum)
+{
+	const int64 BitsWritten = Super::ReplicateSingleActor_FastShared(Actor, ConnectionData, GlobalActorInfo, ConnectionManager, FrameNum);
+
+	if (Lyra::RepGraph::EnableTelemetry != 0)
+	{
+		RecordActorReplicated(Actor, ConnectionManager, BitsWritten, true);
+	}
+
+	return BitsWritten;
+}
+
+void ULyraReplicationGraph::RecordActorReplicated(AActor* Actor, UNetReplicationGraphConnection& ConnectionManager, int64 BitsWritten, bool bFastShared)
+{
+	if (!Actor || BitsWritten <= 0)
+	{
+		return;
+	}
+
+	FLyraRepGraphConnectionTelemetry& Telemetry = ConnectionTelemetry.FindOrAdd(&ConnectionManager);
+	Telemetry.BitsSent += BitsWritten;
+	Telemetry.NumActorsReplicated++;
+
+	FLyraRepGraphClassTelemetry& ClassTelemetry = Telemetry.PerClass.FindOrAdd(Actor->GetClass());
+	ClassTelemetry.BitsSent += BitsWritten;
+	if (bFastShared)
+	{
+		ClassTelemetry.NumFastSharedReplicated++;
+	}
+	else
+	{
+		ClassTelemetry.NumReplicated++;
+	}
+
+	FrameNumActorsReplicated++;
+	FrameBitsSentPerMapping[(uint32)GetMappingPolicy(Actor->GetClass())] += BitsWritten;
+}
+
+void ULyraReplicationGraph::RecordTelemetryCsvStats()
+{
+	CSV_CUSTOM_STAT(LyraRepGraph, KBytesSent_NotRouted, (float)(FrameBitsSentPerMapping[(uint32)EClassRepNodeMapping::NotRouted] / 8192.0), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(LyraRepGraph, KBytesSent_RelevantAllConnections, (float)(FrameBitsSentPerMapping[(uint32)EClassRepNodeMapping::RelevantAllConnections] / 8192.0), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(LyraRepGraph, KBytesSent_Spatialize_Static, (float)(FrameBitsSentPerMapping[(uint32)EClassRepNodeMapping::Spatialize_Static] / 8192.0), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(LyraRepGraph, KBytesSent_Spatialize_Dynamic, (float)(FrameBitsSentPerMapping[(uint32)EClassRepNodeMapping::Spatialize_Dynamic] / 8192.0), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(LyraRepGraph, KBytesSent_Spatialize_Dormancy, (float)(FrameBitsSentPerMapping[(uint32)EClassRepNodeMapping::Spatialize_Dormancy] / 8192.0), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(LyraRepGraph, NumActorsConsidered, (int32)FrameNumActorsConsidered, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(LyraRepGraph, NumActorsReplicated, (int32)FrameNumActorsReplicated, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(LyraRepGraph, GatherMs, (float)(FrameGatherSeconds * 1000.0), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(LyraRepGraph, PrioritizeMs, (float)(FramePrioritizeSeconds * 1000.0), ECsvCustomStatOp::Set);
+}
+
+void ULyraReplicationGraph::PrintTelemetry(int32 MaxClassesPerConnection)
+{
+	UEnum* Enum = StaticEnum<EClassRepNodeMapping>();
+
+	GLog->Logf(TEXT("===================================="));
+	GLog->Logf(TEXT("Lyra Replication Graph Telemetry (%s)"), Lyra::RepGraph::EnableTelemetry ? TEXT("recording") : TEXT("not recording, see Lyra.RepGraph.Telemetry.Enable"));
+	GLog->Logf(TEXT("===================================="));
+
+	for (const TPair<FObjectKey, FLyraRepGraphConnectionTelemetry>& ConnectionPair : ConnectionTelemetry)
+	{
+		const FLyraRepGraphConnectionTelemetry& Telemetry = ConnectionPair.Value;
+		if (Telemetry.NumFrames == 0)
+		{
+			continue;
+		}
+
+		const UNetReplicationGraphConnection* ConnectionManager = Cast<UNetReplicationGraphConnection>(ConnectionPair.Key.ResolveObjectPtr());
+		const double Frames = (double)Telemetry.NumFrames;
+
+		GLog->Logf(TEXT("%s: %lld frames. Avg/frame: %.2f bytes, %.1f actors considered, %.1f replicated, gather %.3f ms, prioritize %.3f ms"),
+			ConnectionManager ? *ConnectionManager->GetName() : TEXT("<closed connection>"),
+			Telemetry.NumFrames,
+			Telemetry.BitsSent / 8.0 / Frames,
+			Telemetry.NumActorsConsidered / Frames,
+			Telemetry.NumActorsReplicated / Frames,
+			Telemetry.GatherSeconds * 1000.0 / Frames,
+			Telemetry.PrioritizeSeconds * 1000.0 / Frames);
+
+		// Totals per route
+		int64 BitsPerMapping[UE_ARRAY_COUNT(FrameBitsSentPerMapping)] = { };
+		TArray<TPair<const UClass*, const FLyraRepGraphClassTelemetry*>> SortedClasses;
+		for (const TPair<FObjectKey, FLyraRepGraphClassTelemetry>& ClassPair : Telemetry.PerClass)
+		{
+			if (UClass* Class = Cast<UClass>(ClassPair.Key.ResolveObjectPtr()))
+			{
+				// Same lookup as the CSV stats, so both reports put a class under the same route
+				BitsPerMapping[(uint32)GetMappingPolicy(Class)] += ClassPair.Value.BitsSent;
+				SortedClasses.Emplace(Class, &ClassPair.Value);
+			}
+		}
+
+		for (int32 MappingIdx = 0; MappingIdx < UE_ARRAY_COUNT(BitsPerMapping); ++MappingIdx)
+		{
+			GLog->Logf(TEXT("    %-24s %10.2f bytes/frame"), Enum ? *Enum->GetNameStringByValue(MappingIdx) : TEXT(""), BitsPerMapping[MappingIdx] / 8.0 / Frames);
+		}
+
+		SortedClasses.Sort([](const TPair<const UClass*, const FLyraRepGraphClassTelemetry*>& A, const TPair<const UClass*, const FLyraRepGraphClassTelemetry*>& B)
+		{
+			return A.Value->BitsSent > B.Value->BitsSent;
+		});
+
+		for (int32 ClassIdx = 0; ClassIdx < FMath::Min(SortedClasses.Num(), MaxClassesPerConnection); ++ClassIdx)
+		{
+			const FLyraRepGraphClassTelemetry& ClassTelemetry = *SortedClasses[ClassIdx].Value;
+			GLog->Logf(TEXT("    %-40s %10.2f bytes/frame  %.1f considered/frame  %lld replicated  %lld fast shared"), *GetNameSafe(SortedClasses[ClassIdx].Key), ClassTelemetry.BitsSent / 8.0 / Frames, ClassTelemetry.NumConsidered / Frames, ClassTelemetry.NumReplicated, ClassTelemetry.NumFastSharedReplicated);
+		}
+	}
+}
+
+void ULyraReplicationGraph::ResetTelemetry()
+{
+	ConnectionTelemetry.Reset();
+}
+
+// ------------------------------------------------------------------------------
+
 void ULyraReplicationGraph::PrintRepNodePolicies()
 {
 	UEnum* Enum = StaticEnum<EClassRepNodeMapping>();
@@ -970,6 +1530,32 @@ FAutoConsoleCommandWithWorldAndArgs LyraPrintRepNodePoliciesCmd(TEXT("Lyra.RepGr
 	})
 );
 
+FAutoConsoleCommandWithWorldAndArgs LyraPrintRepGraphTelemetryCmd(TEXT("Lyra.RepGraph.Telemetry.Print"), TEXT("Prints per connection and per class replication cost recorded while Lyra.RepGraph.Telemetry.Enable is set. Optional arg: max classes per connection (default 10)"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		int32 MaxClasses = 10;
+		if (Args.Num() > 0)
+		{
+			LexTryParseString<int32>(MaxClasses, *Args[0]);
+		}
+
+		for (TObjectIterator<ULyraReplicationGraph> It; It; ++It)
+		{
+			It->PrintTelemetry(MaxClasses);
+		}
+	})
+);
+
+FAutoConsoleCommandWithWorldAndArgs LyraResetRepGraphTelemetryCmd(TEXT("Lyra.RepGraph.Telemetry.Reset"), TEXT("Clears the replication cost recorded by Lyra.RepGraph.Telemetry.Enable"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		for (TObjectIterator<ULyraReplicationGraph> It; It; ++It)
+		{
+			It->ResetTelemetry();
+		}
+	})
+);
+
 // ------------------------------------------------------------------------------
 
 FAutoConsoleCommandWithWorldAndArgs ChangeFrequencyBucketsCmd(TEXT("Lyra.RepGraph.FrequencyBuckets"), TEXT("Resets frequency bucket count."), FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray< FString >& Args, UWorld* World) 
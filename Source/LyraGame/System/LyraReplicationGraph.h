@@ -3,13 +3,41 @@
 #pragma once
 
 #include "ReplicationGraph.h"
+#include "UObject/ObjectKey.h"
 #include "LyraReplicationGraphTypes.h"
 #include "LyraReplicationGraph.generated.h"
 
 class AGameplayDebuggerCategoryReplicator;
+class ULyraReplicationGraphNode_PlayerStateFrequencyLimiter;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogLyraRepGraph, Display, All);
 
+/** Replication cost of a single actor class on a single connection, accumulated while Lyra.RepGraph.Telemetry.Enable is set */
+struct FLyraRepGraphClassTelemetry
+{
+	int64 BitsSent = 0;
+	int64 NumConsidered = 0;
+	int64 NumReplicated = 0;
+	int64 NumFastSharedReplicated = 0;
+};
+
+/** Replication cost of a single connection, accumulated while Lyra.RepGraph.Telemetry.Enable is set */
+struct FLyraRepGraphConnectionTelemetry
+{
+	TMap<FObjectKey, FLyraRepGraphClassTelemetry> PerClass;
+
+	int64 NumFrames = 0;
+	int64 NumActorsConsidered = 0;
+	int64 NumActorsReplicated = 0;
+	int64 BitsSent = 0;
+
+	/** Time spent in the gather functions of the Lyra nodes and the spatialization grid for this connection */
+	double GatherSeconds = 0.0;
+
+	/** Time spent prioritizing and replicating the gathered lists */
+	double PrioritizeSeconds = 0.0;
+};
+
 /** Lyra Replication Graph implementation. See additional notes in LyraReplicationGraph.cpp! */
 UCLASS(transient, config=Engine)
 class ULyraReplicationGraph : public UReplicationGraph
@@ -36,6 +64,9 @@ public:
 	UPROPERTY()
 	TObjectPtr<UReplicationGraphNode_ActorList> AlwaysRelevantNode;
 
+	UPROPERTY()
+	TObjectPtr<ULyraReplicationGraphNode_PlayerStateFrequencyLimiter> PlayerStateNode;
+
 	TMap<FName, FActorRepListRefView> AlwaysRelevantStreamingLevelActors;
 
 #if WITH_GAMEPLAY_DEBUGGER
@@ -44,7 +75,30 @@ public:
 
 	void PrintRepNodePolicies();
 
+	void PrintTelemetry(int32 MaxClassesPerConnection);
+	void ResetTelemetry();
+
+	/** Called by the graph nodes with the time they spent gathering for a connection, while telemetry is being recorded */
+	void RecordGatherSeconds(const UNetReplicationGraphConnection& ConnectionManager, double Seconds);
+
+	//~UReplicationDriver interface
+	virtual int32 ServerReplicateActors(float DeltaSeconds) override;
+	virtual void RemoveClientConnection(UNetConnection* NetConnection) override;
+	//~End of UReplicationDriver interface
+
+protected:
+	//~UReplicationGraph interface
+	virtual void ReplicateActorListsForConnections_Default(UNetReplicationGraphConnection* ConnectionManager, FGatheredReplicationActorLists& GatheredReplicationListsForConnection, FNetViewerArray& Viewers) override;
+	virtual int64 ReplicateSingleActor(AActor* Actor, FConnectionReplicationActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalActorInfo, FPerConnectionActorInfoMap& ConnectionActorInfoMap, UNetReplicationGraphConnection& ConnectionManager, const uint32 FrameNum) override;
+	virtual int64 ReplicateSingleActor_FastShared(AActor* Actor, FConnectionReplicationActorInfo& ConnectionData, FGlobalActorReplicationInfo& GlobalActorInfo, UNetReplicationGraphConnection& ConnectionManager, const uint32 FrameNum) override;
+	//~End of UReplicationGraph interface
+
 private:
+	void RecordActorReplicated(AActor* Actor, UNetReplicationGraphConnection& ConnectionManager, int64 BitsWritten, bool bFastShared);
+	void RecordTelemetryCsvStats();
+
+	void NotifyPlayerStateRemoved(AActor* PlayerState);
+
 	void AddClassRepInfo(UClass* Class, EClassRepNodeMapping Mapping);
 	void RegisterClassRepNodeMapping(UClass* Class);
 	EClassRepNodeMapping GetClassNodeMapping(UClass* Class) const;
@@ -61,6 +115,25 @@ private:
 
 	/** Classes that had their replication settings explictly set by code in ULyraReplicationGraph::InitGlobalActorClassSettings */
 	TArray<UClass*> ExplicitlySetClasses;
+
+	TMap<FObjectKey, FLyraRepGraphConnectionTelemetry> ConnectionTelemetry;
+
+	/** Bits sent this frame per EClassRepNodeMapping, used for the CSV profiler */
+	int64 FrameBitsSentPerMapping[(uint32)EClassRepNodeMapping::Spatialize_Dormancy + 1] = { };
+	int64 FrameNumActorsConsidered = 0;
+	int64 FrameNumActorsReplicated = 0;
+	double FrameGatherSeconds = 0.0;
+	double FramePrioritizeSeconds = 0.0;
+};
+
+/** The spatialization grid, only extended to record its gather time in the telemetry */
+UCLASS()
+class ULyraReplicationGraphNode_GridSpatialization2D : public UReplicationGraphNode_GridSpatialization2D
+{
+	GENERATED_BODY()
+
+public:
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
 };
 
 UCLASS()
@@ -80,6 +153,9 @@ public:
 	void OnClientLevelVisibilityAdd(FName LevelName, UWorld* StreamingWorld);
 	void OnClientLevelVisibilityRemove(FName LevelName);
 
+	/** Called by the graph when a player state stops replicating so it can be dropped from the prioritized lists */
+	void OnPlayerStateRemoved(AActor* PlayerState);
+
 	void ResetGameWorldState();
 
 #if WITH_GAMEPLAY_DEBUGGER
@@ -87,25 +163,44 @@ public:
 #endif
 
 private:
+	/** Sorts the simulated proxy player states into the high/medium priority lists for this connection, based on team, distance to the viewers and recent stat changes */
+	void UpdatePlayerStatePriorities(const FConnectionGatherActorListParameters& Params, const AActor* TeamViewer, TConstArrayView<FVector> ViewerLocations);
+
 	TArray<FName, TInlineAllocator<64> > AlwaysRelevantStreamingLevelsNeedingReplication;
 
+	/** Teammates, nearby enemies and player states with recent stat changes. Replicated every PlayerStateHighPriorityPeriod frames. */
+	FActorRepListRefView HighPriorityPlayerStates;
+
+	/** Enemies at medium range. Replicated every PlayerStateMediumPriorityPeriod frames. */
+	FActorRepListRefView MediumPriorityPlayerStates;
+
+	/** The player states of the current rolling bucket that are in neither list above. Rebuilt every PlayerStateLowPriorityPeriod frames. */
+	FActorRepListRefView LowPriorityPlayerStates;
+
 	bool bInitializedPlayerState = false;
+
+	bool bHasPlayerStatePriorities = false;
 };
 
 /** 
 	This is a specialized node for handling PlayerState replication in a frequency limited fashion. It tracks all player states but only returns a subset of them to the replication driver each frame. 
 	This is an optimization for large player connection counts, and not a requirement.
+
+	The buckets are persistent: player states are added/removed via the Notify functions (routed from ULyraReplicationGraph) and the buckets
+	are only compacted and rebalanced against TargetActorsPerFrame on frames after the set of player states has changed.
 */
 UCLASS()
 class ULyraReplicationGraphNode_PlayerStateFrequencyLimiter : public UReplicationGraphNode
 {
 	GENERATED_BODY()
 
+public:
 	ULyraReplicationGraphNode_PlayerStateFrequencyLimiter();
 
-	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& Actor) override { }
-	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound=true) override { return false; }
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& Actor) override;
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound=true) override;
 	virtual bool NotifyActorRenamed(const FRenamedReplicatedActorInfo& Actor, bool bWarnIfNotFound=true) override { return false; }
+	virtual void NotifyResetAllNetworkActors() override;
 
 	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
 
@@ -116,8 +211,32 @@ class ULyraReplicationGraphNode_PlayerStateFrequencyLimiter : public UReplicatio
 	/** How many actors we want to return to the replication driver per frame. Will not suppress ForceNetUpdate. */
 	int32 TargetActorsPerFrame = 2;
 
+	/**
+	 * Returns the player states of bucket BucketCycle (wrapped to the bucket count) that are valid to gather on this frame.
+	 * Connections passing the same frame and bucket share the same list, so only this frame's gathers may hold on to it.
+	 */
+	const FActorRepListRefView& GetValidBucket(uint32 ReplicationFrameNum, uint32 BucketCycle);
+
 private:
-	
+
+	/** Repacks all tracked player states into buckets of TargetActorsPerFrame. Only called when the buckets are dirty. */
+	void RebalanceBuckets();
+
 	TArray<FActorRepListRefView> ReplicationActorLists;
 	FActorRepListRefView ForceNetUpdateReplicationActorList;
+
+	/** The player states of the last requested bucket that are valid to gather (not pending kill or torn off) */
+	FActorRepListRefView ValidBucketActorList;
+	uint32 ValidBucketFrameNum = 0;
+	int32 ValidBucketListIdx = INDEX_NONE;
+	bool bHasValidBucketActorList = false;
+
+	/** Total number of player states across all buckets */
+	int32 NumTrackedActors = 0;
+
+	/** TargetActorsPerFrame the buckets were last balanced against */
+	int32 BalancedTargetActorsPerFrame = 0;
+
+	/** Set when a player state leaves (leaving a hole in a bucket) so we compact on the next PrepareForReplication */
+	bool bBucketsNeedRebalance = false;
 };
\ No newline at end of file
@@ -36,6 +36,18 @@ public:
 	UPROPERTY(EditAnywhere, Category = FastSharedPath, meta = (ConsoleVariable = "Lyra.RepGraph.FastSharedPathCullDistPct"))
 	float FastSharedPathCullDistPct = 0.80f;
 
+	// Send FastShared movement updates with the compact encoding (location deltas against periodic key frames, adaptive bit count velocity, yaw only rotation for upright characters).
+	UPROPERTY(EditAnywhere, Category = FastSharedPath, meta = (ConsoleVariable = "Lyra.RepGraph.CompactSharedMovement"))
+	bool bCompactSharedMovement = false;
+
+	// How many compact FastShared movement updates can be sent relative to a key frame before a new key frame is sent.
+	UPROPERTY(EditAnywhere, Category = FastSharedPath, meta = (ConsoleVariable = "Lyra.RepGraph.CompactSharedMovement.KeyFrameInterval"))
+	int32 CompactSharedMovementKeyFrameInterval = 10;
+
+	// How many compact FastShared movement updates carry a new key frame, so losing one (unreliable) update doesn't lose the key frame.
+	UPROPERTY(EditAnywhere, Category = FastSharedPath, meta = (ConsoleVariable = "Lyra.RepGraph.CompactSharedMovement.KeyFrameRepeats"))
+	int32 CompactSharedMovementKeyFrameRepeats = 3;
+
 	UPROPERTY(EditAnywhere, Category = DestructionInfo, meta = (ForceUnits = cm, ConsoleVariable = "Lyra.RepGraph.DestructInfo.MaxDist"))
 	float DestructionInfoMaxDist = 30000.f;
 
@@ -59,6 +71,39 @@ public:
 	UPROPERTY(EditAnywhere, Category = DynamicSpatialFrequency, meta = (ConsoleVariable = "Lyra.RepGraph.DynamicActorFrequencyBuckets"))
 	int32 DynamicActorFrequencyBuckets = 3;
 
+	// Records per connection/per class bytes sent, actors considered vs replicated and gather/prioritize time. See Lyra.RepGraph.Telemetry.Print.
+	UPROPERTY(EditAnywhere, Category = Telemetry, meta = (ConsoleVariable = "Lyra.RepGraph.Telemetry.Enable"))
+	bool bEnableTelemetry = false;
+
+	// How many replication frames between re-evaluating the simulated proxy player state priorities of a connection.
+	UPROPERTY(EditAnywhere, Category = PlayerStatePriority, meta = (ConsoleVariable = "Lyra.RepGraph.PlayerState.PriorityUpdatePeriod"))
+	int32 PlayerStatePriorityUpdatePeriod = 10;
+
+	// Replication period (in frames) for the owning player state and high priority player states (teammates, nearby enemies, recently changed stats).
+	UPROPERTY(EditAnywhere, Category = PlayerStatePriority, meta = (ConsoleVariable = "Lyra.RepGraph.PlayerState.HighPriorityPeriod"))
+	int32 PlayerStateHighPriorityPeriod = 2;
+
+	// Replication period (in frames) for medium priority player states (enemies at medium range).
+	UPROPERTY(EditAnywhere, Category = PlayerStatePriority, meta = (ConsoleVariable = "Lyra.RepGraph.PlayerState.MediumPriorityPeriod"))
+	int32 PlayerStateMediumPriorityPeriod = 6;
+
+	// Enemies whose pawn is closer than this to the viewer are high priority.
+	UPROPERTY(EditAnywhere, Category = PlayerStatePriority, meta = (ForceUnits = cm, ConsoleVariable = "Lyra.RepGraph.PlayerState.NearDistance"))
+	float PlayerStateNearDistance = 5000.0f;
+
+	// Enemies whose pawn is closer than this to the viewer are medium priority. Anything further is low priority.
+	UPROPERTY(EditAnywhere, Category = PlayerStatePriority, meta = (ForceUnits = cm, ConsoleVariable = "Lyra.RepGraph.PlayerState.MediumDistance"))
+	float PlayerStateMediumDistance = 15000.0f;
+
+	// Player states that aren't high or medium priority for a connection are only taken from the rolling buckets every this many frames,
+	// so they replicate this many times slower than the buckets cycle.
+	UPROPERTY(EditAnywhere, Category = PlayerStatePriority, meta = (ConsoleVariable = "Lyra.RepGraph.PlayerState.LowPriorityPeriod"))
+	int32 PlayerStateLowPriorityPeriod = 2;
+
+	// Player states whose stat tags (score, eliminations, ...) changed within this many seconds are high priority.
+	UPROPERTY(EditAnywhere, Category = PlayerStatePriority, meta = (ForceUnits = s, ConsoleVariable = "Lyra.RepGraph.PlayerState.RecentStatChangeTime"))
+	float PlayerStateRecentStatChangeTime = 2.0f;
+
 	// Array of Custom Settings for Specific Classes 
 	UPROPERTY(config, EditAnywhere, Category = ReplicationGraph)
 	TArray<FRepGraphActorClassSettings> ClassSettings;
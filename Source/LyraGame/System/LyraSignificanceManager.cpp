@@ -2,5 +2,514 @@
 
 #include "LyraSignificanceManager.h"
 
+#include "Camera/PlayerCameraManager.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Teams/LyraTeamSubsystem.h"
+
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraSignificanceManager)
 
+namespace LyraSignificance
+{
+	static bool bEnabled = true;
+	static FAutoConsoleVariableRef CVarEnabled(
+		TEXT("Lyra.Significance.Enabled"),
+		bEnabled,
+		TEXT("When disabled, registered actors are left at full significance and no budgets are applied."),
+		ECVF_Default);
+
+	static float UpdatePeriod = 0.1f;
+	static FAutoConsoleVariableRef CVarUpdatePeriod(
+		TEXT("Lyra.Significance.UpdatePeriod"),
+		UpdatePeriod,
+		TEXT("How often (in seconds) significance is recalculated. 0 updates every frame."),
+		ECVF_Default);
+
+	// Significance is the approximate fraction of the screen height covered by an actor's bounds
+	static float HighThreshold = 0.25f;
+	static FAutoConsoleVariableRef CVarHighThreshold(
+		TEXT("Lyra.Significance.HighThreshold"),
+		HighThreshold,
+		TEXT("Minimum significance (screen size) for the High level."),
+		ECVF_Default);
+
+	static float MediumThreshold = 0.08f;
+	static FAutoConsoleVariableRef CVarMediumThreshold(
+		TEXT("Lyra.Significance.MediumThreshold"),
+		MediumThreshold,
+		TEXT("Minimum significance (screen size) for the Medium level."),
+		ECVF_Default);
+
+	static float LowThreshold = 0.02f;
+	static FAutoConsoleVariableRef CVarLowThreshold(
+		TEXT("Lyra.Significance.LowThreshold"),
+		LowThreshold,
+		TEXT("Minimum significance (screen size) for the Low level. Anything below is Lowest."),
+		ECVF_Default);
+
+	static float NotRenderedScale = 0.25f;
+	static FAutoConsoleVariableRef CVarNotRenderedScale(
+		TEXT("Lyra.Significance.NotRenderedScale"),
+		NotRenderedScale,
+		TEXT("Multiplier applied to the significance of actors that were not rendered recently (occluded or off screen)."),
+		ECVF_Default);
+
+	static float TeammateScale = 2.0f;
+	static FAutoConsoleVariableRef CVarTeammateScale(
+		TEXT("Lyra.Significance.TeammateScale"),
+		TeammateScale,
+		TEXT("Multiplier applied to the significance of actors on the local player's team."),
+		ECVF_Default);
+
+	static float MediumTickInterval = 1.0f / 30.0f;
+	static FAutoConsoleVariableRef CVarMediumTickInterval(
+		TEXT("Lyra.Significance.MediumTickInterval"),
+		MediumTickInterval,
+		TEXT("Tick interval for meshes and actors at the Medium level."),
+		ECVF_Default);
+
+	static float LowTickInterval = 1.0f / 15.0f;
+	static FAutoConsoleVariableRef CVarLowTickInterval(
+		TEXT("Lyra.Significance.LowTickInterval"),
+		LowTickInterval,
+		TEXT("Tick interval for meshes and actors at the Low level."),
+		ECVF_Default);
+
+	static float LowestTickInterval = 0.25f;
+	static FAutoConsoleVariableRef CVarLowestTickInterval(
+		TEXT("Lyra.Significance.LowestTickInterval"),
+		LowestTickInterval,
+		TEXT("Tick interval for meshes and actors at the Lowest level."),
+		ECVF_Default);
+
+	// Never ticks more often than authored, High and above restore the authored interval
+	static float GetTickInterval(ELyraSignificanceLevel Level, float AuthoredTickInterval)
+	{
+		switch (Level)
+		{
+		case ELyraSignificanceLevel::Lowest:
+			return FMath::Max(LowestTickInterval, AuthoredTickInterval);
+		case ELyraSignificanceLevel::Low:
+			return FMath::Max(LowTickInterval, AuthoredTickInterval);
+		case ELyraSignificanceLevel::Medium:
+			return FMath::Max(MediumTickInterval, AuthoredTickInterval);
+		default:
+			return AuthoredTickInterval;
+		}
+	}
+
+	// Weapons and character parts are attached (directly or via child actor components) to the character that is registered
+	static const AActor* FindRegisteredRoot(const AActor* Actor)
+	{
+		const AActor* Root = Actor;
+		for (const AActor* Current = Actor; Current != nullptr; Current = Current->GetAttachParentActor())
+		{
+			Root = Current;
+			if (Current->IsA<APawn>())
+			{
+				break;
+			}
+		}
+		return Root;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// ULyraSignificanceManager
+
+void ULyraSignificanceManager::RegisterActor(AActor* Actor)
+{
+	if ((Actor == nullptr) || Actor->IsNetMode(NM_DedicatedServer) || (GetManagedObject(Actor) != nullptr))
+	{
+		return;
+	}
+
+	auto SignificanceFunction = [this](FManagedObjectInfo* ObjectInfo, const FTransform& Viewpoint) -> float
+	{
+		return CalculateSignificance(ObjectInfo, Viewpoint);
+	};
+
+	auto PostSignificanceFunction = [this](FManagedObjectInfo* ObjectInfo, float OldSignificance, float NewSignificance, bool bFinal)
+	{
+		const ELyraSignificanceLevel NewLevel = bFinal ? ELyraSignificanceLevel::Highest : SignificanceToLevel(NewSignificance);
+		UpdateSignificanceLevel(Cast<AActor>(ObjectInfo->GetObject()), NewLevel, bFinal);
+	};
+
+	// Everything starts out at full significance (with its authored settings) until the first update
+	CacheAuthoredTickSettings(Actor);
+
+	static const FName NAME_LyraCharacter(TEXT("Lyra.Character"));
+	RegisterObject(Actor, NAME_LyraCharacter, SignificanceFunction, EPostSignificanceType::Sequential, PostSignificanceFunction);
+}
+
+void ULyraSignificanceManager::UnregisterActor(AActor* Actor)
+{
+	if ((Actor != nullptr) && (GetManagedObject(Actor) != nullptr))
+	{
+		UnregisterObject(Actor);
+	}
+}
+
+ELyraSignificanceLevel ULyraSignificanceManager::GetSignificanceLevel(const AActor* Actor) const
+{
+	float Significance = 0.0f;
+	if (LyraSignificance::bEnabled && (Actor != nullptr) && QuerySignificance(LyraSignificance::FindRegisteredRoot(Actor), Significance))
+	{
+		return SignificanceToLevel(Significance);
+	}
+	return ELyraSignificanceLevel::Highest;
+}
+
+bool ULyraSignificanceManager::ShouldSpawnContextEffects(const AActor* Actor)
+{
+	if (Actor == nullptr)
+	{
+		return true;
+	}
+
+	if (const ULyraSignificanceManager* SignificanceManager = USignificanceManager::Get<ULyraSignificanceManager>(Actor->GetWorld()))
+	{
+		return SignificanceManager->GetSignificanceLevel(Actor) > ELyraSignificanceLevel::Lowest;
+	}
+
+	return true;
+}
+
+ELyraSignificanceLevel ULyraSignificanceManager::SignificanceToLevel(float Significance)
+{
+	if (Significance >= UE_BIG_NUMBER)
+	{
+		return ELyraSignificanceLevel::Highest;
+	}
+	else if (Significance >= LyraSignificance::HighThreshold)
+	{
+		return ELyraSignificanceLevel::High;
+	}
+	else if (Significance >= LyraSignificance::MediumThreshold)
+	{
+		return ELyraSignificanceLevel::Medium;
+	}
+	else if (Significance >= LyraSignificance::LowThreshold)
+	{
+		return ELyraSignificanceLevel::Low;
+	}
+	return ELyraSignificanceLevel::Lowest;
+}
+
+float ULyraSignificanceManager::CalculateSignificance(const FManagedObjectInfo* ObjectInfo, const FTransform& Viewpoint) const
+{
+	const AActor* Actor = Cast<AActor>(ObjectInfo->GetObject());
+	if ((Actor == nullptr) || !LyraSignificance::bEnabled)
+	{
+		return UE_BIG_NUMBER;
+	}
+
+	// Locally controlled characters are always fully significant
+	const APawn* Pawn = Cast<APawn>(Actor);
+	if ((Pawn != nullptr) && Pawn->IsLocallyControlled())
+	{
+		return UE_BIG_NUMBER;
+	}
+
+	// Approximate fraction of the screen covered by the actor's bounds
+	const float BoundsRadius = FMath::Max(Actor->GetRootComponent() ? Actor->GetRootComponent()->Bounds.SphereRadius : 0.0f, 1.0f);
+	const double Distance = FVector::Dist(Viewpoint.GetLocation(), Actor->GetActorLocation());
+	if (Distance <= UE_KINDA_SMALL_NUMBER)
+	{
+		return UE_BIG_NUMBER;
+	}
+	float Significance = (float)(BoundsRadius / (Distance * TanHalfFOV));
+
+	if (!Actor->WasRecentlyRendered(0.2f))
+	{
+		Significance *= LyraSignificance::NotRenderedScale;
+	}
+
+	if (LocalTeamId != INDEX_NONE)
+	{
+		if (const ULyraTeamSubsystem* TeamSubsystem = GetWorld()->GetSubsystem<ULyraTeamSubsystem>())
+		{
+			if (TeamSubsystem->FindTeamFromObject(Actor) == LocalTeamId)
+			{
+				Significance *= LyraSignificance::TeammateScale;
+			}
+		}
+	}
+
+	return Significance;
+}
+
+void ULyraSignificanceManager::UpdateSignificanceLevel(AActor* Actor, ELyraSignificanceLevel Level, bool bFinal)
+{
+	if (Actor == nullptr)
+	{
+		return;
+	}
+
+	// Not being in the map means nothing was applied yet (the actor has its authored settings)
+	FAppliedSignificance* Applied = AppliedSignificance.Find(Actor);
+	if ((Applied == nullptr) && (Level == ELyraSignificanceLevel::Highest))
+	{
+		return;
+	}
+
+	if ((Applied == nullptr) || (Applied->Level != Level))
+	{
+		ApplySignificanceLevel(Actor, Level);
+	}
+	else
+	{
+		// Same level, but weapons and cosmetics may have been attached or detached since it was applied
+		TArray<AActor*> AttachedActors;
+		Actor->GetAttachedActors(AttachedActors, /*bResetArray=*/ true, /*bRecursivelyIncludeAttachedActors=*/ true);
+
+		for (AActor* AttachedActor : AttachedActors)
+		{
+			if (!Applied->AttachedActors.Contains(AttachedActor))
+			{
+				ApplySignificanceLevelToAttachedActor(AttachedActor, Level);
+			}
+		}
+
+		for (const TWeakObjectPtr<AActor>& PreviouslyAttachedActor : Applied->AttachedActors)
+		{
+			AActor* PreviouslyAttached = PreviouslyAttachedActor.Get();
+			if ((PreviouslyAttached != nullptr) && !AttachedActors.Contains(PreviouslyAttached))
+			{
+				ApplySignificanceLevelToAttachedActor(PreviouslyAttached, ELyraSignificanceLevel::Highest);
+			}
+		}
+
+		Applied->AttachedActors.Reset(AttachedActors.Num());
+		for (AActor* AttachedActor : AttachedActors)
+		{
+			Applied->AttachedActors.Add(AttachedActor);
+		}
+	}
+
+	if (bFinal)
+	{
+		AppliedSignificance.Remove(Actor);
+	}
+}
+
+void ULyraSignificanceManager::ApplySignificanceLevel(AActor* Actor, ELyraSignificanceLevel Level)
+{
+	ApplySignificanceLevelToMeshes(Actor, Level);
+
+	// Only throttle movement of simulated proxies, never anything we predict or are authoritative over
+	if (Actor->GetLocalRole() == ROLE_SimulatedProxy)
+	{
+		if (UCharacterMovementComponent* MovementComponent = Actor->FindComponentByClass<UCharacterMovementComponent>())
+		{
+			const FAuthoredTickSettings& Authored = FindOrCacheAuthoredTickSettings(MovementComponent);
+			MovementComponent->SetComponentTickInterval((Level == ELyraSignificanceLevel::Lowest) ? LyraSignificance::GetTickInterval(Level, Authored.TickInterval) : Authored.TickInterval);
+		}
+	}
+
+	FAppliedSignificance& Applied = AppliedSignificance.FindOrAdd(Actor);
+
+	// Restore anything that was detached since the level was last applied
+	TArray<AActor*> AttachedActors;
+	Actor->GetAttachedActors(AttachedActors, /*bResetArray=*/ true, /*bRecursivelyIncludeAttachedActors=*/ true);
+	for (const TWeakObjectPtr<AActor>& PreviouslyAttachedActor : Applied.AttachedActors)
+	{
+		AActor* PreviouslyAttached = PreviouslyAttachedActor.Get();
+		if ((PreviouslyAttached != nullptr) && !AttachedActors.Contains(PreviouslyAttached))
+		{
+			ApplySignificanceLevelToAttachedActor(PreviouslyAttached, ELyraSignificanceLevel::Highest);
+		}
+	}
+
+	Applied.Level = Level;
+	Applied.AttachedActors.Reset(AttachedActors.Num());
+	for (AActor* AttachedActor : AttachedActors)
+	{
+		ApplySignificanceLevelToAttachedActor(AttachedActor, Level);
+		Applied.AttachedActors.Add(AttachedActor);
+	}
+}
+
+void ULyraSignificanceManager::ApplySignificanceLevelToAttachedActor(AActor* Actor, ELyraSignificanceLevel Level)
+{
+	// Attached characters (e.g., someone riding along) manage their own significance
+	if ((Actor == nullptr) || (GetManagedObject(Actor) != nullptr))
+	{
+		return;
+	}
+
+	ApplySignificanceLevelToMeshes(Actor, Level);
+
+	if (Actor->PrimaryActorTick.bCanEverTick)
+	{
+		const FAuthoredTickSettings& Authored = FindOrCacheAuthoredTickSettings(Actor);
+		Actor->SetActorTickInterval(LyraSignificance::GetTickInterval(Level, Authored.TickInterval));
+	}
+}
+
+void ULyraSignificanceManager::ApplySignificanceLevelToMeshes(AActor* Actor, ELyraSignificanceLevel Level)
+{
+	TInlineComponentArray<USkeletalMeshComponent*> SkeletalMeshes(Actor);
+	for (USkeletalMeshComponent* SkeletalMesh : SkeletalMeshes)
+	{
+		const FAuthoredTickSettings& Authored = FindOrCacheAuthoredTickSettings(SkeletalMesh);
+		SkeletalMesh->SetComponentTickInterval(LyraSignificance::GetTickInterval(Level, Authored.TickInterval));
+		SkeletalMesh->bEnableUpdateRateOptimizations = (Level < ELyraSignificanceLevel::High) || Authored.bEnableUpdateRateOptimizations;
+
+		if (Level == ELyraSignificanceLevel::Lowest)
+		{
+			SkeletalMesh->SuspendClothingSimulation();
+		}
+		else
+		{
+			SkeletalMesh->ResumeClothingSimulation();
+		}
+	}
+}
+
+void ULyraSignificanceManager::CacheAuthoredTickSettings(AActor* Actor)
+{
+	FindOrCacheAuthoredTickSettings(Actor);
+
+	TInlineComponentArray<USkeletalMeshComponent*> SkeletalMeshes(Actor);
+	for (USkeletalMeshComponent* SkeletalMesh : SkeletalMeshes)
+	{
+		FindOrCacheAuthoredTickSettings(SkeletalMesh);
+	}
+
+	if (UCharacterMovementComponent* MovementComponent = Actor->FindComponentByClass<UCharacterMovementComponent>())
+	{
+		FindOrCacheAuthoredTickSettings(MovementComponent);
+	}
+}
+
+const ULyraSignificanceManager::FAuthoredTickSettings& ULyraSignificanceManager::FindOrCacheAuthoredTickSettings(AActor* Actor)
+{
+	if (const FAuthoredTickSettings* Existing = AuthoredTickSettings.Find(Actor))
+	{
+		return *Existing;
+	}
+
+	FAuthoredTickSettings& Authored = AuthoredTickSettings.Add(Actor);
+	Authored.TickInterval = Actor->GetActorTickInterval();
+	return Authored;
+}
+
+const ULyraSignificanceManager::FAuthoredTickSettings& ULyraSignificanceManager::FindOrCacheAuthoredTickSettings(UActorComponent* Component)
+{
+	if (const FAuthoredTickSettings* Existing = AuthoredTickSettings.Find(Component))
+	{
+		return *Existing;
+	}
+
+	FAuthoredTickSettings& Authored = AuthoredTickSettings.Add(Component);
+	Authored.TickInterval = Component->GetComponentTickInterval();
+	if (const USkeletalMeshComponent* SkeletalMesh = Cast<USkeletalMeshComponent>(Component))
+	{
+		Authored.bEnableUpdateRateOptimizations = SkeletalMesh->bEnableUpdateRateOptimizations;
+	}
+	return Authored;
+}
+
+void ULyraSignificanceManager::PruneAuthoredTickSettings()
+{
+	for (auto It = AuthoredTickSettings.CreateIterator(); It; ++It)
+	{
+		if (It.Key().ResolveObjectPtr() == nullptr)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for (auto It = AppliedSignificance.CreateIterator(); It; ++It)
+	{
+		if (It.Key().ResolveObjectPtr() == nullptr)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void ULyraSignificanceManager::Tick(float DeltaTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_LyraSignificanceManager_Tick);
+
+	TimeSinceLastUpdate += DeltaTime;
+	if (TimeSinceLastUpdate < LyraSignificance::UpdatePeriod)
+	{
+		return;
+	}
+	TimeSinceLastUpdate = 0.0f;
+
+	UWorld* World = GetWorld();
+
+	LocalViewpoints.Reset();
+	LocalTeamId = INDEX_NONE;
+
+	float FOV = 90.0f;
+	for (FConstPlayerControllerIterator Iterator = World->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		APlayerController* PlayerController = Iterator->Get();
+		if ((PlayerController == nullptr) || !PlayerController->IsLocalController())
+		{
+			continue;
+		}
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		LocalViewpoints.Emplace(ViewRotation, ViewLocation);
+
+		if (LocalViewpoints.Num() == 1)
+		{
+			if (PlayerController->PlayerCameraManager != nullptr)
+			{
+				FOV = PlayerController->PlayerCameraManager->GetFOVAngle();
+			}
+
+			if (const ULyraTeamSubsystem* TeamSubsystem = World->GetSubsystem<ULyraTeamSubsystem>())
+			{
+				LocalTeamId = TeamSubsystem->FindTeamFromObject(PlayerController);
+			}
+		}
+	}
+
+	if (LocalViewpoints.Num() > 0)
+	{
+		TanHalfFOV = FMath::Max(FMath::Tan(FMath::DegreesToRadians(FOV * 0.5f)), UE_KINDA_SMALL_NUMBER);
+		Update(LocalViewpoints);
+	}
+
+	// Forget about destroyed actors and components (e.g., dropped weapons that were never registered themselves)
+	PruneAuthoredTickSettings();
+}
+
+ETickableTickType ULyraSignificanceManager::GetTickableTickType() const
+{
+	if (IsTemplate())
+	{
+		return ETickableTickType::Never;
+	}
+	return ETickableTickType::Conditional;
+}
+
+bool ULyraSignificanceManager::IsTickable() const
+{
+	// Nothing is registered on dedicated servers
+	const UWorld* World = GetWorld();
+	return (World != nullptr) && !World->IsNetMode(NM_DedicatedServer);
+}
+
+TStatId ULyraSignificanceManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULyraSignificanceManager, STATGROUP_Tickables);
+}
+
+UWorld* ULyraSignificanceManager::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
@@ -3,14 +3,98 @@
 #pragma once
 
 #include "SignificanceManager.h"
+#include "Tickable.h"
+#include "UObject/ObjectKey.h"
 
 #include "LyraSignificanceManager.generated.h"
 
+class AActor;
+class UActorComponent;
 class UObject;
 
+// Coarse buckets the significance value is sorted into. Budgets (tick rate, animation, cloth, effects) are applied per level.
+UENUM()
+enum class ELyraSignificanceLevel : uint8
+{
+	Lowest,
+	Low,
+	Medium,
+	High,
+	Highest
+};
+
+/**
+ * ULyraSignificanceManager
+ *
+ *	Scores registered characters by on-screen size, visibility and team relevance from the local viewpoints, and throttles
+ *	the tick rate, animation update rate and cloth simulation of the character and everything attached to it (weapons,
+ *	cosmetic parts) based on the resulting ELyraSignificanceLevel. Context effects also ask it whether they should spawn.
+ *	Only used on clients (nothing registers on dedicated servers).
+ */
 UCLASS()
-class ULyraSignificanceManager : public USignificanceManager
+class ULyraSignificanceManager : public USignificanceManager, public FTickableGameObject
 {
 	GENERATED_BODY()
 
+public:
+	// Registers a character with the significance function and budgets. Does nothing on dedicated servers.
+	void RegisterActor(AActor* Actor);
+
+	// Unregisters an actor previously registered with RegisterActor
+	void UnregisterActor(AActor* Actor);
+
+	// Returns the current significance level of the actor (or of the pawn it is attached to), or Highest if it isn't managed
+	ELyraSignificanceLevel GetSignificanceLevel(const AActor* Actor) const;
+
+	// Returns true if context effects (footsteps, impacts, ...) from this actor are worth spawning
+	static bool ShouldSpawnContextEffects(const AActor* Actor);
+
+	static ELyraSignificanceLevel SignificanceToLevel(float Significance);
+
+	//~FTickableObjectBase interface
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override;
+	//~End of FTickableObjectBase interface
+
+private:
+	// Tick settings as authored, restored when an actor or component is no longer throttled
+	struct FAuthoredTickSettings
+	{
+		float TickInterval = 0.0f;
+		bool bEnableUpdateRateOptimizations = false;
+	};
+
+	// The level last applied to a registered actor, and the attached actors it was applied to
+	struct FAppliedSignificance
+	{
+		ELyraSignificanceLevel Level = ELyraSignificanceLevel::Highest;
+		TArray<TWeakObjectPtr<AActor>> AttachedActors;
+	};
+
+	float CalculateSignificance(const FManagedObjectInfo* ObjectInfo, const FTransform& Viewpoint) const;
+	void UpdateSignificanceLevel(AActor* Actor, ELyraSignificanceLevel Level, bool bFinal);
+	void ApplySignificanceLevel(AActor* Actor, ELyraSignificanceLevel Level);
+	void ApplySignificanceLevelToAttachedActor(AActor* Actor, ELyraSignificanceLevel Level);
+	void ApplySignificanceLevelToMeshes(AActor* Actor, ELyraSignificanceLevel Level);
+
+	void CacheAuthoredTickSettings(AActor* Actor);
+	const FAuthoredTickSettings& FindOrCacheAuthoredTickSettings(AActor* Actor);
+	const FAuthoredTickSettings& FindOrCacheAuthoredTickSettings(UActorComponent* Component);
+	void PruneAuthoredTickSettings();
+
+	// Viewpoints and camera data of the local players, gathered on the game thread before each update
+	TArray<FTransform> LocalViewpoints;
+	float TanHalfFOV = 1.0f;
+	int32 LocalTeamId = INDEX_NONE;
+
+	float TimeSinceLastUpdate = 0.0f;
+
+	// Keyed by the actors and components we have throttled
+	TMap<TObjectKey<UObject>, FAuthoredTickSettings> AuthoredTickSettings;
+
+	// Keyed by registered actor
+	TMap<TObjectKey<AActor>, FAppliedSignificance> AppliedSignificance;
 };
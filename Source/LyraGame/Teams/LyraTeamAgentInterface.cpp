@@ -2,7 +2,9 @@
 
 #include "Teams/LyraTeamAgentInterface.h"
 
+#include "Engine/World.h"
 #include "LyraLogChannels.h"
+#include "Teams/LyraTeamSubsystem.h"
 #include "UObject/ScriptInterface.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraTeamAgentInterface)
@@ -22,6 +24,14 @@ void ILyraTeamAgentInterface::ConditionalBroadcastTeamChanged(TScriptInterface<I
 		UObject* ThisObj = This.GetObject();
 		UE_LOG(LogLyraTeams, Verbose, TEXT("[%s] %s assigned team %d"), *GetClientServerContextString(ThisObj), *GetPathNameSafe(ThisObj), NewTeamIndex);
 
+		if (UWorld* World = ThisObj->GetWorld())
+		{
+			if (ULyraTeamSubsystem* TeamSubsystem = World->GetSubsystem<ULyraTeamSubsystem>())
+			{
+				TeamSubsystem->NotifyTeamAgentChanged(ThisObj, NewTeamIndex);
+			}
+		}
+
 		This.GetInterface()->GetTeamChangedDelegateChecked().Broadcast(ThisObj, OldTeamIndex, NewTeamIndex);
 	}
 }
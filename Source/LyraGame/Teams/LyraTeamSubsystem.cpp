@@ -3,6 +3,8 @@
 #include "Teams/LyraTeamSubsystem.h"
 
 #include "AbilitySystemGlobals.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
 #include "GameFramework/Controller.h"
 #include "GameFramework/Pawn.h"
 #include "LyraLogChannels.h"
@@ -17,6 +19,72 @@
 
 class FSubsystemCollectionBase;
 
+#if !UE_BUILD_SHIPPING
+namespace LyraTeamSubsystem
+{
+	// Times FindTeamFromObject with and without the registered team agents for every actor in the world
+	static FAutoConsoleCommandWithWorldAndArgs CmdBenchmarkTeamLookups(
+		TEXT("Lyra.Teams.BenchmarkLookups"),
+		TEXT("Times team lookups for every actor in the world with and without the team agent registry. Optional arg: number of passes (default 1000)"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			const ULyraTeamSubsystem* TeamSubsystem = World ? World->GetSubsystem<ULyraTeamSubsystem>() : nullptr;
+			if (TeamSubsystem == nullptr)
+			{
+				return;
+			}
+
+			const int32 NumPasses = (Args.Num() > 0) ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 1000;
+
+			TArray<const AActor*> Actors;
+			for (TActorIterator<AActor> It(World); It; ++It)
+			{
+				Actors.Add(*It);
+			}
+
+			int32 NumMismatches = 0;
+			for (const AActor* Actor : Actors)
+			{
+				if (TeamSubsystem->FindTeamFromObject(Actor) != TeamSubsystem->FindTeamFromObjectUncached(Actor))
+				{
+					UE_LOG(LogLyraTeams, Warning, TEXT("Registered team %d doesn't match team %d for %s"), TeamSubsystem->FindTeamFromObject(Actor), TeamSubsystem->FindTeamFromObjectUncached(Actor), *GetPathNameSafe(Actor));
+					++NumMismatches;
+				}
+			}
+
+			// Sum the results so the lookups can't be optimized away
+			int64 UncachedSum = 0;
+			const double UncachedStartTime = FPlatformTime::Seconds();
+			for (int32 Pass = 0; Pass < NumPasses; ++Pass)
+			{
+				for (const AActor* Actor : Actors)
+				{
+					UncachedSum += TeamSubsystem->FindTeamFromObjectUncached(Actor);
+				}
+			}
+			const double UncachedTime = FPlatformTime::Seconds() - UncachedStartTime;
+
+			int64 RegisteredSum = 0;
+			const double RegisteredStartTime = FPlatformTime::Seconds();
+			for (int32 Pass = 0; Pass < NumPasses; ++Pass)
+			{
+				for (const AActor* Actor : Actors)
+				{
+					RegisteredSum += TeamSubsystem->FindTeamFromObject(Actor);
+				}
+			}
+			const double RegisteredTime = FPlatformTime::Seconds() - RegisteredStartTime;
+
+			const double NumLookups = FMath::Max((double)NumPasses * Actors.Num(), 1.0);
+			UE_LOG(LogLyraTeams, Display, TEXT("Team lookups for %d actors x %d passes: uncached %.2f ns/lookup, registered %.2f ns/lookup (%d mismatches, checksums %lld / %lld)"),
+				Actors.Num(), NumPasses,
+				UncachedTime * 1e9 / NumLookups,
+				RegisteredTime * 1e9 / NumLookups,
+				NumMismatches, UncachedSum, RegisteredSum);
+		}));
+}
+#endif
+
 //////////////////////////////////////////////////////////////////////
 // FLyraTeamTrackingInfo
 
@@ -79,12 +147,17 @@ void ULyraTeamSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 	};
 
 	CheatManagerRegistrationHandle = UCheatManager::RegisterForOnCheatManagerCreated(FOnCheatManagerCreated::FDelegate::CreateLambda(AddTeamCheats));
+
+	ActorDestroyedHandle = GetWorld()->AddOnActorDestroyedHandler(FOnActorDestroyed::FDelegate::CreateUObject(this, &ThisClass::HandleActorDestroyed));
 }
 
 void ULyraTeamSubsystem::Deinitialize()
 {
 	UCheatManager::UnregisterFromOnCheatManagerCreated(CheatManagerRegistrationHandle);
 
+	GetWorld()->RemoveOnActorDestroyededHandler(ActorDestroyedHandle);
+	RegisteredTeamAgents.Reset();
+
 	Super::Deinitialize();
 }
 
@@ -150,7 +223,29 @@ bool ULyraTeamSubsystem::ChangeTeamForActor(AActor* ActorToChange, int32 NewTeam
 	}
 }
 
+void ULyraTeamSubsystem::NotifyTeamAgentChanged(const UObject* TeamAgent, int32 NewTeamId)
+{
+	// Agents that lost their team stay registered, so they don't have to go through the slow path either
+	RegisteredTeamAgents.Add(TeamAgent, NewTeamId);
+}
+
+void ULyraTeamSubsystem::HandleActorDestroyed(AActor* DestroyedActor)
+{
+	RegisteredTeamAgents.Remove(DestroyedActor);
+}
+
 int32 ULyraTeamSubsystem::FindTeamFromObject(const UObject* TestObject) const
+{
+	// Team agents register their team whenever it changes
+	if (const int32* pTeamId = RegisteredTeamAgents.Find(TestObject))
+	{
+		return *pTeamId;
+	}
+
+	return FindTeamFromObjectUncached(TestObject);
+}
+
+int32 ULyraTeamSubsystem::FindTeamFromObjectUncached(const UObject* TestObject) const
 {
 	// See if it's directly a team agent
 	if (const ILyraTeamAgentInterface* ObjectWithTeamInterface = Cast<ILyraTeamAgentInterface>(TestObject))
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
 
 #include "LyraTeamSubsystem.generated.h"
 
@@ -82,6 +83,12 @@ public:
 	// Returns the team this object belongs to, or INDEX_NONE if it is not part of a team
 	int32 FindTeamFromObject(const UObject* TestObject) const;
 
+	// Same as FindTeamFromObject, but always resolves the team from the object (and its instigator or player state) instead of the registered team agents
+	int32 FindTeamFromObjectUncached(const UObject* TestObject) const;
+
+	// Called whenever a team agent's team changes (see ILyraTeamAgentInterface::ConditionalBroadcastTeamChanged)
+	void NotifyTeamAgentChanged(const UObject* TeamAgent, int32 NewTeamId);
+
 	// Returns the associated player state for this actor, or INDEX_NONE if it is not associated with a player
 	const ALyraPlayerState* FindPlayerStateFromActor(const AActor* PossibleTeamActor) const;
 
@@ -140,8 +147,14 @@ public:
 	FOnLyraTeamDisplayAssetChangedDelegate& GetTeamDisplayAssetChangedDelegate(int32 TeamId);
 
 private:
+	void HandleActorDestroyed(AActor* DestroyedActor);
+
 	UPROPERTY()
 	TMap<int32, FLyraTeamTrackingInfo> TeamMap;
 
+	// Team of every team agent that has been assigned one, so most team lookups are a single map probe
+	TMap<TObjectKey<UObject>, int32> RegisteredTeamAgents;
+
 	FDelegateHandle CheatManagerRegistrationHandle;
+	FDelegateHandle ActorDestroyedHandle;
 };
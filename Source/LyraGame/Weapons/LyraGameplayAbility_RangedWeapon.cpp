@@ -7,9 +7,13 @@
 #include "AIController.h"
 #include "NativeGameplayTags.h"
 #include "Weapons/LyraWeaponStateComponent.h"
+#include "Weapons/LyraHitboxHistorySubsystem.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerState.h"
 #include "AbilitySystemComponent.h"
 #include "AbilitySystem/LyraGameplayAbilityTargetData_SingleTargetHit.h"
 #include "DrawDebugHelpers.h"
+#include "Async/ParallelFor.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(LyraGameplayAbility_RangedWeapon)
 
@@ -35,6 +39,20 @@ namespace LyraConsoleVariables
 		DrawBulletHitRadius,
 		TEXT("When bullet hit debug drawing is enabled (see DrawBulletHitDuration), how big should the hit radius be? (in uu)"),
 		ECVF_Default);
+
+	static bool bBatchCartridgeTraces = true;
+	static FAutoConsoleVariableRef CVarBatchCartridgeTraces(
+		TEXT("lyra.Weapon.BatchCartridgeTraces"),
+		bBatchCartridgeTraces,
+		TEXT("Should all of the bullets in a multi-bullet cartridge be traced as a single batch"),
+		ECVF_Default);
+
+	static int32 ParallelTraceMinBullets = 4;
+	static FAutoConsoleVariableRef CVarParallelTraceMinBullets(
+		TEXT("lyra.Weapon.ParallelTraceMinBullets"),
+		ParallelTraceMinBullets,
+		TEXT("Minimum number of bullets in a batched cartridge before the traces are spread across worker threads"),
+		ECVF_Default);
 }
 
 // Weapon fire will be blocked/canceled if the player has this tag
@@ -151,6 +169,14 @@ FHitResult ULyraGameplayAbility_RangedWeapon::WeaponTrace(const FVector& StartTr
 
 	const ECollisionChannel TraceChannel = DetermineTraceChannel(TraceParams, bIsSimulated);
 
+	return WeaponTraceWithParams(StartTrace, EndTrace, SweepRadius, TraceChannel, TraceParams, /*scratch*/ HitResults, /*out*/ OutHitResults);
+}
+
+FHitResult ULyraGameplayAbility_RangedWeapon::WeaponTraceWithParams(const FVector& StartTrace, const FVector& EndTrace, float SweepRadius, ECollisionChannel TraceChannel, const FCollisionQueryParams& TraceParams, TArray<FHitResult>& ScratchHits, OUT TArray<FHitResult>& OutHitResults) const
+{
+	TArray<FHitResult>& HitResults = ScratchHits;
+	HitResults.Reset();
+
 	if (SweepRadius > 0.0f)
 	{
 		GetWorld()->SweepMultiByChannel(HitResults, StartTrace, EndTrace, FQuat::Identity, TraceChannel, FCollisionShape::MakeSphere(SweepRadius), TraceParams);
@@ -349,6 +375,46 @@ FHitResult ULyraGameplayAbility_RangedWeapon::DoSingleBulletTrace(const FVector&
 	return Impact;
 }
 
+void ULyraGameplayAbility_RangedWeapon::DoSingleBulletTraceWithParams(const FVector& StartTrace, float SweepRadius, ECollisionChannel TraceChannel, const FCollisionQueryParams& TraceParams, FBulletTraceScratch& Scratch) const
+{
+	// Same as DoSingleBulletTrace starting from an empty hit list: always do the line trace first
+	Scratch.Hits.Reset();
+	Scratch.Impact = WeaponTraceWithParams(StartTrace, Scratch.EndTrace, /*SweepRadius=*/ 0.0f, TraceChannel, TraceParams, Scratch.RawHits, /*out*/ Scratch.Hits);
+
+	// If this weapon didn't hit a pawn with the line trace and supports a sweep radius, try that
+	if ((SweepRadius > 0.0f) && (FindFirstPawnHitResult(Scratch.Hits) == INDEX_NONE))
+	{
+		Scratch.SweepHits.Reset();
+		Scratch.Impact = WeaponTraceWithParams(StartTrace, Scratch.EndTrace, SweepRadius, TraceChannel, TraceParams, Scratch.RawHits, /*out*/ Scratch.SweepHits);
+
+		const int32 FirstPawnIdx = FindFirstPawnHitResult(Scratch.SweepHits);
+		if (Scratch.SweepHits.IsValidIndex(FirstPawnIdx))
+		{
+			// Blocking hits from the line trace in front of the pawn mean the pawn hit should be blocked
+			bool bUseSweepHits = true;
+			for (int32 Idx = 0; Idx < FirstPawnIdx; ++Idx)
+			{
+				const FHitResult& CurHitResult = Scratch.SweepHits[Idx];
+
+				auto Pred = [&CurHitResult](const FHitResult& Other)
+				{
+					return Other.HitObjectHandle == CurHitResult.HitObjectHandle;
+				};
+				if (CurHitResult.bBlockingHit && Scratch.Hits.ContainsByPredicate(Pred))
+				{
+					bUseSweepHits = false;
+					break;
+				}
+			}
+
+			if (bUseSweepHits)
+			{
+				Swap(Scratch.Hits, Scratch.SweepHits);
+			}
+		}
+	}
+}
+
 void ULyraGameplayAbility_RangedWeapon::PerformLocalTargeting(OUT TArray<FHitResult>& OutHits)
 {
 	APawn* const AvatarPawn = Cast<APawn>(GetAvatarActorFromActorInfo());
@@ -386,6 +452,12 @@ void ULyraGameplayAbility_RangedWeapon::TraceBulletsInCartridge(const FRangedWea
 
 	const int32 BulletsPerCartridge = WeaponData->GetBulletsPerCartridge();
 
+	if (LyraConsoleVariables::bBatchCartridgeTraces && (BulletsPerCartridge > 1))
+	{
+		TraceBulletsInCartridge_Batched(InputData, /*out*/ OutHits);
+		return;
+	}
+
 	for (int32 BulletIndex = 0; BulletIndex < BulletsPerCartridge; ++BulletIndex)
 	{
 		const float BaseSpreadAngle = WeaponData->GetCalculatedSpreadAngle();
@@ -437,6 +509,86 @@ void ULyraGameplayAbility_RangedWeapon::TraceBulletsInCartridge(const FRangedWea
 	}
 }
 
+void ULyraGameplayAbility_RangedWeapon::TraceBulletsInCartridge_Batched(const FRangedWeaponFiringInput& InputData, OUT TArray<FHitResult>& OutHits)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_LyraRangedWeapon_TraceBulletsInCartridge_Batched);
+
+	ULyraRangedWeaponInstance* WeaponData = InputData.WeaponData;
+	check(WeaponData);
+
+	const int32 BulletsPerCartridge = WeaponData->GetBulletsPerCartridge();
+	if (BulletTraceScratch.Num() < BulletsPerCartridge)
+	{
+		BulletTraceScratch.SetNum(BulletsPerCartridge);
+	}
+
+	const float BaseSpreadAngle = WeaponData->GetCalculatedSpreadAngle();
+	const float SpreadAngleMultiplier = WeaponData->GetCalculatedSpreadAngleMultiplier();
+	const float ActualSpreadAngle = BaseSpreadAngle * SpreadAngleMultiplier;
+	const float HalfSpreadAngleInRadians = FMath::DegreesToRadians(ActualSpreadAngle * 0.5f);
+	const float SweepRadius = WeaponData->GetBulletTraceSweepRadius();
+
+	// Pick the bullet directions up front, in bullet order so the random stream matches the unbatched path
+	for (int32 BulletIndex = 0; BulletIndex < BulletsPerCartridge; ++BulletIndex)
+	{
+		const FVector BulletDir = VRandConeNormalDistribution(InputData.AimDir, HalfSpreadAngleInRadians, WeaponData->GetSpreadExponent());
+		BulletTraceScratch[BulletIndex].EndTrace = InputData.StartTrace + (BulletDir * WeaponData->GetMaxDamageRange());
+	}
+
+	// The query setup is the same for every bullet, so only do it once
+	FCollisionQueryParams TraceParams(SCENE_QUERY_STAT(WeaponTrace), /*bTraceComplex=*/ true, /*IgnoreActor=*/ GetAvatarActorFromActorInfo());
+	TraceParams.bReturnPhysicalMaterial = true;
+	AddAdditionalTraceIgnoreActors(TraceParams);
+
+	const ECollisionChannel TraceChannel = DetermineTraceChannel(TraceParams, /*bIsSimulated=*/ false);
+
+	const EParallelForFlags ParallelForFlags = (BulletsPerCartridge >= LyraConsoleVariables::ParallelTraceMinBullets) ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread;
+	ParallelFor(BulletsPerCartridge, [&](int32 BulletIndex)
+	{
+		DoSingleBulletTraceWithParams(InputData.StartTrace, SweepRadius, TraceChannel, TraceParams, BulletTraceScratch[BulletIndex]);
+	}, ParallelForFlags);
+
+	// Gather the results in bullet order, exactly like TraceBulletsInCartridge does
+	for (int32 BulletIndex = 0; BulletIndex < BulletsPerCartridge; ++BulletIndex)
+	{
+		FBulletTraceScratch& Scratch = BulletTraceScratch[BulletIndex];
+		FHitResult& Impact = Scratch.Impact;
+
+#if ENABLE_DRAW_DEBUG
+		if (LyraConsoleVariables::DrawBulletTracesDuration > 0.0f)
+		{
+			static float DebugThickness = 1.0f;
+			DrawDebugLine(GetWorld(), InputData.StartTrace, Scratch.EndTrace, FColor::Red, false, LyraConsoleVariables::DrawBulletTracesDuration, 0, DebugThickness);
+		}
+#endif // ENABLE_DRAW_DEBUG
+
+		if (Impact.GetActor())
+		{
+#if ENABLE_DRAW_DEBUG
+			if (LyraConsoleVariables::DrawBulletHitDuration > 0.0f)
+			{
+				DrawDebugPoint(GetWorld(), Impact.ImpactPoint, LyraConsoleVariables::DrawBulletHitRadius, FColor::Red, false, LyraConsoleVariables::DrawBulletHitRadius);
+			}
+#endif
+
+			OutHits.Append(Scratch.Hits);
+		}
+
+		// Make sure there's always an entry in OutHits so the direction can be used for tracers, etc...
+		if (OutHits.Num() == 0)
+		{
+			if (!Impact.bBlockingHit)
+			{
+				// Locate the fake 'impact' at the end of the trace
+				Impact.Location = Scratch.EndTrace;
+				Impact.ImpactPoint = Scratch.EndTrace;
+			}
+
+			OutHits.Add(Impact);
+		}
+	}
+}
+
 void ULyraGameplayAbility_RangedWeapon::ActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, const FGameplayEventData* TriggerEventData)
 {
 	// Bind target data callback
@@ -503,6 +655,11 @@ void ULyraGameplayAbility_RangedWeapon::OnTargetDataReadyCallback(const FGamepla
 			{
 				if (Controller->GetLocalRole() == ROLE_Authority)
 				{
+					if (!CurrentActorInfo->IsLocallyControlled())
+					{
+						RejectHitsFailingLagCompensation(LocalTargetDataHandle);
+					}
+
 					// Confirm hit markers
 					if (ULyraWeaponStateComponent* WeaponStateComponent = Controller->FindComponentByClass<ULyraWeaponStateComponent>())
 					{
@@ -549,6 +706,53 @@ void ULyraGameplayAbility_RangedWeapon::OnTargetDataReadyCallback(const FGamepla
 	MyAbilityComponent->ConsumeClientReplicatedTargetData(CurrentSpecHandle, CurrentActivationInfo.GetActivationPredictionKey());
 }
 
+void ULyraGameplayAbility_RangedWeapon::RejectHitsFailingLagCompensation(FGameplayAbilityTargetDataHandle& TargetData) const
+{
+	const ULyraHitboxHistorySubsystem* HitboxHistory = GetWorld()->GetSubsystem<ULyraHitboxHistorySubsystem>();
+	if ((HitboxHistory == nullptr) || !ULyraHitboxHistorySubsystem::IsHitValidationEnabled())
+	{
+		return;
+	}
+
+	// Only the first hit of each cartridge carries the timestamp, and the hits of a cartridge are added together
+	int32 TimestampCartridgeID = INDEX_NONE;
+	double CartridgeTimestamp = 0.0;
+
+	for (int32 i = 0; i < TargetData.Num(); ++i)
+	{
+		FGameplayAbilityTargetData* Data = TargetData.Get(i);
+		if ((Data == nullptr) || (Data->GetScriptStruct() != FLyraGameplayAbilityTargetData_SingleTargetHit::StaticStruct()))
+		{
+			continue;
+		}
+
+		FLyraGameplayAbilityTargetData_SingleTargetHit* SingleTargetHit = static_cast<FLyraGameplayAbilityTargetData_SingleTargetHit*>(Data);
+		if (SingleTargetHit->bHasTimestamp)
+		{
+			TimestampCartridgeID = SingleTargetHit->CartridgeID;
+			CartridgeTimestamp = SingleTargetHit->Timestamp;
+		}
+		else if (SingleTargetHit->CartridgeID == TimestampCartridgeID)
+		{
+			SingleTargetHit->Timestamp = CartridgeTimestamp;
+		}
+
+		// Without a timestamp for its cartridge the hit is validated against the oldest history we allow rewinding to
+		if (!HitboxHistory->ValidateHit(SingleTargetHit->HitResult, SingleTargetHit->Timestamp))
+		{
+			UE_LOG(LogLyraAbilitySystem, Verbose, TEXT("Weapon ability %s rejected a hit on %s that failed lag compensated validation"),
+				*GetPathName(),
+				*GetNameSafe(SingleTargetHit->HitResult.GetActor()));
+
+			// Keep the entry so the shot direction can still be used for tracers, but it no longer hits anything
+			SingleTargetHit->HitResult.HitObjectHandle = FActorInstanceHandle();
+			SingleTargetHit->HitResult.Component = nullptr;
+			SingleTargetHit->HitResult.bBlockingHit = false;
+			SingleTargetHit->bHitReplaced = true;
+		}
+	}
+}
+
 void ULyraGameplayAbility_RangedWeapon::StartRangedWeaponTargeting()
 {
 	check(CurrentActorInfo);
@@ -576,11 +780,24 @@ void ULyraGameplayAbility_RangedWeapon::StartRangedWeaponTargeting()
 	{
 		const int32 CartridgeID = FMath::Rand();
 
+		// Estimate the server time of what we're seeing, other characters are roughly half a round trip behind the server
+		double Timestamp = GetWorld()->GetTimeSeconds();
+		if (const AGameStateBase* GameState = GetWorld()->GetGameState())
+		{
+			Timestamp = GameState->GetServerWorldTimeSeconds();
+			if (const APlayerState* PlayerState = Controller->GetPlayerState<APlayerState>())
+			{
+				Timestamp -= PlayerState->GetPingInMilliseconds() * 0.0005;
+			}
+		}
+
 		for (const FHitResult& FoundHit : FoundHits)
 		{
 			FLyraGameplayAbilityTargetData_SingleTargetHit* NewTargetData = new FLyraGameplayAbilityTargetData_SingleTargetHit();
 			NewTargetData->HitResult = FoundHit;
 			NewTargetData->CartridgeID = CartridgeID;
+			NewTargetData->Timestamp = Timestamp;
+			NewTargetData->bHasTimestamp = (TargetData.Num() == 0);
 
 			TargetData.Add(NewTargetData);
 		}
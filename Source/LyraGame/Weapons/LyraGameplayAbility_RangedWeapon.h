@@ -87,6 +87,23 @@ protected:
 		}
 	};
 
+	// Per-bullet state used when all of the bullets in a cartridge are traced as a batch
+	struct FBulletTraceScratch
+	{
+		// End of the trace after spread was applied
+		FVector EndTrace = FVector::ZeroVector;
+
+		// The impact reported for this bullet
+		FHitResult Impact;
+
+		// Filtered hits for this bullet (line trace hits, or sweep hits if those were used)
+		TArray<FHitResult> Hits;
+
+		// Filtered hits of the sweep trace, and unfiltered results of the last scene query
+		TArray<FHitResult> SweepHits;
+		TArray<FHitResult> RawHits;
+	};
+
 protected:
 	static int32 FindFirstPawnHitResult(const TArray<FHitResult>& HitResults);
 
@@ -99,6 +116,10 @@ protected:
 	// Traces all of the bullets in a single cartridge
 	void TraceBulletsInCartridge(const FRangedWeaponFiringInput& InputData, OUT TArray<FHitResult>& OutHits);
 
+	// Traces all of the bullets in a single cartridge as one batch, sharing the query setup and running the scene queries in parallel.
+	// Produces the same hits as tracing the bullets one at a time.
+	void TraceBulletsInCartridge_Batched(const FRangedWeaponFiringInput& InputData, OUT TArray<FHitResult>& OutHits);
+
 	virtual void AddAdditionalTraceIgnoreActors(FCollisionQueryParams& TraceParams) const;
 
 	// Determine the trace channel to use for the weapon trace(s)
@@ -111,6 +132,9 @@ protected:
 
 	void OnTargetDataReadyCallback(const FGameplayAbilityTargetDataHandle& InData, FGameplayTag ApplicationTag);
 
+	// Rewinds hit characters to the time the client fired and strips the target from hits that could not have happened (server only)
+	void RejectHitsFailingLagCompensation(FGameplayAbilityTargetDataHandle& TargetData) const;
+
 	UFUNCTION(BlueprintCallable)
 	void StartRangedWeaponTargeting();
 
@@ -118,6 +142,16 @@ protected:
 	UFUNCTION(BlueprintImplementableEvent)
 	void OnRangedWeaponTargetDataReady(const FGameplayAbilityTargetDataHandle& TargetData);
 
+private:
+	// WeaponTrace with the query params and channel already determined, safe to call from worker threads
+	FHitResult WeaponTraceWithParams(const FVector& StartTrace, const FVector& EndTrace, float SweepRadius, ECollisionChannel TraceChannel, const FCollisionQueryParams& TraceParams, TArray<FHitResult>& ScratchHits, OUT TArray<FHitResult>& OutHitResults) const;
+
+	// DoSingleBulletTrace for a single bullet of a batch, safe to call from worker threads
+	void DoSingleBulletTraceWithParams(const FVector& StartTrace, float SweepRadius, ECollisionChannel TraceChannel, const FCollisionQueryParams& TraceParams, FBulletTraceScratch& Scratch) const;
+
 private:
 	FDelegateHandle OnTargetDataReadyCallbackDelegateHandle;
+
+	// Reused between cartridges so batched traces don't reallocate their hit arrays
+	TArray<FBulletTraceScratch> BulletTraceScratch;
 };
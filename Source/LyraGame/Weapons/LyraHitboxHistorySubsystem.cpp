@@ -0,0 +1,268 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "LyraHitboxHistorySubsystem.h"
+
+#include "Character/LyraCharacter.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "LyraLogChannels.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(LyraHitboxHistorySubsystem)
+
+namespace LyraHitboxHistory
+{
+	static bool bEnableHitValidation = true;
+	static FAutoConsoleVariableRef CVarEnableHitValidation(
+		TEXT("lyra.Weapon.LagCompensation.Enable"),
+		bEnableHitValidation,
+		TEXT("Should the server validate client reported weapon hits against rewound hitboxes"),
+		ECVF_Default);
+
+	static float MaxRewindTime = 0.5f;
+	static FAutoConsoleVariableRef CVarMaxRewindTime(
+		TEXT("lyra.Weapon.LagCompensation.MaxRewindTime"),
+		MaxRewindTime,
+		TEXT("How far back (in seconds) the server is willing to rewind hitboxes. Only read when the world starts"),
+		ECVF_Default);
+
+	static float RecordInterval = 1.0f / 30.0f;
+	static FAutoConsoleVariableRef CVarRecordInterval(
+		TEXT("lyra.Weapon.LagCompensation.RecordInterval"),
+		RecordInterval,
+		TEXT("Minimum time (in seconds) between two recorded hitbox frames. Only read when the world starts"),
+		ECVF_Default);
+
+	static int32 MaxCharacters = 128;
+	static FAutoConsoleVariableRef CVarMaxCharacters(
+		TEXT("lyra.Weapon.LagCompensation.MaxCharacters"),
+		MaxCharacters,
+		TEXT("Maximum number of characters that have hitbox history recorded. Only read when the world starts"),
+		ECVF_Default);
+
+	static float HitTolerance = 40.0f;
+	static FAutoConsoleVariableRef CVarHitTolerance(
+		TEXT("lyra.Weapon.LagCompensation.HitTolerance"),
+		HitTolerance,
+		TEXT("How far (in uu) outside of the rewound capsule a hit is still accepted, to account for limbs, sweeps and interpolation"),
+		ECVF_Default);
+
+	static ALyraCharacter* FindHitCharacter(const FHitResult& Hit)
+	{
+		// Weapons and cosmetic parts are attached to the character
+		for (AActor* Actor = Hit.GetActor(); Actor != nullptr; Actor = Actor->GetAttachParentActor())
+		{
+			if (ALyraCharacter* Character = Cast<ALyraCharacter>(Actor))
+			{
+				return Character;
+			}
+		}
+		return nullptr;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+// ULyraHitboxHistorySubsystem
+
+void ULyraHitboxHistorySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	MaxSlots = FMath::Max(LyraHitboxHistory::MaxCharacters, 1);
+	MaxFrames = FMath::CeilToInt32(LyraHitboxHistory::MaxRewindTime / FMath::Max(LyraHitboxHistory::RecordInterval, UE_KINDA_SMALL_NUMBER)) + 2;
+
+	// History is allocated lazily when the first character registers, so clients never pay for it
+	FreeSlots.Reserve(MaxSlots);
+	for (int32 Slot = MaxSlots - 1; Slot >= 0; --Slot)
+	{
+		FreeSlots.Add(Slot);
+	}
+}
+
+void ULyraHitboxHistorySubsystem::Deinitialize()
+{
+	CharacterToSlot.Reset();
+	ActiveSlots.Reset();
+
+	Super::Deinitialize();
+}
+
+bool ULyraHitboxHistorySubsystem::IsHitValidationEnabled()
+{
+	return LyraHitboxHistory::bEnableHitValidation;
+}
+
+void ULyraHitboxHistorySubsystem::RegisterCharacter(ALyraCharacter* Character)
+{
+	check(Character);
+
+	if (CharacterToSlot.Contains(Character))
+	{
+		return;
+	}
+
+	if (FreeSlots.Num() == 0)
+	{
+		UE_LOG(LogLyra, Warning, TEXT("Hitbox history is full (%d characters), %s will not be lag compensated"), MaxSlots, *GetNameSafe(Character));
+		return;
+	}
+
+	if (FrameTimes.Num() == 0)
+	{
+		FrameTimes.SetNumZeroed(MaxFrames);
+		SampleLocations.SetNumZeroed(MaxFrames * MaxSlots);
+		SampleRadiusAndHalfHeight.SetNumZeroed(MaxFrames * MaxSlots);
+		SlotCharacters.SetNum(MaxSlots);
+		SlotStartTimes.SetNumZeroed(MaxSlots);
+	}
+
+	const int32 Slot = FreeSlots.Pop(EAllowShrinking::No);
+	SlotCharacters[Slot] = Character;
+
+	// Older frames in this slot belong to the previous occupant
+	SlotStartTimes[Slot] = GetWorld()->GetTimeSeconds();
+
+	ActiveSlots.Add(Slot);
+	CharacterToSlot.Add(Character, Slot);
+}
+
+void ULyraHitboxHistorySubsystem::UnregisterCharacter(ALyraCharacter* Character)
+{
+	int32 Slot = INDEX_NONE;
+	if (CharacterToSlot.RemoveAndCopyValue(Character, Slot))
+	{
+		SlotCharacters[Slot].Reset();
+		ActiveSlots.RemoveSingleSwap(Slot, EAllowShrinking::No);
+		FreeSlots.Add(Slot);
+	}
+}
+
+bool ULyraHitboxHistorySubsystem::IsRecording() const
+{
+	return (ActiveSlots.Num() > 0) && LyraHitboxHistory::bEnableHitValidation;
+}
+
+void ULyraHitboxHistorySubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (IsRecording())
+	{
+		const double CurrentTime = GetWorld()->GetTimeSeconds();
+		if ((CurrentTime - LastRecordTime) >= LyraHitboxHistory::RecordInterval)
+		{
+			RecordFrame(CurrentTime);
+		}
+	}
+}
+
+TStatId ULyraHitboxHistorySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULyraHitboxHistorySubsystem, STATGROUP_Tickables);
+}
+
+void ULyraHitboxHistorySubsystem::RecordFrame(double CurrentTime)
+{
+	LastRecordTime = CurrentTime;
+
+	NewestFrame = (NewestFrame + 1) % MaxFrames;
+	NumValidFrames = FMath::Min(NumValidFrames + 1, MaxFrames);
+	FrameTimes[NewestFrame] = CurrentTime;
+
+	for (int32 Slot : ActiveSlots)
+	{
+		if (const ALyraCharacter* Character = SlotCharacters[Slot].Get())
+		{
+			const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+			const int32 SampleIndex = GetSampleIndex(NewestFrame, Slot);
+
+			SampleLocations[SampleIndex] = Capsule->GetComponentLocation();
+			SampleRadiusAndHalfHeight[SampleIndex] = FVector2f(Capsule->GetScaledCapsuleRadius(), Capsule->GetScaledCapsuleHalfHeight());
+		}
+	}
+}
+
+bool ULyraHitboxHistorySubsystem::RewindSlot(int32 Slot, double Timestamp, FVector& OutLocation, FVector2f& OutRadiusAndHalfHeight) const
+{
+	const double SlotStartTime = SlotStartTimes[Slot];
+	if ((NumValidFrames == 0) || (FrameTimes[NewestFrame] < SlotStartTime))
+	{
+		return false;
+	}
+
+	// Walk back from the newest frame until we find the frame at or before the timestamp, bounded by the size of the history
+	int32 NewerFrame = NewestFrame;
+	for (int32 Age = 1; Age < NumValidFrames; ++Age)
+	{
+		const int32 Frame = (NewestFrame - Age + MaxFrames) % MaxFrames;
+		const double FrameTime = FrameTimes[Frame];
+		if (FrameTime < SlotStartTime)
+		{
+			break;
+		}
+
+		if (FrameTime <= Timestamp)
+		{
+			const double NewerFrameTime = FrameTimes[NewerFrame];
+			const float Alpha = (NewerFrameTime > FrameTime) ? (float)FMath::Clamp((Timestamp - FrameTime) / (NewerFrameTime - FrameTime), 0.0, 1.0) : 1.0f;
+
+			const int32 OlderIndex = GetSampleIndex(Frame, Slot);
+			const int32 NewerIndex = GetSampleIndex(NewerFrame, Slot);
+			OutLocation = FMath::Lerp(SampleLocations[OlderIndex], SampleLocations[NewerIndex], (double)Alpha);
+			OutRadiusAndHalfHeight = FMath::Lerp(SampleRadiusAndHalfHeight[OlderIndex], SampleRadiusAndHalfHeight[NewerIndex], Alpha);
+			return true;
+		}
+
+		NewerFrame = Frame;
+	}
+
+	// The timestamp is newer than the newest frame or older than the usable history, use the closest sample
+	const int32 SampleIndex = GetSampleIndex(NewerFrame, Slot);
+	OutLocation = SampleLocations[SampleIndex];
+	OutRadiusAndHalfHeight = SampleRadiusAndHalfHeight[SampleIndex];
+	return true;
+}
+
+bool ULyraHitboxHistorySubsystem::ValidateHit(const FHitResult& Hit, double Timestamp) const
+{
+	if (!IsRecording())
+	{
+		return true;
+	}
+
+	const ALyraCharacter* HitCharacter = LyraHitboxHistory::FindHitCharacter(Hit);
+	const int32* SlotPtr = (HitCharacter != nullptr) ? CharacterToSlot.Find(HitCharacter) : nullptr;
+	if (SlotPtr == nullptr)
+	{
+		return true;
+	}
+
+	// Never rewind further than we allow, or into the future
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+	const double RewindTime = FMath::Clamp(Timestamp, CurrentTime - LyraHitboxHistory::MaxRewindTime, CurrentTime);
+
+	FVector CapsuleLocation;
+	FVector2f RadiusAndHalfHeight;
+	if (!RewindSlot(*SlotPtr, RewindTime, /*out*/ CapsuleLocation, /*out*/ RadiusAndHalfHeight))
+	{
+		return true;
+	}
+
+	const float AcceptRadius = RadiusAndHalfHeight.X + LyraHitboxHistory::HitTolerance;
+	const FVector AxisOffset(0.0, 0.0, FMath::Max(RadiusAndHalfHeight.Y - RadiusAndHalfHeight.X, 0.0f));
+	const FVector CapsuleTop = CapsuleLocation + AxisOffset;
+	const FVector CapsuleBottom = CapsuleLocation - AxisOffset;
+
+	// The impact has to be on the rewound hitbox...
+	if (FMath::PointDistToSegment(Hit.ImpactPoint, CapsuleTop, CapsuleBottom) > AcceptRadius)
+	{
+		return false;
+	}
+
+	// ...and the shot has to actually pass through it
+	FVector ClosestOnShot;
+	FVector ClosestOnAxis;
+	FMath::SegmentDistToSegmentSafe(Hit.TraceStart, Hit.TraceEnd, CapsuleTop, CapsuleBottom, /*out*/ ClosestOnShot, /*out*/ ClosestOnAxis);
+
+	return FVector::Dist(ClosestOnShot, ClosestOnAxis) <= AcceptRadius;
+}
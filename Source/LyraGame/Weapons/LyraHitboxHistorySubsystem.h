@@ -0,0 +1,90 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+
+#include "LyraHitboxHistorySubsystem.generated.h"
+
+class ALyraCharacter;
+class FSubsystemCollectionBase;
+struct FHitResult;
+
+/**
+ * ULyraHitboxHistorySubsystem
+ *
+ *	Server-side lag compensation for weapon hits.
+ *
+ *	Keeps a short ring buffer of hitbox samples (capsule location and size) for every registered ALyraCharacter and
+ *	validates client reported hits by rewinding the target to the client's timestamp and tracing the shot against the
+ *	rewound hitbox.
+ *
+ *	Samples are stored frame-major in flat arrays (all characters of one frame are contiguous), and both the number of
+ *	characters and the number of frames are fixed when the subsystem is created, so memory is bounded and a rewind
+ *	touches at most two samples after a bounded search through the frame times.
+ */
+UCLASS()
+class ULyraHitboxHistorySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End of USubsystem interface
+
+	//~FTickableObjectBase interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~End of FTickableObjectBase interface
+
+	// Starts recording history for the character (authority only)
+	void RegisterCharacter(ALyraCharacter* Character);
+
+	// Stops recording history for the character and frees its slot
+	void UnregisterCharacter(ALyraCharacter* Character);
+
+	// Returns false if the hit could not have happened against where the hit character was at Timestamp (in server world time).
+	// Hits on anything that isn't tracked are always accepted.
+	bool ValidateHit(const FHitResult& Hit, double Timestamp) const;
+
+	// Returns true if lag compensated hit validation is turned on
+	static bool IsHitValidationEnabled();
+
+private:
+	bool IsRecording() const;
+	void RecordFrame(double CurrentTime);
+
+	// Finds the rewound capsule of a slot at Timestamp, returns false if there is no usable history
+	bool RewindSlot(int32 Slot, double Timestamp, FVector& OutLocation, FVector2f& OutRadiusAndHalfHeight) const;
+
+	int32 GetSampleIndex(int32 Frame, int32 Slot) const { return (Frame * MaxSlots) + Slot; }
+
+private:
+	// Capacity, fixed at initialization
+	int32 MaxSlots = 0;
+	int32 MaxFrames = 0;
+
+	// Ring buffer of frame times, NewestFrame is the most recently written frame
+	TArray<double> FrameTimes;
+	int32 NewestFrame = INDEX_NONE;
+	int32 NumValidFrames = 0;
+
+	// Samples, indexed by GetSampleIndex
+	TArray<FVector> SampleLocations;
+	TArray<FVector2f> SampleRadiusAndHalfHeight;
+
+	// Per slot data
+	TArray<TWeakObjectPtr<ALyraCharacter>> SlotCharacters;
+	TArray<double> SlotStartTimes;
+	TArray<int32> FreeSlots;
+
+	// Slots currently in use, in no particular order
+	TArray<int32> ActiveSlots;
+
+	TMap<FObjectKey, int32> CharacterToSlot;
+
+	double LastRecordTime = -UE_BIG_NUMBER;
+};